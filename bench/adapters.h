@@ -0,0 +1,123 @@
+#pragma once
+
+#include "insert_failed.h"
+#include <cstddef>
+#include <pltables/klibtable.h>
+#include <pltables/qoatable.h>
+#include <unordered_map>
+
+// Thin adapters giving the tables one interface for the workload drivers:
+// find() returns a pointer to the value or nullptr, insert() returns a
+// pointer to the value, value-initialized if the key was new, erase()
+// removes the key if present. The tables of this library also report
+// memory_usage() in bytes. A failed insert aborts (see insertFailed).
+
+// loatable and the containers sharing its interface (dense_loatable,
+// window_loatable, ...).
+template <class Table>
+struct LoaMap
+{
+    using key_type = typename Table::key_type;
+    using mapped_type = typename Table::mapped_type;
+
+    mapped_type* find(key_type key) noexcept
+    {
+        auto it = t.find(key);
+        return it == t.end() ? nullptr : &it.value();
+    }
+    mapped_type* insert(key_type key) noexcept
+    {
+        auto r = t.insert(key);
+        if (Table::insert_failed(r.second))
+            insertFailed("LoaMap");
+        return &r.first.value();
+    }
+    void erase(key_type key) noexcept { t.erase(key); }
+    size_t size() const noexcept { return t.size(); }
+    size_t memory_usage() const noexcept { return t.memory_usage(); }
+
+    Table t;
+};
+
+template <class Key, class T>
+struct KlibMap
+{
+    using table_type = klibtable<Key, T>;
+    using iterator = typename table_type::iterator;
+    using key_type = Key;
+    using mapped_type = T;
+
+    T* find(Key key) noexcept
+    {
+        iterator it{ &t, t.get(key) };
+        return it == t.end() ? nullptr : &it.value();
+    }
+    T* insert(Key key) noexcept
+    {
+        int ret;
+        auto it = t.put(key, &ret);
+        if (ret < 0)
+            insertFailed("KlibMap");
+        if (ret >= 1)
+            it.value() = T{};
+        return &it.value();
+    }
+    void erase(Key key) noexcept { t.del(iterator{ &t, t.get(key) }); }
+    size_t size() const noexcept { return t.size(); }
+    size_t memory_usage() const noexcept { return t.memory_usage(); }
+
+    table_type t;
+};
+
+template <class Key, class T>
+struct StlMap
+{
+    using key_type = Key;
+    using mapped_type = T;
+
+    T* find(Key key) noexcept
+    {
+        auto it = t.find(key);
+        return it == t.end() ? nullptr : &it->second;
+    }
+    T* insert(Key key) { return &t.try_emplace(key).first->second; }
+    void erase(Key key) noexcept { t.erase(key); }
+    size_t size() const noexcept { return t.size(); }
+
+    std::unordered_map<Key, T> t;
+};
+
+// qoatable adapter `Name` over a table declared with QOA_INIT(name, Key, T,
+// ...).
+#define PLT_QOA_MAP(Name, name, Key, T)                                        \
+    struct Name                                                                \
+    {                                                                          \
+        using key_type = Key;                                                  \
+        using mapped_type = T;                                                 \
+        Name() noexcept : t{ qoa_create(name) } {}                             \
+        Name(const Name&) = delete;                                            \
+        ~Name() noexcept { qoa_destroy(name, t); }                             \
+        T* find(Key key) noexcept                                              \
+        {                                                                      \
+            qoaiter i = qoa_get(name, t, key);                                 \
+            return i == qoa_end(name, t) ? nullptr : qoa_val(name, t, i);      \
+        }                                                                      \
+        T* insert(Key key) noexcept                                            \
+        {                                                                      \
+            int ret;                                                           \
+            qoaiter i = qoa_put(name, t, key, &ret);                           \
+            if (ret == QOA_ERROR)                                              \
+                insertFailed(#Name);                                           \
+            T* v = qoa_val(name, t, i);                                        \
+            if (ret >= QOA_NEW)                                                \
+                *v = T{};                                                      \
+            return v;                                                          \
+        }                                                                      \
+        void erase(Key key) noexcept { qoa_erase(name, t, key); }              \
+        size_t size() const noexcept { return qoa_size(name, t); }             \
+        size_t memory_usage() const noexcept                                   \
+        {                                                                      \
+            return sizeof(*this) + qoa_memory_usage(name, t);                  \
+        }                                                                      \
+        qoatable_t(name) * t;                                                  \
+    }
@@ -0,0 +1,96 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <pltables++/dense_table.h>
+#include <pltables++/linear_open_address.h>
+#include <pltables++/window_table.h>
+#include <random>
+#include <vector>
+
+// Sequential order IDs: a live window of state.range(0) orders, the oldest
+// retired as each new one arrives, against lookups of random live orders.
+
+template <class Map>
+static void orderWindow(benchmark::State& state, Map& map)
+{
+    const uint64_t window = state.range(0);
+    uint64_t next = 1;
+    for (; next <= window; ++next) {
+        map.insert(next, next);
+    }
+    std::mt19937_64 gen(29);
+    std::uniform_int_distribution<uint64_t> age(0, window - 1);
+    std::vector<uint64_t> ages(1 << 16);
+    for (auto& a : ages) {
+        a = age(gen);
+    }
+    size_t i = 0;
+    for (auto _ : state) {
+        map.erase(next - window);
+        map.insert(next, next);
+        ++next;
+        for (int j = 0; j < 4; ++j) {
+            benchmark::DoNotOptimize(map.find(next - 1 - ages[i]).value());
+            i = (i + 1) & (ages.size() - 1);
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_OrderWindowLoatable(benchmark::State& state)
+{
+    loatable<uint64_t, uint64_t> map;
+    orderWindow(state, map);
+}
+BENCHMARK(BM_OrderWindowLoatable)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+
+static void BM_OrderWindowDense(benchmark::State& state)
+{
+    dense_loatable<uint64_t, uint64_t> map;
+    orderWindow(state, map);
+}
+BENCHMARK(BM_OrderWindowDense)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+
+// Ring twice the live window, so nothing spills.
+static void BM_OrderWindowRing(benchmark::State& state)
+{
+    window_loatable<uint64_t, uint64_t> map(2 * state.range(0));
+    orderWindow(state, map);
+    state.counters["spilled"] = double(map.spilled());
+}
+BENCHMARK(BM_OrderWindowRing)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+
+// Lookups only, keys 0..n-1 in random order.
+template <class Map>
+static void sequentialFind(benchmark::State& state)
+{
+    const uint64_t n = state.range(0);
+    Map map;
+    for (uint64_t k = 0; k < n; ++k) {
+        map.insert(k, k);
+    }
+    std::mt19937_64 gen(37);
+    std::uniform_int_distribution<uint64_t> dist(0, n - 1);
+    std::vector<uint64_t> keys(1 << 16);
+    for (auto& k : keys) {
+        k = dist(gen);
+    }
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(map.find(keys[i]).value());
+        i = (i + 1) & (keys.size() - 1);
+    }
+}
+
+static void BM_SequentialFindLoatable(benchmark::State& state)
+{
+    sequentialFind<loatable<uint64_t, uint64_t>>(state);
+}
+BENCHMARK(BM_SequentialFindLoatable)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+
+static void BM_SequentialFindDense(benchmark::State& state)
+{
+    sequentialFind<dense_loatable<uint64_t, uint64_t>>(state);
+}
+BENCHMARK(BM_SequentialFindDense)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,77 @@
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <mutex>
+#include <pltables++/epoch.h>
+#include <shared_mutex>
+
+// Cost of protecting a read-side critical section. The epoch guards are
+// compared against the locks a table wrapper would otherwise use.
+
+static plt::EpochDomain asymDomain{ true };
+static plt::EpochDomain symDomain{ false };
+
+static void BM_EpochGuard(benchmark::State& state)
+{
+    plt::EpochDomain::Participant self{ asymDomain };
+    for (auto _ : state) {
+        plt::EpochDomain::Guard guard{ self };
+        benchmark::ClobberMemory();
+    }
+    state.counters["membarrier"] = asymDomain.asymmetric();
+}
+BENCHMARK(BM_EpochGuard)->ThreadRange(1, 8);
+
+static void BM_EpochGuard_Fenced(benchmark::State& state)
+{
+    plt::EpochDomain::Participant self{ symDomain };
+    for (auto _ : state) {
+        plt::EpochDomain::Guard guard{ self };
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_EpochGuard_Fenced)->ThreadRange(1, 8);
+
+static void BM_EpochQuiescent(benchmark::State& state)
+{
+    plt::EpochDomain::Participant self{ asymDomain };
+    self.enter();
+    for (auto _ : state) {
+        self.quiescent();
+        benchmark::ClobberMemory();
+    }
+    self.exit();
+}
+BENCHMARK(BM_EpochQuiescent)->ThreadRange(1, 8);
+
+static std::mutex mutex;
+static void BM_MutexLockUnlock(benchmark::State& state)
+{
+    for (auto _ : state) {
+        std::lock_guard<std::mutex> lock{ mutex };
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_MutexLockUnlock)->ThreadRange(1, 8);
+
+static std::shared_mutex sharedMutex;
+static void BM_SharedMutexLockShared(benchmark::State& state)
+{
+    for (auto _ : state) {
+        std::shared_lock<std::shared_mutex> lock{ sharedMutex };
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_SharedMutexLockShared)->ThreadRange(1, 8);
+
+// Retire + amortized batch reclamation, no concurrent readers.
+static void BM_EpochRetire(benchmark::State& state)
+{
+    plt::EpochDomain::Participant self{ asymDomain };
+    for (auto _ : state) {
+        self.retire(malloc(64), 64);
+    }
+    self.synchronize();
+}
+BENCHMARK(BM_EpochRetire);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,93 @@
+#include <benchmark/benchmark.h>
+#include <climits>
+#include <pltables++/frozen_table.h>
+#include <pltables++/linear_open_address.h>
+#include <random>
+#include <vector>
+
+// Lookups in a mutable loatable against the frozen (minimal perfect hash)
+// copy of the same contents, plus the cost of freezing.
+
+using LoaTable = loatable<int, int>;
+
+static LoaTable& sourceTable(size_t n)
+{
+    static LoaTable table;
+    static size_t filled = 0;
+    if (filled != n) {
+        table.clear();
+        std::mt19937_64 gen(11);
+        std::uniform_int_distribution<> dist(INT_MIN, INT_MAX);
+        while (table.size() < n) {
+            int k = dist(gen);
+            table.insert(k, k);
+        }
+        filled = n;
+    }
+    return table;
+}
+
+static std::vector<int> sampleKeys(const LoaTable& t, size_t n)
+{
+    std::vector<int> all;
+    for (auto it = t.begin(); it != t.end(); ++it) {
+        all.push_back(it.key());
+    }
+    std::mt19937_64 gen(13);
+    std::uniform_int_distribution<size_t> dist(0, all.size() - 1);
+    std::vector<int> ks(n);
+    for (auto& k : ks) {
+        k = all[dist(gen)];
+    }
+    return ks;
+}
+
+#define FROZEN_ARGS Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20)->Arg(1 << 24)
+
+static void BM_LoaFind(benchmark::State& state)
+{
+    const auto& table = sourceTable(state.range(0));
+    auto keys = sampleKeys(table, 1 << 16);
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(table.find(keys[i]));
+        i = (i + 1) & (keys.size() - 1);
+    }
+}
+BENCHMARK(BM_LoaFind)->FROZEN_ARGS;
+
+static void BM_FrozenFind(benchmark::State& state)
+{
+    auto& source = sourceTable(state.range(0));
+    auto keys = sampleKeys(source, 1 << 16);
+    const auto table = freeze(source, 4);
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(table.find(keys[i]));
+        i = (i + 1) & (keys.size() - 1);
+    }
+    state.counters["bits/key"] = table.bits_per_key();
+    state.counters["levels"] = double(table.levels());
+}
+BENCHMARK(BM_FrozenFind)->FROZEN_ARGS;
+
+static void BM_Freeze(benchmark::State& state)
+{
+    auto& source = sourceTable(1 << 22);
+    plt::ThreadPool pool{ size_t(state.range(0)) };
+    for (auto _ : state) {
+        auto table = freeze(source, pool);
+        benchmark::DoNotOptimize(table.size());
+    }
+    state.SetItemsProcessed(state.iterations() * source.size());
+}
+BENCHMARK(BM_Freeze)
+    ->ArgName("threads")
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
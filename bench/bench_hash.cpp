@@ -0,0 +1,194 @@
+#include "dataset.h"
+#include <benchmark/benchmark.h>
+#include <pltables++/hash.h>
+#include <vector>
+
+// Throughput and latency of the functions in pltables/hash, to go with the
+// quality checks in tests/test_hash.cpp.
+//
+//   Hash/int/<algo>/throughput   independent 64-bit keys; hashes per second
+//   Hash/int/<algo>/latency      each key is the previous hash, so one hash
+//                                must finish before the next starts
+//   Hash/bytes/<algo>/<len>      keys of <len> bytes; bytes per second
+//   Hash/batch/<kernel>/<isa>    the batched kernels of pltables/hash/batch.h,
+//                                keys to masked indices, on each instruction
+//                                set this CPU runs
+//
+// CRC-32C runs on the CRC instruction only when built with SSE4.2 (e.g.
+// -msse4.2 or -march=native); otherwise it measures the table fallback.
+
+namespace {
+
+using namespace plt::hash_algo;
+
+struct identity
+{
+    static uint64_t mix(uint64_t k) noexcept { return k; }
+};
+
+struct x31
+{
+    static uint64_t bytes(const void* p, size_t n) noexcept
+    {
+        return plt_hash_x31_bytes(p, n);
+    }
+};
+
+struct bernstein
+{
+    static uint64_t bytes(const void* p, size_t n) noexcept
+    {
+        return plt_hash_bernstein(p, n, 5381);
+    }
+};
+
+constexpr size_t IntKeys = 4096;
+
+const std::vector<uint64_t>& intKeys()
+{
+    static const std::vector<uint64_t> keys = [] {
+        std::vector<uint64_t> ks(IntKeys);
+        dataset::SplitMix64 gen{ 1 };
+        for (auto& k : ks)
+            k = gen();
+        return ks;
+    }();
+    return keys;
+}
+
+template <class Algo>
+void BM_HashIntThroughput(benchmark::State& state)
+{
+    const auto& keys = intKeys();
+    for (auto _ : state) {
+        uint64_t acc = 0;
+        for (uint64_t k : keys)
+            acc ^= Algo::mix(k);
+        benchmark::DoNotOptimize(acc);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations() * keys.size()));
+}
+
+template <class Algo>
+void BM_HashIntLatency(benchmark::State& state)
+{
+    uint64_t k = 1;
+    for (auto _ : state) {
+        for (size_t i = 0; i < IntKeys; ++i) {
+            k = Algo::mix(k);
+            benchmark::DoNotOptimize(k);
+        }
+    }
+    state.SetItemsProcessed(int64_t(state.iterations() * IntKeys));
+}
+
+// Keys of `len` bytes at successive offsets of a random buffer, so the
+// loads are unaligned as often as not.
+template <class Algo>
+void BM_HashBytes(benchmark::State& state)
+{
+    const size_t len = size_t(state.range(0));
+    constexpr size_t Keys = 64;
+    std::vector<unsigned char> buf(len + Keys);
+    dataset::SplitMix64 gen{ 2 };
+    for (auto& b : buf)
+        b = static_cast<unsigned char>(gen());
+    for (auto _ : state) {
+        uint64_t acc = 0;
+        for (size_t i = 0; i < Keys; ++i)
+            acc ^= Algo::bytes(buf.data() + i, len);
+        benchmark::DoNotOptimize(acc);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations() * Keys));
+    state.SetBytesProcessed(int64_t(state.iterations() * Keys * len));
+}
+
+template <class K, void (*Kernel)(const K*, size_t, K, K*)>
+void BM_HashBatch(benchmark::State& state)
+{
+    const auto& keys64 = intKeys();
+    const std::vector<K> keys(keys64.begin(), keys64.end());
+    std::vector<K> idx(keys.size());
+    for (auto _ : state) {
+        Kernel(keys.data(), keys.size(), K((1u << 20) - 1), idx.data());
+        benchmark::DoNotOptimize(idx.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(int64_t(state.iterations() * keys.size()));
+}
+
+template <class K, void (*Kernel)(const K*, size_t, K, K*)>
+void registerBatch(const char* kernel, const char* isa, int level)
+{
+    if (level > plt_hash_isa())
+        return;
+    benchmark::RegisterBenchmark(
+      (std::string("Hash/batch/") + kernel + "/" + isa).c_str(),
+      BM_HashBatch<K, Kernel>);
+}
+
+template <class Algo>
+void registerInt(const char* name)
+{
+    benchmark::RegisterBenchmark(
+      (std::string("Hash/int/") + name + "/throughput").c_str(),
+      BM_HashIntThroughput<Algo>);
+    benchmark::RegisterBenchmark(
+      (std::string("Hash/int/") + name + "/latency").c_str(),
+      BM_HashIntLatency<Algo>);
+}
+
+template <class Algo>
+void registerBytes(const char* name)
+{
+    benchmark::RegisterBenchmark((std::string("Hash/bytes/") + name).c_str(),
+                                 BM_HashBytes<Algo>)
+      ->RangeMultiplier(4)
+      ->Range(4, 4096);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    registerInt<identity>("identity");
+    registerInt<fibonacci>("fibonacci");
+    registerInt<wang>("wang");
+    registerInt<murmur3>("murmur3");
+    registerInt<fnv1a>("fnv1a");
+    registerInt<wy>("wy");
+    registerInt<crc32c>("crc32c");
+
+    registerBatch<uint32_t, plt_hash_fmix32_batch_scalar>(
+      "fmix32", "scalar", PLT_HASH_ISA_SCALAR);
+    registerBatch<uint64_t, plt_hash_fmix64_batch_scalar>(
+      "fmix64", "scalar", PLT_HASH_ISA_SCALAR);
+#if defined(PLT_HASH_X86)
+    registerBatch<uint32_t, plt_hash_fmix32_batch_sse42>(
+      "fmix32", "sse4.2", PLT_HASH_ISA_SSE42);
+    registerBatch<uint64_t, plt_hash_fmix64_batch_sse42>(
+      "fmix64", "sse4.2", PLT_HASH_ISA_SSE42);
+    registerBatch<uint32_t, plt_hash_fmix32_batch_avx2>(
+      "fmix32", "avx2", PLT_HASH_ISA_AVX2);
+    registerBatch<uint64_t, plt_hash_fmix64_batch_avx2>(
+      "fmix64", "avx2", PLT_HASH_ISA_AVX2);
+    registerBatch<uint32_t, plt_hash_fmix32_batch_avx512>(
+      "fmix32", "avx512", PLT_HASH_ISA_AVX512);
+    registerBatch<uint64_t, plt_hash_fmix64_batch_avx512>(
+      "fmix64", "avx512", PLT_HASH_ISA_AVX512);
+#endif
+
+    registerBytes<x31>("x31");
+    registerBytes<bernstein>("bernstein");
+    registerBytes<fnv1a>("fnv1a");
+    registerBytes<murmur3>("murmur3");
+    registerBytes<wy>("wy");
+    registerBytes<crc32c>("crc32c");
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
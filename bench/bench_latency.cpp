@@ -0,0 +1,183 @@
+#include "adapters.h"
+#include "histogram.h"
+#include "ycsb.h"
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <pltables++/linear_open_address.h>
+#include <string>
+#include <vector>
+
+// Tail latency of single operations. Every insert, find and erase is
+// timestamped on its own into a log-linear histogram, so the rare insert
+// that triggers a resize shows up at p99.99 and max instead of vanishing
+// into the mean. Inserts start from an empty table and grow it to `size`
+// entries; finds look up every key once; erases remove every key.
+//
+// Benchmarks are named Latency/<op>/size:<n>/<engine> and report p50, p99,
+// p99.9, p99.99 and max in nanoseconds, plus the mean and the timer's own
+// overhead (timer_ns, included in every sample), as user counters; use
+// --benchmark_format=json or --benchmark_out=FILE for machine-readable
+// output. With --latency_hist_dir=DIR every histogram is also written to
+// DIR/<op>.size<n>.<engine>.csv as lowest_ns,highest_ns,count rows.
+
+static inline int lat_u64_hash(uint64_t k)
+{
+    return int(k ^ (k >> 32));
+}
+static inline int lat_u64_eq(uint64_t a, uint64_t b)
+{
+    return a == b;
+}
+QOA_INIT(lat_u64, uint64_t, uint64_t, lat_u64_hash, lat_u64_eq);
+PLT_QOA_MAP(QoaLatency, lat_u64, uint64_t, uint64_t);
+
+using Histogram = latency::LogLinearHistogram<>;
+
+enum class Op
+{
+    Insert,
+    Find,
+    Erase,
+};
+
+static const char* opName(Op op)
+{
+    switch (op) {
+        case Op::Insert:
+            return "insert";
+        case Op::Find:
+            return "find";
+        case Op::Erase:
+            return "erase";
+    }
+    return "";
+}
+
+static std::string histDir;
+
+static const std::vector<uint64_t>& keys(size_t n)
+{
+    static std::vector<uint64_t> ks;
+    if (ks.size() != n) {
+        ks.resize(n);
+        for (size_t i = 0; i < n; ++i)
+            ks[i] = ycsb::record_key(i);
+    }
+    return ks;
+}
+
+static void writeHistogram(const std::string& name, const Histogram& h,
+                           double scale)
+{
+    if (histDir.empty())
+        return;
+    const std::string path = histDir + "/" + name + ".csv";
+    FILE* f = fopen(path.c_str(), "w");
+    if (!f) {
+        fprintf(stderr, "cannot write %s\n", path.c_str());
+        return;
+    }
+    fprintf(f, "lowest_ns,highest_ns,count\n");
+    h.for_each_bucket([&](uint64_t lo, uint64_t hi, uint64_t count) {
+        fprintf(f, "%.1f,%.1f,%llu\n", double(lo) * scale,
+                double(hi) * scale, (unsigned long long)count);
+    });
+    fclose(f);
+}
+
+template <class Map>
+static void BM_Latency(benchmark::State& state, Op op, size_t size,
+                       const char* engine)
+{
+    const auto& ks = keys(size);
+    const double scale = latency::ns_per_tick();
+    Histogram h;
+    for (auto _ : state) {
+        auto map = std::make_unique<Map>();
+        if (op != Op::Insert) {
+            for (uint64_t k : ks)
+                *map->insert(k) = k;
+        }
+        const uint64_t start = latency::ticks();
+        switch (op) {
+            case Op::Insert:
+                for (uint64_t k : ks) {
+                    const uint64_t t0 = latency::ticks();
+                    *map->insert(k) = k;
+                    h.record(latency::ticks() - t0);
+                }
+                break;
+            case Op::Find:
+                for (uint64_t k : ks) {
+                    const uint64_t t0 = latency::ticks();
+                    benchmark::DoNotOptimize(map->find(k));
+                    h.record(latency::ticks() - t0);
+                }
+                break;
+            case Op::Erase:
+                for (uint64_t k : ks) {
+                    const uint64_t t0 = latency::ticks();
+                    map->erase(k);
+                    h.record(latency::ticks() - t0);
+                }
+                break;
+        }
+        state.SetIterationTime(double(latency::ticks() - start) * scale *
+                               1e-9);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations() * ks.size()));
+    state.counters["p50_ns"] = double(h.percentile(0.50)) * scale;
+    state.counters["p99_ns"] = double(h.percentile(0.99)) * scale;
+    state.counters["p99.9_ns"] = double(h.percentile(0.999)) * scale;
+    state.counters["p99.99_ns"] = double(h.percentile(0.9999)) * scale;
+    state.counters["max_ns"] = double(h.max()) * scale;
+    state.counters["mean_ns"] = h.mean() * scale;
+    state.counters["timer_ns"] = double(latency::timer_overhead()) * scale;
+    writeHistogram(std::string(opName(op)) + ".size" +
+                     std::to_string(size) + "." + engine,
+                   h, scale);
+}
+
+int main(int argc, char** argv)
+{
+    int out = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (strncmp(argv[i], "--latency_hist_dir=", 19) == 0)
+            histDir = argv[i] + 19;
+        else
+            argv[out++] = argv[i];
+    }
+    argc = out;
+
+    using Fn = void (*)(benchmark::State&, Op, size_t, const char*);
+    const std::pair<const char*, Fn> engines[] = {
+        { "loatable", BM_Latency<LoaMap<loatable<uint64_t, uint64_t>>> },
+        { "klibtable", BM_Latency<KlibMap<uint64_t, uint64_t>> },
+        { "qoatable", BM_Latency<QoaLatency> },
+        { "unordered_map", BM_Latency<StlMap<uint64_t, uint64_t>> },
+    };
+    const Op ops[] = { Op::Insert, Op::Find, Op::Erase };
+    const size_t sizes[] = { size_t(1) << 16, size_t(1) << 20,
+                             size_t(1) << 22 };
+    for (Op op : ops) {
+        for (size_t size : sizes) {
+            for (const auto& e : engines) {
+                const std::string name = std::string("Latency/") +
+                                         opName(op) + "/size:" +
+                                         std::to_string(size) + "/" + e.first;
+                benchmark::RegisterBenchmark(name.c_str(), e.second, op,
+                                             size_t(size), e.first)
+                  ->UseManualTime()
+                  ->Iterations(1)
+                  ->Unit(benchmark::kMillisecond);
+            }
+        }
+    }
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+    benchmark::RunSpecifiedBenchmarks();
+}
@@ -1,82 +1,66 @@
+#include "cache_info.h"
+#include "dataset.h"
+#include "memory_stats.h"
+#include "perf_counters.h"
 #include <benchmark/benchmark.h>
+#include <pltables++/hash.h>
 #include <pltables++/linear_open_address.h>
+#include <algorithm>
 #include <klib/khash.h>
+#include <type_traits>
 #include <unordered_map>
-#include <random>
-#include <climits>
-#include <iostream>
+#include <utility>
+#include <vector>
 
 // TODO: add find test with tombstones in the tables
 // TODO: try with different hashing functions
 // TODO: add find test where key is missing
 
-std::random_device rd;
-std::mt19937_64 gen;
-bool init = false;
+// Inputs come from the dataset cache (see dataset.h) under fixed seeds, so
+// runs are reproducible and setup is a file mapping.
+constexpr uint64_t DataSeed = 1;
+constexpr uint64_t QuerySeed = 2;
+// The find benchmarks walk a query stream of this many batches of
+// state.range(1) keys, so consecutive iterations look up different keys
+// without resampling inside the timed loop.
+constexpr size_t QueryBatches = 256;
 
-void doinit()
-{
-    if (!init) {
-        gen.seed(rd());
-        init = true;
-    }
-}
-
-using IntPairVec = std::vector<std::pair<int, int>>;
-
-IntPairVec genData(size_t n)
-{
-    doinit();
-    std::uniform_int_distribution<> dist(INT_MIN, INT_MAX);
-    std::vector<std::pair<int, int>> vs;
-    vs.reserve(n);
-    for (size_t i = 0; i < n; ++i) {
-        vs.emplace_back(dist(gen), dist(gen));
-    }
-    return vs;
-}
-
-std::vector<int> sampleKeys(const IntPairVec& vs, size_t n)
-{
-    doinit();
-    std::uniform_int_distribution<> dist(0, vs.size() - 1);
-    std::vector<int> ks;
-    for (size_t i = 0; i < n; ++i) {
-        ks.push_back(vs[dist(gen)].first);
-    }
-    return ks;
-}
+using IntPairs = dataset::Stream<dataset::KeyValue<int, int>>;
 
 using LoaTable = loatable<int,int>;
+// Hashes batches with SIMD in find_batch().
+using FmixTable = loatable<int, int, plt::fmix_hash>;
 KHASH_MAP_INIT_INT(i32, int)
 using KlibTable = khash_t(i32);
 using StlTable = std::unordered_map<int, int>;
 
-static void insertData(LoaTable& t, const IntPairVec& vs)
+template <class Hash>
+static void insertData(loatable<int, int, Hash>& t, const IntPairs& vs)
 {
     for (auto&& v : vs) {
-        t.insert(v.first, v.second);
+        t.insert(v.key, v.val);
     }
 }
 
-static void insertData(KlibTable* t, const IntPairVec& vs)
+static void insertData(KlibTable* t, const IntPairs& vs)
 {
     int ret;
     khiter_t it;
     for (auto&& v : vs) {
-        it = kh_put(i32, t, v.first, &ret);
-        kh_value(t, it) = v.second;
+        it = kh_put(i32, t, v.key, &ret);
+        kh_value(t, it) = v.val;
     }
 }
 
-static void insertData(StlTable& t, const IntPairVec& vs)
+static void insertData(StlTable& t, const IntPairs& vs)
 {
     for (auto&& v : vs) {
-        t.emplace(v.first, v.second);
+        t.emplace(v.key, v.val);
     }
 }
 
-static bool tableFind(const LoaTable& t, int key)
+template <class Hash>
+static bool tableFind(const loatable<int, int, Hash>& t, int key)
 {
     return t.find(key) != t.end();
 }
@@ -92,7 +76,7 @@ static bool tableFind(const StlTable& t, int key)
 }
 
 template <class Table>
-void tableInit(Table& table) {}
+void tableInit(Table&) {}
 
 template <>
 void tableInit(KlibTable*& table)
@@ -100,35 +84,218 @@ void tableInit(KlibTable*& table)
     table = kh_init(i32);
 }
 
-#define TABLE_FIND_ARGS \
-    ->Args({ 1 << 10, 1 << 10 }) \
-    ->Args({ 1 << 11, 1 << 10 }) \
-    ->Args({ 1 << 12, 1 << 10 }) \
-    ->Args({ 1 << 13, 1 << 10 }) \
-    ->Args({ 1 << 14, 1 << 10 }) \
-    ->Args({ 1 << 15, 1 << 10 }) \
-    ->Args({ 1 << 20, 1 << 10 }) \
-    ->Args({ 1 << 21, 1 << 10 }) \
+template <class Table>
+void tableFree(Table&) {}
+
+template <>
+void tableFree(KlibTable*& table)
+{
+    kh_destroy(i32, table);
+}
+
+// Builds `table` from `vs` and returns the heap bytes it took, or 0 where
+// the C library cannot say.
+template <class Table>
+static size_t buildTable(Table& table, const IntPairs& vs)
+{
+    const size_t heap0 = memstat::heap_in_use();
+    tableInit(table);
+    insertData(table, vs);
+    const size_t heap1 = memstat::heap_in_use();
+    return heap1 > heap0 ? heap1 - heap0 : 0;
+}
+
+// Heap bytes of a table built from `n` pairs.
+template <class Table>
+static size_t measureFootprint(size_t n)
+{
+    const auto data = dataset::int_pairs(n, DataSeed);
+    size_t bytes = 0;
+    // The first build settles glibc's mmap threshold, which otherwise
+    // depends on what the process freed before (e.g. a freshly
+    // generated dataset) and shifts the sweep between runs.
+    for (int i = 0; i < 2; ++i) {
+        Table table;
+        bytes = buildTable(table, data);
+        tableFree(table);
+    }
+    return bytes;
+}
+
+// loatable and khash double a power-of-two capacity; unordered_map grows
+// with its node count.
+template <class Table>
+struct GrowsByDoubling : std::true_type
+{
+};
+
+template <>
+struct GrowsByDoubling<StlTable> : std::false_type
+{
+};
+
+// The sizes a sweep can pick from, up to cache::dram_bytes(). A doubling
+// table is filled to 0.7 of each capacity, below its growth threshold, and
+// costed by the bytes per slot of one build; the others step by 1/8 at the
+// bytes per entry of one build.
+template <class Table>
+static const std::vector<cache::Step>& sizeSteps()
+{
+    static const std::vector<cache::Step> steps = [] {
+        constexpr double Fill = 0.7;
+        constexpr size_t Probe = 1 << 16;
+        constexpr double MinBytes = sizeof(dataset::KeyValue<int, int>);
+        const size_t limit = cache::dram_bytes();
+        std::vector<cache::Step> ss;
+        if constexpr (GrowsByDoubling<Table>::value) {
+            const double slot = std::max(
+              double(measureFootprint<Table>(size_t(Fill * Probe))) / Probe,
+              MinBytes * Fill);
+            for (size_t cap = 64; slot * double(cap) <= double(limit);
+                 cap *= 2)
+                ss.push_back({ size_t(Fill * double(cap)),
+                               size_t(slot * double(cap)) });
+        } else {
+            const double bpe = std::max(
+              double(measureFootprint<Table>(Probe)) / Probe, MinBytes);
+            for (double n = 64; bpe * n <= double(limit); n *= 1.125)
+                ss.push_back({ size_t(n), size_t(bpe * n) });
+        }
+        return ss;
+    }();
+    return steps;
+}
+
+// Table sizes just inside and just outside each cache level of this
+// machine, and one in DRAM, at the engine's own growth steps.
+template <class Table>
+static void CacheSweep(benchmark::internal::Benchmark* b)
+{
+    for (size_t n : cache::sweep_sizes(sizeSteps<Table>())) {
+        b->Args({ int64_t(n), 1 << 10 });
+    }
+}
 
+// Labels a find benchmark with the level the table's measured footprint
+// fits in.
+static void reportFootprint(benchmark::State& state, size_t bytes, size_t n)
+{
+    if (bytes == 0)
+        return;
+    state.counters["bytes/entry"] = double(bytes) / double(n);
+    state.SetLabel(cache::describe(bytes));
+}
 
+// Lookups of present keys in tables sized across the cache hierarchy. The
+// label names the level the table fits in, so the cliffs show per layout:
+// loatable's flag, key and value arrays, khash's 2-bit flags beside its key
+// and value arrays, and unordered_map's nodes.
 template <class Table>
 static void BM_LoaTableFind(benchmark::State& state)
 {
     Table table;
-    tableInit(table);
-    auto data = genData(state.range(0));
-    insertData(table, data);
+    const size_t n = state.range(0);
+    const size_t batch = state.range(1);
+    const size_t bytes = buildTable(table, dataset::int_pairs(n, DataSeed));
+    const auto queries =
+      dataset::int_pair_queries(n, DataSeed, batch * QueryBatches, QuerySeed);
+    size_t offset = 0;
+    perf::Counters counters;
+    counters.start();
     for (auto _ : state) {
-        state.PauseTiming();
-        auto keys = sampleKeys(data, state.range(1));
-        state.ResumeTiming();
-        for (auto key : keys) {
-            benchmark::DoNotOptimize(tableFind(table, key));
+        const int* keys = queries.data() + offset;
+        for (size_t i = 0; i < batch; ++i) {
+            benchmark::DoNotOptimize(tableFind(table, keys[i]));
         }
+        offset = offset + batch == queries.size() ? 0 : offset + batch;
+    }
+    counters.stop();
+    counters.report(state, double(state.iterations() * state.range(1)));
+    reportFootprint(state, bytes, n);
+    tableFree(table);
+}
+BENCHMARK_TEMPLATE(BM_LoaTableFind, LoaTable)->Apply(CacheSweep<LoaTable>);
+BENCHMARK_TEMPLATE(BM_LoaTableFind, KlibTable*)
+  ->Apply(CacheSweep<KlibTable*>);
+BENCHMARK_TEMPLATE(BM_LoaTableFind, StlTable)->Apply(CacheSweep<StlTable>);
+BENCHMARK_TEMPLATE(BM_LoaTableFind, FmixTable)->Apply(CacheSweep<FmixTable>);
+
+// The same lookups through find_batch(), which hashes a block of keys at
+// once (with SIMD for FmixTable) and prefetches their slots before probing.
+// Against BM_LoaTableFind this is the gain from overlapping the misses;
+// PLT_HASH_ISA=scalar separates out the vector hashing.
+template <class Table>
+static void BM_LoaTableFindBatch(benchmark::State& state)
+{
+    Table table;
+    const size_t n = state.range(0);
+    const size_t batch = state.range(1);
+    const size_t bytes = buildTable(table, dataset::int_pairs(n, DataSeed));
+    const auto queries =
+      dataset::int_pair_queries(n, DataSeed, batch * QueryBatches, QuerySeed);
+    std::vector<typename Table::const_iterator> found(batch);
+    size_t offset = 0;
+    perf::Counters counters;
+    counters.start();
+    for (auto _ : state) {
+        const int* keys = queries.data() + offset;
+        std::as_const(table).find_batch(keys, keys + batch, found.data());
+        benchmark::DoNotOptimize(found.data());
+        benchmark::ClobberMemory();
+        offset = offset + batch == queries.size() ? 0 : offset + batch;
+    }
+    counters.stop();
+    counters.report(state, double(state.iterations() * state.range(1)));
+    reportFootprint(state, bytes, n);
+}
+BENCHMARK_TEMPLATE(BM_LoaTableFindBatch, LoaTable)
+  ->Apply(CacheSweep<LoaTable>);
+BENCHMARK_TEMPLATE(BM_LoaTableFindBatch, FmixTable)
+  ->Apply(CacheSweep<FmixTable>);
+
+#define TABLE_BUILD_ARGS \
+    ->Args({ 1 << 20, 1 }) \
+    ->Args({ 1 << 20, 2 }) \
+    ->Args({ 1 << 20, 4 }) \
+    ->Args({ 1 << 20, 8 }) \
+    ->Args({ 1 << 24, 1 }) \
+    ->Args({ 1 << 24, 2 }) \
+    ->Args({ 1 << 24, 4 }) \
+    ->Args({ 1 << 24, 8 }) \
+
+
+static void BM_LoaTableInsertAll(benchmark::State& state)
+{
+    const auto data = dataset::int_pairs(state.range(0), DataSeed);
+    perf::Counters counters;
+    counters.start();
+    for (auto _ : state) {
+        LoaTable table;
+        insertData(table, data);
+        benchmark::DoNotOptimize(table.size());
+    }
+    counters.stop();
+    counters.report(state, double(state.iterations() * data.size()));
+    state.SetItemsProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_LoaTableInsertAll)
+    ->Arg(1 << 20)->Arg(1 << 24)->Unit(benchmark::kMillisecond);
+
+static void BM_LoaTableBuildParallel(benchmark::State& state)
+{
+    std::vector<LoaTable::pair_type> data;
+    for (auto&& v : dataset::int_pairs(state.range(0), DataSeed)) {
+        data.emplace_back(v.key, v.val);
+    }
+    plt::ThreadPool pool(state.range(1));
+    for (auto _ : state) {
+        LoaTable table;
+        table.build_parallel(data.data(), data.data() + data.size(), pool);
+        benchmark::DoNotOptimize(table.size());
     }
+    state.SetItemsProcessed(state.iterations() * data.size());
 }
-BENCHMARK_TEMPLATE(BM_LoaTableFind, LoaTable) TABLE_FIND_ARGS;
-BENCHMARK_TEMPLATE(BM_LoaTableFind, KlibTable*) TABLE_FIND_ARGS;
-BENCHMARK_TEMPLATE(BM_LoaTableFind, StlTable) TABLE_FIND_ARGS;
+BENCHMARK(BM_LoaTableBuildParallel) TABLE_BUILD_ARGS
+    ->UseRealTime()->Unit(benchmark::kMillisecond);
 
 BENCHMARK_MAIN();
@@ -0,0 +1,178 @@
+#include "insert_failed.h"
+#include "matrix.h"
+#include <pltables++/linear_open_address.h>
+#include <pltables/klibtable.h>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Workload matrix (see matrix.h) over every engine. Benchmarks are named
+//
+//   Matrix/<op>/<key>/<pattern>/tomb:<pct>/size:<n>/<engine>/manual_time
+//
+// and registered in that order, so engines running the same workload sit
+// next to each other and two runs line up line for line in a diff. Select a
+// slice with --benchmark_filter, e.g. 'Matrix/find_hit/int/random/tomb:0/'.
+
+using matrix::BigKey;
+using matrix::EngineEntry;
+using matrix::Op;
+using matrix::Pattern;
+using matrix::Workload;
+
+template <class Key>
+struct LoaEngine
+{
+    void insert(const Key& k) noexcept
+    {
+        if (loatable<Key, int>::insert_failed(t.insert(k, 0).second))
+            insertFailed("loatable");
+    }
+    bool find(const Key& k) const noexcept { return t.find(k) != t.end(); }
+    void erase(const Key& k) noexcept { t.erase(k); }
+    size_t size() const noexcept { return t.size(); }
+
+    loatable<Key, int> t;
+};
+
+// klibtable hashes to int32_t; its defaults only handle integers.
+struct KlibMatrixHash
+{
+    int32_t operator()(int k) const noexcept { return k; }
+    int32_t operator()(const char* k) const noexcept
+    {
+        return int32_t(matrix::str_hash(k));
+    }
+    int32_t operator()(const BigKey& k) const noexcept
+    {
+        return int32_t(matrix::big_hash(k));
+    }
+};
+
+struct KlibMatrixEq
+{
+    template <class K>
+    bool operator()(const K& a, const K& b) const noexcept
+    {
+        return a == b;
+    }
+    bool operator()(const char* a, const char* b) const noexcept
+    {
+        return strcmp(a, b) == 0;
+    }
+};
+
+template <class Key>
+struct KlibEngine
+{
+    using ckey = std::decay_t<decltype(matrix::c_key(std::declval<Key>()))>;
+    using table_type = klibtable<ckey, int, KlibMatrixHash, KlibMatrixEq>;
+    using iterator = typename table_type::iterator;
+
+    void insert(const Key& k) noexcept
+    {
+        int ret;
+        auto it = t.put(matrix::c_key(k), &ret);
+        if (ret < 0)
+            insertFailed("klibtable");
+        it.value() = 0;
+    }
+    bool find(const Key& k) noexcept
+    {
+        return iterator{ &t, t.get(matrix::c_key(k)) } != t.end();
+    }
+    void erase(const Key& k) noexcept
+    {
+        t.del(iterator{ &t, t.get(matrix::c_key(k)) });
+    }
+    size_t size() const noexcept { return size_t(t.size()); }
+
+    table_type t;
+};
+
+template <class Key>
+struct StlEngine
+{
+    void insert(const Key& k) { t.emplace(k, 0); }
+    bool find(const Key& k) const noexcept { return t.find(k) != t.end(); }
+    void erase(const Key& k) noexcept { t.erase(k); }
+    size_t size() const noexcept { return t.size(); }
+
+    std::unordered_map<Key, int> t;
+};
+
+template <class Key>
+static std::vector<EngineEntry> engines(const char* key)
+{
+    std::vector<EngineEntry> es{
+        { "loatable", matrix::run<LoaEngine<Key>, Key> },
+        { "klibtable", matrix::run<KlibEngine<Key>, Key> },
+        { "unordered_map", matrix::run<StlEngine<Key>, Key> },
+    };
+    for (const auto& e : matrix::c_engines(key))
+        es.push_back(e);
+    return es;
+}
+
+static const char* opName(Op op)
+{
+    switch (op) {
+        case Op::Insert:
+            return "insert";
+        case Op::Erase:
+            return "erase";
+        case Op::FindHit:
+            return "find_hit";
+        case Op::FindMiss:
+            return "find_miss";
+    }
+    return "";
+}
+
+static void registerMatrix()
+{
+    const Op ops[] = { Op::Insert, Op::Erase, Op::FindHit, Op::FindMiss };
+    const Pattern patterns[] = { Pattern::Random, Pattern::Sequential };
+    const int tombs[] = { 0, 25, 50 };
+    const size_t sizes[] = { size_t(1) << 10, size_t(1) << 14,
+                             size_t(1) << 18, size_t(1) << 21 };
+    const std::pair<const char*, std::vector<EngineEntry>> keys[] = {
+        { "int", engines<int>("int") },
+        { "string", engines<std::string>("string") },
+        { "big32", engines<BigKey>("big32") },
+    };
+    for (Op op : ops) {
+        for (const auto& key : keys) {
+            for (Pattern p : patterns) {
+                for (int tomb : tombs) {
+                    for (size_t size : sizes) {
+                        for (const auto& e : key.second) {
+                            const std::string name =
+                              std::string("Matrix/") + opName(op) + "/" +
+                              key.first + "/" +
+                              (p == Pattern::Random ? "random"
+                                                    : "sequential") +
+                              "/tomb:" + std::to_string(tomb) +
+                              "/size:" + std::to_string(size) + "/" + e.name;
+                            benchmark::RegisterBenchmark(
+                              name.c_str(), e.run, Workload{ op, p, tomb, size })
+                              ->UseManualTime()
+                              ->Unit(benchmark::kMicrosecond);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    registerMatrix();
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+    benchmark::RunSpecifiedBenchmarks();
+}
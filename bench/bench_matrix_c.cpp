@@ -0,0 +1,153 @@
+#include "insert_failed.h"
+#include "matrix.h"
+#include <assert.h>
+#include <klib/khash.h>
+#include <pltables/qoatable.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+// The C loatable #defines key_t and val_t, and its functions are not
+// static, so it is included once, here, in a namespace of its own.
+namespace cloa {
+#include <pltables/loatable.h>
+}
+#undef key_t
+#undef val_t
+
+// Workload matrix engines for the tables with C interfaces: qoatable, khash
+// and the C loatable (int keys only).
+
+using matrix::BigKey;
+using matrix::c_key;
+using matrix::EngineEntry;
+
+static inline int mx_str_hash(const char* s)
+{
+    return int(matrix::str_hash(s));
+}
+static inline int mx_str_eq(const char* a, const char* b)
+{
+    return strcmp(a, b) == 0;
+}
+static inline int mx_big_hash(BigKey k)
+{
+    return int(matrix::big_hash(k));
+}
+static inline int mx_big_eq(BigKey a, BigKey b)
+{
+    return a == b;
+}
+
+QOA_INIT(mx_i32, int, int, qoa_i32_hash_identity, qoa_i32_eq);
+QOA_INIT(mx_str, const char*, int, mx_str_hash, mx_str_eq);
+QOA_INIT(mx_big, BigKey, int, mx_big_hash, mx_big_eq);
+
+KHASH_MAP_INIT_INT(mx_i32, int)
+KHASH_MAP_INIT_STR(mx_str, int)
+KHASH_INIT(mx_big, BigKey, int, 1, mx_big_hash, mx_big_eq)
+
+template <class Key>
+struct QoaEngine;
+template <class Key>
+struct KhashEngine;
+
+#define MX_QOA_ENGINE(Key, name)                                               \
+    template <>                                                                \
+    struct QoaEngine<Key>                                                      \
+    {                                                                          \
+        QoaEngine() noexcept : t{ qoa_create(name) } {}                        \
+        QoaEngine(const QoaEngine&) = delete;                                  \
+        ~QoaEngine() noexcept { qoa_destroy(name, t); }                        \
+        void insert(const Key& k) noexcept                                     \
+        {                                                                      \
+            int ret;                                                           \
+            const qoaiter it = qoa_put(name, t, c_key(k), &ret);               \
+            if (ret == QOA_ERROR)                                              \
+                insertFailed("qoatable");                                      \
+            *qoa_val(name, t, it) = 0;                                         \
+        }                                                                      \
+        bool find(const Key& k) noexcept                                       \
+        {                                                                      \
+            return qoa_get(name, t, c_key(k)) != qoa_end(name, t);             \
+        }                                                                      \
+        void erase(const Key& k) noexcept { qoa_erase(name, t, c_key(k)); }    \
+        size_t size() const noexcept { return size_t(qoa_size(name, t)); }     \
+        qoatable_t(name) * t;                                                  \
+    }
+
+#define MX_KHASH_ENGINE(Key, name)                                             \
+    template <>                                                                \
+    struct KhashEngine<Key>                                                    \
+    {                                                                          \
+        KhashEngine() noexcept : t{ kh_init(name) } {}                         \
+        KhashEngine(const KhashEngine&) = delete;                              \
+        ~KhashEngine() noexcept { kh_destroy(name, t); }                       \
+        void insert(const Key& k) noexcept                                     \
+        {                                                                      \
+            int ret;                                                           \
+            const khiter_t it = kh_put(name, t, c_key(k), &ret);               \
+            if (ret < 0)                                                       \
+                insertFailed("khash");                                         \
+            kh_value(t, it) = 0;                                               \
+        }                                                                      \
+        bool find(const Key& k) noexcept                                       \
+        {                                                                      \
+            return kh_get(name, t, c_key(k)) != kh_end(t);                     \
+        }                                                                      \
+        void erase(const Key& k) noexcept                                      \
+        {                                                                      \
+            const khiter_t it = kh_get(name, t, c_key(k));                     \
+            if (it != kh_end(t))                                               \
+                kh_del(name, t, it);                                           \
+        }                                                                      \
+        size_t size() const noexcept { return kh_size(t); }                    \
+        khash_t(name) * t;                                                     \
+    }
+
+MX_QOA_ENGINE(int, mx_i32);
+MX_QOA_ENGINE(std::string, mx_str);
+MX_QOA_ENGINE(BigKey, mx_big);
+MX_KHASH_ENGINE(int, mx_i32);
+MX_KHASH_ENGINE(std::string, mx_str);
+MX_KHASH_ENGINE(BigKey, mx_big);
+
+struct CLoaEngine
+{
+    CLoaEngine() noexcept : t{ cloa::loacreate() } {}
+    CLoaEngine(const CLoaEngine&) = delete;
+    ~CLoaEngine() noexcept { cloa::loadestroy(t); }
+    void insert(int k) noexcept
+    {
+        const cloa::loaresult r = cloa::loainsert(t, k);
+        if (r.result == cloa::LOA_ERROR)
+            insertFailed("loatable_c");
+        *cloa::loaval(t, r.iter) = 0;
+    }
+    bool find(int k) const noexcept
+    {
+        return cloa::loaget(t, k) != cloa::loaend(t);
+    }
+    void erase(int k) noexcept { cloa::loaerase(t, k); }
+    size_t size() const noexcept { return size_t(cloa::loasize(t)); }
+
+    cloa::loatable* t;
+};
+
+std::vector<EngineEntry> matrix::c_engines(const std::string& key)
+{
+    using matrix::run;
+    if (key == "int")
+        return { { "qoatable", run<QoaEngine<int>, int> },
+                 { "khash", run<KhashEngine<int>, int> },
+                 { "loatable_c", run<CLoaEngine, int> } };
+    if (key == "string")
+        return { { "qoatable", run<QoaEngine<std::string>, std::string> },
+                 { "khash", run<KhashEngine<std::string>, std::string> } };
+    if (key == "big32")
+        return { { "qoatable", run<QoaEngine<BigKey>, BigKey> },
+                 { "khash", run<KhashEngine<BigKey>, BigKey> } };
+    return {};
+}
@@ -0,0 +1,112 @@
+#include "adapters.h"
+#include "memory_stats.h"
+#include "ycsb.h"
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <memory>
+#include <pltables++/linear_open_address.h>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Memory footprint of the tables as they grow. Each run inserts `size`
+// scrambled 64-bit keys into an empty table and reports, as user counters:
+//
+//   bytes/entry     memory_usage() / size(), for the tables that report it
+//   heap/entry      malloc bytes in use after the build, less those before,
+//                   per entry; comparable across every engine
+//   peak_rss/entry  growth of the resident-set high-water mark during the
+//                   build, per entry. Covers the moment in each resize when
+//                   the old and the new arrays are both live (_resize_fast,
+//                   qoa_resize_fast, khash's realloc)
+//   peak/final      that peak over the RSS the finished table holds: what
+//                   growing costs on top of the table itself
+//
+// The peak figures need a kernel that lets /proc/self/clear_refs reset the
+// high-water mark and are left out otherwise.
+
+static inline int mem_u64_hash(uint64_t k)
+{
+    return int(k ^ (k >> 32));
+}
+static inline int mem_u64_eq(uint64_t a, uint64_t b)
+{
+    return a == b;
+}
+QOA_INIT(mem_u64, uint64_t, uint64_t, mem_u64_hash, mem_u64_eq);
+PLT_QOA_MAP(QoaMemory, mem_u64, uint64_t, uint64_t);
+
+template <class Map, class = void>
+struct reports_memory : std::false_type
+{};
+
+template <class Map>
+struct reports_memory<Map,
+                      std::void_t<decltype(std::declval<const Map&>()
+                                             .memory_usage())>>
+  : std::true_type
+{};
+
+static const std::vector<uint64_t>& keys(size_t n)
+{
+    static std::vector<uint64_t> ks;
+    if (ks.size() != n) {
+        ks.resize(n);
+        for (size_t i = 0; i < n; ++i)
+            ks[i] = ycsb::record_key(i);
+    }
+    return ks;
+}
+
+template <class Map>
+static void BM_Growth(benchmark::State& state)
+{
+    using Clock = std::chrono::steady_clock;
+    const auto& ks = keys(size_t(state.range(0)));
+    const double n = double(ks.size());
+    for (auto _ : state) {
+        const bool peak = memstat::reset_peak_rss();
+        const size_t rss0 = memstat::rss_bytes();
+        const size_t heap0 = memstat::heap_in_use();
+        auto map = std::make_unique<Map>();
+        const auto t0 = Clock::now();
+        for (uint64_t k : ks)
+            *map->insert(k) = k;
+        state.SetIterationTime(
+          std::chrono::duration<double>(Clock::now() - t0).count());
+        const size_t heap1 = memstat::heap_in_use();
+        const size_t rss1 = memstat::rss_bytes();
+        const size_t peak1 = memstat::peak_rss_bytes();
+
+        if constexpr (reports_memory<Map>::value)
+            state.counters["bytes/entry"] = double(map->memory_usage()) / n;
+        if (heap1 > heap0)
+            state.counters["heap/entry"] = double(heap1 - heap0) / n;
+        if (peak && peak1 > rss0) {
+            state.counters["peak_rss/entry"] = double(peak1 - rss0) / n;
+            if (rss1 > rss0)
+                state.counters["peak/final"] =
+                  double(peak1 - rss0) / double(rss1 - rss0);
+        }
+    }
+    state.SetItemsProcessed(int64_t(state.iterations() * ks.size()));
+}
+
+#define GROWTH_ARGS                                                            \
+    ->Arg(100000)                                                              \
+    ->Arg(1000000)                                                             \
+    ->Arg(4000000)                                                             \
+    ->Iterations(1)                                                            \
+    ->UseManualTime()                                                          \
+    ->Unit(benchmark::kMillisecond)
+
+using LoaMemory = LoaMap<loatable<uint64_t, uint64_t>>;
+using KlibMemory = KlibMap<uint64_t, uint64_t>;
+using StlMemory = StlMap<uint64_t, uint64_t>;
+
+BENCHMARK_TEMPLATE(BM_Growth, LoaMemory) GROWTH_ARGS;
+BENCHMARK_TEMPLATE(BM_Growth, KlibMemory) GROWTH_ARGS;
+BENCHMARK_TEMPLATE(BM_Growth, QoaMemory) GROWTH_ARGS;
+BENCHMARK_TEMPLATE(BM_Growth, StlMemory) GROWTH_ARGS;
+
+BENCHMARK_MAIN();
@@ -0,0 +1,142 @@
+#include "adapters.h"
+#include "orderbook.h"
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <memory>
+#include <pltables++/dense_table.h>
+#include <pltables++/linear_open_address.h>
+#include <pltables++/price_ladder.h>
+#include <pltables++/window_table.h>
+#include <vector>
+
+// Replay of a synthetic ITCH-like stream through an order book whose order
+// map and price levels are held in each of the tables. Reports messages per
+// second over the whole replay and, from a second replay that times every
+// message, latency percentiles (which include the clock overhead, reported
+// as timer_ns).
+
+using orderbook::Book;
+using orderbook::HashLevels;
+using orderbook::LadderLevels;
+using orderbook::Level;
+using orderbook::MapLevels;
+using orderbook::Msg;
+using orderbook::Order;
+
+static inline int ob_u64_hash(uint64_t k)
+{
+    return int(k ^ (k >> 32));
+}
+static inline int ob_u64_eq(uint64_t a, uint64_t b)
+{
+    return a == b;
+}
+QOA_INIT(ob_orders, uint64_t, Order, ob_u64_hash, ob_u64_eq);
+QOA_INIT(ob_levels, int32_t, Level, qoa_i32_hash_identity, qoa_i32_eq);
+
+PLT_QOA_MAP(QoaOrders, ob_orders, uint64_t, Order);
+PLT_QOA_MAP(QoaLevels, ob_levels, int32_t, Level);
+
+using LoaBook = Book<LoaMap<loatable<uint64_t, Order>>,
+                     HashLevels<LoaMap<loatable<int32_t, Level>>>>;
+using KlibBook =
+  Book<KlibMap<uint64_t, Order>, HashLevels<KlibMap<int32_t, Level>>>;
+using QoaBook = Book<QoaOrders, HashLevels<QoaLevels>>;
+using StlBook =
+  Book<StlMap<uint64_t, Order>, HashLevels<StlMap<int32_t, Level>>>;
+using DenseBook = Book<LoaMap<dense_loatable<uint64_t, Order>>,
+                       HashLevels<LoaMap<dense_loatable<int32_t, Level>>>>;
+// Order references in a ring, long-lived orders spilled to a loatable.
+using WindowBook = Book<LoaMap<window_loatable<uint64_t, Order>>,
+                        HashLevels<LoaMap<dense_loatable<int32_t, Level>>>>;
+// std::map levels, the usual textbook book.
+using MapBook = Book<LoaMap<loatable<uint64_t, Order>>, MapLevels>;
+// Levels in a tick-indexed price ladder.
+using LadderBook = Book<LoaMap<loatable<uint64_t, Order>>,
+                        LadderLevels<price_ladder<Level, int32_t>>>;
+using WindowLadderBook = Book<LoaMap<window_loatable<uint64_t, Order>>,
+                              LadderLevels<price_ladder<Level, int32_t>>>;
+
+static const orderbook::StreamParams streamParams{};
+
+static const std::vector<Msg>& stream()
+{
+    static const auto msgs = orderbook::generate_stream(streamParams);
+    return msgs;
+}
+
+using Clock = std::chrono::steady_clock;
+
+static double nanos(Clock::duration d)
+{
+    return std::chrono::duration<double, std::nano>(d).count();
+}
+
+static void latencyCounters(benchmark::State& state, std::vector<float>& ns)
+{
+    auto at = [&](double q) {
+        auto nth = ns.begin() + size_t(q * (ns.size() - 1));
+        std::nth_element(ns.begin(), nth, ns.end());
+        return double(*nth);
+    };
+    state.counters["p50_ns"] = at(0.50);
+    state.counters["p90_ns"] = at(0.90);
+    state.counters["p99_ns"] = at(0.99);
+    state.counters["p99.9_ns"] = at(0.999);
+    state.counters["max_ns"] = double(*std::max_element(ns.begin(), ns.end()));
+
+    double overhead = 1e9;
+    for (int i = 0; i < 1000; ++i) {
+        const auto t0 = Clock::now();
+        overhead = std::min(overhead, nanos(Clock::now() - t0));
+    }
+    state.counters["timer_ns"] = overhead;
+}
+
+template <class Engine>
+static void BM_Replay(benchmark::State& state)
+{
+    const auto& msgs = stream();
+    uint64_t checksum = 0;
+    size_t orders = 0;
+    for (auto _ : state) {
+        auto book = std::make_unique<Engine>(streamParams.books,
+                                             streamParams.tick);
+        const auto t0 = Clock::now();
+        for (const auto& m : msgs) {
+            book->apply(m);
+        }
+        const auto t1 = Clock::now();
+        state.SetIterationTime(nanos(t1 - t0) * 1e-9);
+        checksum = book->checksum();
+        orders = book->orders();
+    }
+    state.SetItemsProcessed(state.iterations() * msgs.size());
+    state.counters["orders"] = double(orders);
+    // Engines replaying the same stream must agree.
+    state.counters["checksum"] = double(checksum % 1000003);
+
+    std::vector<float> ns(msgs.size());
+    auto book = std::make_unique<Engine>(streamParams.books, streamParams.tick);
+    for (size_t i = 0; i < msgs.size(); ++i) {
+        const auto t0 = Clock::now();
+        book->apply(msgs[i]);
+        ns[i] = float(nanos(Clock::now() - t0));
+    }
+    latencyCounters(state, ns);
+}
+
+#define REPLAY_ARGS UseManualTime()->Unit(benchmark::kMillisecond)
+
+BENCHMARK_TEMPLATE(BM_Replay, LoaBook)->REPLAY_ARGS;
+BENCHMARK_TEMPLATE(BM_Replay, KlibBook)->REPLAY_ARGS;
+BENCHMARK_TEMPLATE(BM_Replay, QoaBook)->REPLAY_ARGS;
+BENCHMARK_TEMPLATE(BM_Replay, StlBook)->REPLAY_ARGS;
+BENCHMARK_TEMPLATE(BM_Replay, DenseBook)->REPLAY_ARGS;
+BENCHMARK_TEMPLATE(BM_Replay, WindowBook)->REPLAY_ARGS;
+BENCHMARK_TEMPLATE(BM_Replay, MapBook)->REPLAY_ARGS;
+BENCHMARK_TEMPLATE(BM_Replay, LadderBook)->REPLAY_ARGS;
+BENCHMARK_TEMPLATE(BM_Replay, WindowLadderBook)->REPLAY_ARGS;
+
+BENCHMARK_MAIN();
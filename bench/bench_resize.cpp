@@ -0,0 +1,84 @@
+#include <benchmark/benchmark.h>
+#include <climits>
+#include <pltables++/linear_open_address.h>
+#include <pltables/qoatable.h>
+#include <random>
+#include <vector>
+
+// Time of a single doubling resize of a table filled to just below its
+// load-factor cutoff. BM_LoaResize is charted against the pool size
+// (threads == 1 is the sequential rehash).
+
+QOA_INIT_INT(i32, int, qoa_i32_hash_identity);
+
+static std::vector<int> genKeys(size_t n)
+{
+    std::mt19937_64 gen(42);
+    std::uniform_int_distribution<> dist(INT_MIN, INT_MAX);
+    std::vector<int> ks;
+    ks.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        ks.push_back(dist(gen));
+    }
+    return ks;
+}
+
+using LoaTable = loatable<int, int>;
+
+static void BM_LoaResize(benchmark::State& state)
+{
+    const size_t asize = state.range(0);
+    const size_t nthreads = state.range(1);
+    auto keys = genKeys(asize * 3 / 4);
+    plt::ThreadPool pool{ nthreads };
+    for (auto _ : state) {
+        state.PauseTiming();
+        LoaTable table;
+        table.reserve(asize);
+        for (int k : keys) {
+            table.insert(k, k);
+        }
+        table.set_parallel_resize(&pool, 0);
+        state.ResumeTiming();
+        table.resize(2 * asize);
+        benchmark::DoNotOptimize(table.capacity());
+        state.PauseTiming();
+        table.clear();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+// clang-format off
+BENCHMARK(BM_LoaResize)
+    ->ArgNames({ "asize", "threads" })
+    ->ArgsProduct({ { 1 << 20, 1 << 24 }, { 1, 2, 4, 8, 16 } })
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+// clang-format on
+
+static void BM_QoaResize(benchmark::State& state)
+{
+    const int asize = state.range(0);
+    auto keys = genKeys(asize * 3 / 4);
+    for (auto _ : state) {
+        state.PauseTiming();
+        qoatable_t(i32)* table = qoa_create(i32);
+        qoa_resize_fast(i32, table, asize);
+        for (int k : keys) {
+            qoa_insert(i32, table, k);
+        }
+        state.ResumeTiming();
+        qoa_resize_fast(i32, table, 2 * asize);
+        benchmark::DoNotOptimize(table->asize);
+        state.PauseTiming();
+        qoa_destroy(i32, table);
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(BM_QoaResize)
+    ->Arg(1 << 20)
+    ->Arg(1 << 24)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
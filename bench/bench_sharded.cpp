@@ -0,0 +1,150 @@
+#include <benchmark/benchmark.h>
+#include <climits>
+#include <cstdlib>
+#include <pltables++/sharded_table.h>
+#include <random>
+#include <sched.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// Topology simulation: PLT_SIM_NODES=N splits the online CPUs into N equal
+// "nodes". A shard is populated by an owner thread pinned to a CPU of node 0
+// ("local") or node 1 ("remote") and then queried from a thread pinned to
+// node 0. On a real multi-socket box the owner's placement follows the real
+// node of its CPU; on a single-node box this exercises the same code paths.
+
+static int simNodes()
+{
+    const char* env = getenv("PLT_SIM_NODES");
+    int n = env ? atoi(env) : plt::numa_node_count();
+    return n < 1 ? 1 : n;
+}
+
+static int cpuOfNode(int node)
+{
+    const int ncpus = static_cast<int>(sysconf(_SC_NPROCESSORS_ONLN));
+    const int nodes = simNodes();
+    const int per = ncpus / nodes > 0 ? ncpus / nodes : 1;
+    return (node % nodes) * per % ncpus;
+}
+
+using ShardedTable = sharded_loatable<int, int>;
+
+static std::vector<int> genKeys(size_t n, uint64_t seed)
+{
+    std::mt19937_64 gen(seed);
+    std::uniform_int_distribution<> dist(INT_MIN, INT_MAX);
+    std::vector<int> ks;
+    ks.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        ks.push_back(dist(gen));
+    }
+    return ks;
+}
+
+static void populate(ShardedTable& table, size_t shard, int cpu,
+                     const std::vector<int>& keys)
+{
+    std::thread owner([&]() {
+        plt::numa_pin_to_cpu(cpu);
+        table.attach(shard);
+        for (int k : keys) {
+            table.shard(shard).insert(k, k);
+        }
+    });
+    owner.join();
+}
+
+static void BM_ShardFind(benchmark::State& state)
+{
+    const size_t n = state.range(0);
+    const bool remote = state.range(1) != 0;
+    const int readerCpu = cpuOfNode(0);
+    const int ownerCpu = cpuOfNode(remote ? 1 : 0);
+
+    ShardedTable table(1);
+    auto keys = genKeys(n, 42);
+    populate(table, 0, ownerCpu, keys);
+
+    std::mt19937_64 gen(7);
+    std::uniform_int_distribution<size_t> pick(0, keys.size() - 1);
+    std::vector<int> queries;
+    for (int i = 0; i < (1 << 10); ++i) {
+        queries.push_back(keys[pick(gen)]);
+    }
+
+    // The reader is the benchmark's own thread: put its affinity back so the
+    // benchmarks registered after this one do not run pinned.
+    cpu_set_t saved;
+    const bool restore = sched_getaffinity(0, sizeof(saved), &saved) == 0;
+    plt::numa_pin_to_cpu(readerCpu);
+    const auto& shard = table.shard(0);
+    for (auto _ : state) {
+        for (int key : queries) {
+            benchmark::DoNotOptimize(shard.find(key) != shard.end());
+        }
+    }
+    if (restore) {
+        sched_setaffinity(0, sizeof(saved), &saved);
+    }
+    state.counters["owner_cpu"] = ownerCpu;
+    state.counters["reader_cpu"] = readerCpu;
+    state.SetItemsProcessed(state.iterations() * queries.size());
+}
+// clang-format off
+BENCHMARK(BM_ShardFind)
+    ->ArgNames({ "entries", "remote" })
+    ->Args({ 1 << 16, 0 })
+    ->Args({ 1 << 16, 1 })
+    ->Args({ 1 << 21, 0 })
+    ->Args({ 1 << 21, 1 })
+    ->Args({ 1 << 24, 0 })
+    ->Args({ 1 << 24, 1 });
+// clang-format on
+
+// Every worker owns one shard (placed on its own node) and only queries keys
+// routed to it, the intended deployment shape.
+static void BM_ShardedOwnedFind(benchmark::State& state)
+{
+    const size_t nthreads = state.range(0);
+    const size_t n = state.range(1);
+    ShardedTable table(nthreads);
+    auto keys = genKeys(n, 42);
+    std::vector<std::vector<int>> perShard(table.shard_count());
+    for (int k : keys) {
+        perShard[table.shard_for(k)].push_back(k);
+    }
+    for (size_t s = 0; s < table.shard_count(); ++s) {
+        populate(table, s, cpuOfNode(static_cast<int>(s)), perShard[s]);
+    }
+
+    for (auto _ : state) {
+        std::vector<std::thread> workers;
+        for (size_t s = 0; s < table.shard_count(); ++s) {
+            workers.emplace_back([&, s]() {
+                plt::numa_pin_to_cpu(cpuOfNode(static_cast<int>(s)));
+                const auto& shard = table.shard(s);
+                for (int k : perShard[s]) {
+                    benchmark::DoNotOptimize(shard.find(k) != shard.end());
+                }
+            });
+        }
+        for (auto& w : workers) {
+            w.join();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+// clang-format off
+BENCHMARK(BM_ShardedOwnedFind)
+    ->ArgNames({ "threads", "entries" })
+    ->Args({ 1, 1 << 22 })
+    ->Args({ 2, 1 << 22 })
+    ->Args({ 4, 1 << 22 })
+    ->Args({ 8, 1 << 22 })
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+// clang-format on
+
+BENCHMARK_MAIN();
@@ -0,0 +1,185 @@
+#include <benchmark/benchmark.h>
+#include <pltables++/constexpr_map.h>
+#include <pltables++/linear_open_address.h>
+#include <pltables++/small_table.h>
+#include <random>
+#include <vector>
+
+// Small and fixed-size tables: compile-time maps against a loatable holding
+// the same entries.
+
+static constexpr constexpr_map msgSizes{ std::array{
+  std::pair{ 'A', 36 },
+  std::pair{ 'F', 40 },
+  std::pair{ 'E', 31 },
+  std::pair{ 'C', 36 },
+  std::pair{ 'X', 23 },
+  std::pair{ 'D', 19 },
+  std::pair{ 'U', 35 },
+  std::pair{ 'P', 44 },
+  std::pair{ 'Q', 40 },
+  std::pair{ 'B', 19 },
+  std::pair{ 'I', 50 },
+  std::pair{ 'N', 20 },
+} };
+
+static std::vector<char> msgStream(size_t n)
+{
+    std::mt19937_64 gen(5);
+    std::uniform_int_distribution<size_t> dist(0, msgSizes.size() - 1);
+    std::vector<char> ks(n);
+    for (auto& k : ks) {
+        k = msgSizes.at_index(dist(gen)).first;
+    }
+    return ks;
+}
+
+static void BM_MsgSizeLoatable(benchmark::State& state)
+{
+    loatable<char, int> table;
+    for (const auto& kv : msgSizes) {
+        table.insert(kv.first, kv.second);
+    }
+    auto keys = msgStream(1 << 12);
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(table.find(keys[i]).value());
+        i = (i + 1) & (keys.size() - 1);
+    }
+}
+BENCHMARK(BM_MsgSizeLoatable);
+
+static void BM_MsgSizeConstexpr(benchmark::State& state)
+{
+    auto keys = msgStream(1 << 12);
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(msgSizes.find(keys[i])->second);
+        i = (i + 1) & (keys.size() - 1);
+    }
+    state.counters["max_probe"] = msgSizes.max_probe();
+}
+BENCHMARK(BM_MsgSizeConstexpr);
+
+// Fixed-capacity inline tables against the growing table at the same slot
+// count: fill to the load factor, look every key up, clear.
+template <class Table>
+static void fillFindClear(benchmark::State& state, Table& table,
+                          const std::vector<int>& keys)
+{
+    for (auto _ : state) {
+        for (int k : keys) {
+            table.insert(k, k);
+        }
+        for (int k : keys) {
+            benchmark::DoNotOptimize(table.find(k));
+        }
+        table.clear();
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+static std::vector<int> slotKeys(size_t slots)
+{
+    std::mt19937_64 gen(17);
+    std::uniform_int_distribution<int> dist;
+    // As many keys as fit below the 0.77 maximum load factor.
+    std::vector<int> ks(slots * 77 / 100);
+    for (auto& k : ks) {
+        k = dist(gen);
+    }
+    return ks;
+}
+
+template <size_t Slots>
+static void BM_FillLoatable(benchmark::State& state)
+{
+    loatable<int, int> table;
+    fillFindClear(state, table, slotKeys(Slots));
+}
+
+template <size_t Slots>
+static void BM_FillStaticLoatable(benchmark::State& state)
+{
+    static_loatable<int, int, Slots> table;
+    fillFindClear(state, table, slotKeys(Slots));
+}
+
+BENCHMARK_TEMPLATE(BM_FillLoatable, 64);
+BENCHMARK_TEMPLATE(BM_FillStaticLoatable, 64);
+BENCHMARK_TEMPLATE(BM_FillLoatable, 512);
+BENCHMARK_TEMPLATE(BM_FillStaticLoatable, 512);
+BENCHMARK_TEMPLATE(BM_FillLoatable, 4096);
+BENCHMARK_TEMPLATE(BM_FillStaticLoatable, 4096);
+
+// Many tiny maps (per-instrument state): lookups of present keys in a random
+// map out of TinyMaps, each holding state.range(0) entries.
+constexpr size_t TinyMaps = 1 << 14;
+
+template <class Map>
+static size_t heapBytes(const Map& map)
+{
+    // Flags, keys and values of a loatable with this many slots.
+    return map.capacity() / 4 + map.capacity() * 2 * sizeof(int);
+}
+
+template <class Map>
+static void tinyMapFind(benchmark::State& state, std::vector<Map>& maps)
+{
+    const size_t n = state.range(0);
+    std::mt19937_64 gen(23);
+    std::uniform_int_distribution<int> dist;
+    for (auto& map : maps) {
+        while (map.size() < n) {
+            int k = dist(gen);
+            map.insert(k, k);
+        }
+    }
+    std::uniform_int_distribution<size_t> pick(0, maps.size() - 1);
+    std::vector<std::pair<uint32_t, int>> probes(1 << 16);
+    for (auto& p : probes) {
+        p.first = uint32_t(pick(gen));
+        auto it = maps[p.first].begin();
+        for (size_t skip = pick(gen) % n; skip != 0; --skip)
+            ++it;
+        p.second = it.key();
+    }
+    size_t i = 0;
+    for (auto _ : state) {
+        const auto& p = probes[i];
+        benchmark::DoNotOptimize(maps[p.first].find(p.second).value());
+        i = (i + 1) & (probes.size() - 1);
+    }
+}
+
+static void BM_TinyMapsLoatable(benchmark::State& state)
+{
+    std::vector<loatable<int, int>> maps(TinyMaps);
+    tinyMapFind(state, maps);
+    size_t bytes = 0;
+    for (const auto& map : maps) {
+        bytes += sizeof(map) + heapBytes(map);
+    }
+    state.counters["bytes/map"] = double(bytes) / maps.size();
+}
+BENCHMARK(BM_TinyMapsLoatable)
+    ->ArgName("entries")
+    ->RangeMultiplier(2)
+    ->Range(1, 64);
+
+static void BM_TinyMapsSmall(benchmark::State& state)
+{
+    std::vector<small_loatable<int, int>> maps(TinyMaps);
+    tinyMapFind(state, maps);
+    size_t bytes = 0;
+    for (const auto& map : maps) {
+        bytes += sizeof(map) + (map.is_inline() ? 0 : heapBytes(map));
+    }
+    state.counters["bytes/map"] = double(bytes) / maps.size();
+}
+BENCHMARK(BM_TinyMapsSmall)
+    ->ArgName("entries")
+    ->RangeMultiplier(2)
+    ->Range(1, 64);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,108 @@
+#include <benchmark/benchmark.h>
+#include <climits>
+#include <pltables++/linear_open_address.h>
+#include <random>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+// Restart cost: rebuilding a table by inserting every entry against mapping
+// a snapshot of it, plus the lookup rate once the snapshot is (lazily)
+// paged in.
+
+using LoaTable = loatable<int, int>;
+
+static std::vector<std::pair<int, int>> genData(size_t n)
+{
+    std::mt19937_64 gen(7);
+    std::uniform_int_distribution<> dist(INT_MIN, INT_MAX);
+    std::vector<std::pair<int, int>> vs;
+    vs.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        vs.emplace_back(dist(gen), dist(gen));
+    }
+    return vs;
+}
+
+static std::string snapshotPath(size_t n)
+{
+    const char* dir = getenv("TMPDIR");
+    return std::string(dir ? dir : "/tmp") + "/plt_bench_" +
+           std::to_string(n) + "_" + std::to_string(getpid()) + ".snap";
+}
+
+static void BM_LoaRebuild(benchmark::State& state)
+{
+    auto data = genData(state.range(0));
+    for (auto _ : state) {
+        LoaTable table;
+        for (auto&& v : data) {
+            table.insert(v.first, v.second);
+        }
+        benchmark::DoNotOptimize(table.size());
+    }
+    state.SetItemsProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_LoaRebuild)
+    ->Arg(1 << 16)
+    ->Arg(1 << 20)
+    ->Arg(1 << 24)
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_LoaLoadMmap(benchmark::State& state)
+{
+    auto data = genData(state.range(0));
+    const auto path = snapshotPath(data.size());
+    {
+        LoaTable table;
+        for (auto&& v : data) {
+            table.insert(v.first, v.second);
+        }
+        if (!table.save(path.c_str())) {
+            state.SkipWithError("cannot write snapshot");
+            return;
+        }
+    }
+    for (auto _ : state) {
+        LoaTable table;
+        if (!table.load_mmap(path.c_str())) {
+            state.SkipWithError("cannot map snapshot");
+            break;
+        }
+        benchmark::DoNotOptimize(table.find(data[0].first));
+    }
+    unlink(path.c_str());
+    state.SetItemsProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_LoaLoadMmap)
+    ->Arg(1 << 16)
+    ->Arg(1 << 20)
+    ->Arg(1 << 24)
+    ->Unit(benchmark::kMillisecond);
+
+// Lookups against a heap table (Arg 0) or a read-only mapping (Arg 1).
+static void BM_LoaFindMapped(benchmark::State& state)
+{
+    constexpr size_t N = 1 << 20;
+    auto data = genData(N);
+    const auto path = snapshotPath(N);
+    LoaTable table;
+    for (auto&& v : data) {
+        table.insert(v.first, v.second);
+    }
+    if (state.range(0)) {
+        if (!table.save(path.c_str()) || !table.load_mmap(path.c_str())) {
+            state.SkipWithError("snapshot round trip failed");
+            return;
+        }
+        unlink(path.c_str());
+    }
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(table.find(data[i].first));
+        i = (i + 1) & (N - 1);
+    }
+}
+BENCHMARK(BM_LoaFindMapped)->Arg(0)->Arg(1);
+
+BENCHMARK_MAIN();
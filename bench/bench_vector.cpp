@@ -1,3 +1,4 @@
+#include "perf_counters.h"
 #include <benchmark/benchmark.h>
 #include <climits>
 #include <iostream>
@@ -64,13 +65,17 @@ template <class Cont>
 static void BM_CopyAssignTriviallyCopyableToLarger(benchmark::State& state)
 {
     int N = (int)state.range(0);
+    perf::Counters counters;
+    counters.start();
     for (auto _ : state) {
-        state.PauseTiming();
+        counters.pause_timing(state);
         Cont src(N / 2, 42);
         Cont dst(N, 55);
-        state.ResumeTiming();
+        counters.resume_timing(state);
         benchmark::DoNotOptimize(dst = src);
     }
+    counters.stop();
+    counters.report(state, double(state.iterations()));
 }
 BENCHMARK_TEMPLATE(BM_CopyAssignTriviallyCopyableToLarger, PltIntVec)
 COPY_ASSIGN_ARGS;
@@ -87,13 +92,17 @@ template <class Cont>
 static void BM_CopyAssignTriviallyCopyableToSmaller(benchmark::State& state)
 {
     int N = (int)state.range(0);
+    perf::Counters counters;
+    counters.start();
     for (auto _ : state) {
-        state.PauseTiming();
+        counters.pause_timing(state);
         Cont src(N, 42);
         Cont dst(N / 2, 55);
-        state.ResumeTiming();
+        counters.resume_timing(state);
         benchmark::DoNotOptimize(dst = src);
     }
+    counters.stop();
+    counters.report(state, double(state.iterations()));
 }
 BENCHMARK_TEMPLATE(BM_CopyAssignTriviallyCopyableToSmaller, PltIntVec)
 COPY_ASSIGN_ARGS;
@@ -112,14 +121,18 @@ static void BM_CopyAssignNonTriviallyCopyableToLarger(benchmark::State& state)
     std::string astring(27, 'a'); // NOTE: No SSO
     std::string bstring(32, 'b'); // NOTE: No SSO
     int N = (int)state.range(0);
+    perf::Counters counters;
+    counters.start();
     for (auto _ : state) {
-        state.PauseTiming();
+        counters.pause_timing(state);
         Cont src(N / 2, astring);
         Cont dst(N, bstring);
         assert(src.size() < dst.size());
-        state.ResumeTiming();
+        counters.resume_timing(state);
         benchmark::DoNotOptimize(dst = src);
     }
+    counters.stop();
+    counters.report(state, double(state.iterations()));
 }
 BENCHMARK_TEMPLATE(BM_CopyAssignNonTriviallyCopyableToLarger, PltStrVec)
 COPY_ASSIGN_ARGS;
@@ -154,14 +167,18 @@ static void BM_CopyAssignNonTriviallyCopyableToSmaller(benchmark::State& state)
     std::string astring(27, 'a'); // NOTE: No SSO
     std::string bstring(32, 'b'); // NOTE: No SSO
     int N = (int)state.range(0);
+    perf::Counters counters;
+    counters.start();
     for (auto _ : state) {
-        state.PauseTiming();
+        counters.pause_timing(state);
         Cont src(N, astring);
         Cont dst(N / 2, bstring);
         assert(src.size() < dst.size());
-        state.ResumeTiming();
+        counters.resume_timing(state);
         benchmark::DoNotOptimize(dst = src);
     }
+    counters.stop();
+    counters.report(state, double(state.iterations()));
 }
 BENCHMARK_TEMPLATE(BM_CopyAssignNonTriviallyCopyableToSmaller, PltStrVec)
 COPY_ASSIGN_ARGS;
@@ -193,26 +210,34 @@ COPY_ASSIGN_ARGS;
 template <class Cont>
 static void BM_AppendTrivial(benchmark::State& state)
 {
+    perf::Counters counters;
+    counters.start();
     for (auto _ : state) {
-        state.PauseTiming();
+        counters.pause_timing(state);
         Cont vec(42, state.range(0));
-        state.ResumeTiming();
+        counters.resume_timing(state);
         for (int i = 0; i < state.range(1); ++i) {
             vec.push_back(i);
         }
     }
+    counters.stop();
+    counters.report(state, double(state.iterations() * state.range(1)));
 }
 static void BM_AppendTrivial_Unsafe(benchmark::State& state)
 {
+    perf::Counters counters;
+    counters.start();
     for (auto _ : state) {
-        state.PauseTiming();
+        counters.pause_timing(state);
         PltIntVec vec(42, state.range(0));
         vec.reserve(vec.size() + state.range(1));
-        state.ResumeTiming();
+        counters.resume_timing(state);
         for (int i = 0; i < state.range(1); ++i) {
             vec.try_append(i);
         }
     }
+    counters.stop();
+    counters.report(state, double(state.iterations() * state.range(1)));
 }
 BENCHMARK_TEMPLATE(BM_AppendTrivial, PltIntVec) APPEND_ARGS;
 BENCHMARK_TEMPLATE(BM_AppendTrivial, StlIntVec) APPEND_ARGS;
@@ -233,13 +258,17 @@ template <class Cont>
 static void BM_EraseTrivial(benchmark::State& state)
 {
     size_t ii = 0;
+    perf::Counters counters;
+    counters.start();
     for (auto _ : state) {
-        state.PauseTiming();
+        counters.pause_timing(state);
         Cont vec(state.range(0), 42);
-        state.ResumeTiming();
+        counters.resume_timing(state);
         benchmark::DoNotOptimize(vec.erase(vec.begin() + 1, vec.end() - 1));
         ii += vec.size();
     }
+    counters.stop();
+    counters.report(state, double(state.iterations()));
     if (ii == 0) {
         throw std::runtime_error{"failed"};
     }
@@ -250,12 +279,16 @@ BENCHMARK_TEMPLATE(BM_EraseTrivial, StlIntVec) ERASE_ARGS;
 template <class Cont>
 static void BM_EraseNoThrowMove(benchmark::State& state)
 {
+    perf::Counters counters;
+    counters.start();
     for (auto _ : state) {
-        state.PauseTiming();
+        counters.pause_timing(state);
         Cont vec(state.range(0), "Hello World");
-        state.ResumeTiming();
+        counters.resume_timing(state);
         benchmark::DoNotOptimize(vec.erase(vec.begin() + 1, vec.end() - 1));
     }
+    counters.stop();
+    counters.report(state, double(state.iterations()));
 }
 BENCHMARK_TEMPLATE(BM_EraseNoThrowMove, PltStrVec) ERASE_ARGS;
 BENCHMARK_TEMPLATE(BM_EraseNoThrowMove, StlStrVec) ERASE_ARGS;
@@ -0,0 +1,168 @@
+#include "adapters.h"
+#include "ycsb.h"
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <pltables++/linear_open_address.h>
+#include <string>
+#include <vector>
+
+// YCSB core workloads A-F (plus "churn") over uniform, Zipfian, latest and
+// hotspot key distributions on each table. Each iteration loads the records
+// into a fresh table and times the replay of a pre-generated operation
+// stream. Benchmarks are named Ycsb/<mix>/<distribution>/<engine>.
+//
+// Flags, consumed before Google Benchmark's:
+//   --ycsb_records=N   records loaded before the run (default 2^20)
+//   --ycsb_ops=N       operations per run (default 2^20)
+//   --ycsb_theta=X     Zipfian skew (default 0.99)
+//   --ycsb_mix=R,U,I,E,RMW,SCAN
+//                      adds a "custom" workload with these proportions of
+//                      read, update, insert, erase, read-modify-write and
+//                      scan
+
+using ycsb::Distribution;
+
+static inline int ycsb_u64_hash(uint64_t k)
+{
+    return int(k ^ (k >> 32));
+}
+static inline int ycsb_u64_eq(uint64_t a, uint64_t b)
+{
+    return a == b;
+}
+QOA_INIT(ycsb_u64, uint64_t, uint64_t, ycsb_u64_hash, ycsb_u64_eq);
+PLT_QOA_MAP(QoaRecords, ycsb_u64, uint64_t, uint64_t);
+
+using LoaRecords = LoaMap<loatable<uint64_t, uint64_t>>;
+using KlibRecords = KlibMap<uint64_t, uint64_t>;
+using StlRecords = StlMap<uint64_t, uint64_t>;
+
+static ycsb::Params params;
+
+struct Stream
+{
+    std::vector<ycsb::Op> ops;
+    size_t reads = 0; // operations that look a record up
+};
+
+static const Stream& stream(const ycsb::Mix& mix, Distribution d)
+{
+    // Engines run back to back on each stream; keep the last one.
+    static Stream last;
+    static const ycsb::Mix* lastMix = nullptr;
+    static Distribution lastDist;
+    if (lastMix == &mix && lastDist == d)
+        return last;
+    last.ops = ycsb::generate(mix, d, params);
+    last.reads = 0;
+    for (const auto& op : last.ops) {
+        last.reads += op.type == ycsb::Read || op.type == ycsb::Scan ||
+                      op.type == ycsb::ReadModifyWrite;
+    }
+    lastMix = &mix;
+    lastDist = d;
+    return last;
+}
+
+using Clock = std::chrono::steady_clock;
+
+template <class Map>
+static void BM_Ycsb(benchmark::State& state, const ycsb::Mix* mix,
+                    Distribution d)
+{
+    const Stream& s = stream(*mix, d);
+    std::vector<uint64_t> load(params.records);
+    for (size_t id = 0; id < load.size(); ++id)
+        load[id] = ycsb::record_key(id);
+    size_t hits = 0;
+    size_t records = 0;
+    for (auto _ : state) {
+        auto map = std::make_unique<Map>();
+        for (uint64_t key : load)
+            *map->insert(key) = key;
+        const auto t0 = Clock::now();
+        hits = ycsb::replay(*map, s.ops);
+        state.SetIterationTime(
+          std::chrono::duration<double>(Clock::now() - t0).count());
+        records = map->size();
+    }
+    state.SetItemsProcessed(int64_t(state.iterations() * s.ops.size()));
+    state.counters["hit_rate"] = s.reads ? double(hits) / double(s.reads) : 0;
+    state.counters["records"] = double(records);
+}
+
+static const char* flagValue(const char* arg, const char* flag)
+{
+    const size_t n = strlen(flag);
+    return strncmp(arg, flag, n) == 0 && arg[n] == '=' ? arg + n + 1 : nullptr;
+}
+
+int main(int argc, char** argv)
+{
+    static ycsb::Mix custom{ "custom", 0, 0, 0, 0, 0, 0 };
+    bool haveCustom = false;
+    int out = 1;
+    for (int i = 1; i < argc; ++i) {
+        const char* v;
+        if ((v = flagValue(argv[i], "--ycsb_records"))) {
+            params.records = strtoull(v, nullptr, 0);
+        } else if ((v = flagValue(argv[i], "--ycsb_ops"))) {
+            params.ops = strtoull(v, nullptr, 0);
+        } else if ((v = flagValue(argv[i], "--ycsb_theta"))) {
+            params.theta = strtod(v, nullptr);
+        } else if ((v = flagValue(argv[i], "--ycsb_mix"))) {
+            if (sscanf(v, "%lf,%lf,%lf,%lf,%lf,%lf", &custom.read,
+                       &custom.update, &custom.insert, &custom.erase,
+                       &custom.rmw, &custom.scan) < 1) {
+                fprintf(stderr, "bad --ycsb_mix: %s\n", v);
+                return 1;
+            }
+            haveCustom = true;
+        } else {
+            argv[out++] = argv[i];
+        }
+    }
+    argc = out;
+    if (params.records == 0 || params.ops == 0) {
+        fprintf(stderr, "--ycsb_records and --ycsb_ops must be positive\n");
+        return 1;
+    }
+
+    std::vector<const ycsb::Mix*> mixes;
+    for (const auto& m : ycsb::coreMixes)
+        mixes.push_back(&m);
+    if (haveCustom)
+        mixes.push_back(&custom);
+    const Distribution dists[] = { Distribution::Uniform,
+                                   Distribution::Zipfian, Distribution::Latest,
+                                   Distribution::Hotspot };
+    const std::pair<const char*, void (*)(benchmark::State&,
+                                          const ycsb::Mix*, Distribution)>
+      engines[] = {
+          { "loatable", BM_Ycsb<LoaRecords> },
+          { "klibtable", BM_Ycsb<KlibRecords> },
+          { "qoatable", BM_Ycsb<QoaRecords> },
+          { "unordered_map", BM_Ycsb<StlRecords> },
+      };
+    for (const ycsb::Mix* mix : mixes) {
+        for (Distribution d : dists) {
+            for (const auto& e : engines) {
+                const std::string name = std::string("Ycsb/") + mix->name +
+                                         "/" + ycsb::distributionName(d) +
+                                         "/" + e.first;
+                benchmark::RegisterBenchmark(name.c_str(), e.second, mix, d)
+                  ->UseManualTime()
+                  ->Unit(benchmark::kMillisecond);
+            }
+        }
+    }
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+    benchmark::RunSpecifiedBenchmarks();
+}
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+// The machine's data cache sizes, for benchmarks that sweep table sizes
+// across the cache hierarchy. Read from sysfs (CPU 0), falling back to
+// sysconf(3) and then to a typical 32 KiB / 1 MiB / 32 MiB.
+
+namespace cache {
+
+struct Level
+{
+    int level;
+    size_t bytes;
+};
+
+// "48K", "2048K", "30M" as bytes; 0 if unparsable.
+inline size_t _parse_size(const char* s) noexcept
+{
+    char* end;
+    size_t n = size_t(strtoull(s, &end, 10));
+    switch (*end) {
+        case 'K':
+            return n << 10;
+        case 'M':
+            return n << 20;
+        case 'G':
+            return n << 30;
+        default:
+            return end == s ? 0 : n;
+    }
+}
+
+inline bool _read_line(const std::string& path, char* buf, size_t len)
+{
+    FILE* f = fopen(path.c_str(), "r");
+    if (!f)
+        return false;
+    const bool ok = fgets(buf, int(len), f) != nullptr;
+    fclose(f);
+    return ok;
+}
+
+inline std::vector<Level> _sysfs_levels()
+{
+    std::vector<Level> levels;
+    for (int i = 0;; ++i) {
+        const std::string dir =
+          "/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(i) + "/";
+        char level[16], type[32], size[32];
+        if (!_read_line(dir + "level", level, sizeof(level)) ||
+            !_read_line(dir + "type", type, sizeof(type)) ||
+            !_read_line(dir + "size", size, sizeof(size)))
+            break;
+        // Instruction caches do not hold table data.
+        if (type[0] == 'I')
+            continue;
+        const size_t bytes = _parse_size(size);
+        if (bytes)
+            levels.push_back({ atoi(level), bytes });
+    }
+    return levels;
+}
+
+inline std::vector<Level> _sysconf_levels()
+{
+    std::vector<Level> levels;
+#if defined(_SC_LEVEL1_DCACHE_SIZE)
+    const int names[] = { _SC_LEVEL1_DCACHE_SIZE, _SC_LEVEL2_CACHE_SIZE,
+                          _SC_LEVEL3_CACHE_SIZE };
+    for (int i = 0; i < 3; ++i) {
+        const long bytes = sysconf(names[i]);
+        if (bytes > 0)
+            levels.push_back({ i + 1, size_t(bytes) });
+    }
+#endif
+    return levels;
+}
+
+// Data and unified caches, innermost first.
+inline const std::vector<Level>& levels()
+{
+    static const std::vector<Level> cached = [] {
+        auto ls = _sysfs_levels();
+        if (ls.empty())
+            ls = _sysconf_levels();
+        if (ls.empty())
+            ls = { { 1, size_t(32) << 10 },
+                   { 2, size_t(1) << 20 },
+                   { 3, size_t(32) << 20 } };
+        std::sort(ls.begin(), ls.end(), [](const Level& a, const Level& b) {
+            return a.level < b.level;
+        });
+        return ls;
+    }();
+    return cached;
+}
+
+inline size_t physical_memory() noexcept
+{
+    const long pages = sysconf(_SC_PHYS_PAGES);
+    const long page = sysconf(_SC_PAGESIZE);
+    return pages > 0 && page > 0 ? size_t(pages) * size_t(page) : 0;
+}
+
+// Upper end of a sweep: 8x the last level, at most 1/8 of physical memory.
+inline size_t dram_bytes() noexcept
+{
+    size_t dram = levels().back().bytes * 8;
+    if (const size_t mem = physical_memory())
+        dram = std::min(dram, mem / 8);
+    return dram;
+}
+
+// A size a table can be built at: `entries` entries take `bytes`.
+struct Step
+{
+    size_t entries;
+    size_t bytes;
+};
+
+// Entry counts picked from `steps` (ascending footprints): for each level
+// the largest step within 3/4 of it and the smallest past 3/2 of it, plus
+// the largest within dram_bytes(). Ascending, without repeats.
+inline std::vector<size_t> sweep_sizes(const std::vector<Step>& steps,
+                                       size_t min_entries = 64)
+{
+    std::vector<size_t> sizes;
+    auto add = [&](const Step* s) {
+        if (s && s->entries >= min_entries)
+            sizes.push_back(s->entries);
+    };
+    auto largest_within = [&](size_t bytes) {
+        const Step* found = nullptr;
+        for (const Step& s : steps) {
+            if (s.bytes <= bytes)
+                found = &s;
+        }
+        return found;
+    };
+    for (const Level& l : levels()) {
+        add(largest_within(l.bytes / 4 * 3));
+        for (const Step& s : steps) {
+            if (s.bytes >= l.bytes / 2 * 3) {
+                add(&s);
+                break;
+            }
+        }
+    }
+    add(largest_within(dram_bytes()));
+    std::sort(sizes.begin(), sizes.end());
+    sizes.erase(std::unique(sizes.begin(), sizes.end()), sizes.end());
+    return sizes;
+}
+
+// "L2 1.5MiB": the innermost level a footprint of `bytes` fits in, else
+// "DRAM", and the footprint.
+inline std::string describe(size_t bytes)
+{
+    std::string where = "DRAM";
+    for (const Level& l : levels()) {
+        if (bytes <= l.bytes) {
+            where = "L" + std::to_string(l.level);
+            break;
+        }
+    }
+    char buf[32];
+    if (bytes >= size_t(1) << 20)
+        snprintf(buf, sizeof(buf), " %.1fMiB", double(bytes) / (1 << 20));
+    else
+        snprintf(buf, sizeof(buf), " %.1fKiB", double(bytes) / (1 << 10));
+    return where + buf;
+}
+
+} // ~cache
@@ -0,0 +1,349 @@
+#!/usr/bin/env python3
+"""Benchmark regression gate.
+
+    compare.py run -o current.json build/release/bench/bench-loa ...
+    compare.py compare baseline.json current.json
+
+`run` runs Google Benchmark executables with repetitions, pinned to one CPU,
+and saves the per-repetition times together with the machine state that
+moves them: CPU model, frequency, governor and turbo/boost setting, kernel
+and git revision.
+
+`compare` matches benchmarks by executable and name (which spell out the
+engine and workload, e.g. BM_LoaTableFind<KlibTable*>/65536/1024) and tests
+each pair of samples with a two-sided Mann-Whitney U test. The change is the
+Hodges-Lehmann estimate of the time ratio, with a distribution-free
+confidence interval. A benchmark is a regression when the difference is
+significant at --alpha and the estimated slowdown is at least --threshold.
+The exit status is 1 if there is a regression. Only the standard library is
+needed.
+"""
+
+import argparse
+import json
+import math
+import os
+import platform
+import statistics
+import subprocess
+import sys
+import tempfile
+
+TIME_UNITS = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+# -- run --------------------------------------------------------------------
+
+def read_file(path):
+    try:
+        with open(path) as f:
+            return f.read().strip()
+    except OSError:
+        return None
+
+
+def cpu_model():
+    for line in (read_file("/proc/cpuinfo") or "").splitlines():
+        if line.startswith("model name"):
+            return line.split(":", 1)[1].strip()
+    return platform.processor() or None
+
+
+def cpu_state(cpu):
+    """Frequency scaling state of `cpu`; fields the kernel lacks are None."""
+    base = f"/sys/devices/system/cpu/cpu{cpu}/cpufreq/"
+    khz = lambda name: read_file(base + name)
+    no_turbo = read_file("/sys/devices/system/cpu/intel_pstate/no_turbo")
+    boost = read_file("/sys/devices/system/cpu/cpufreq/boost")
+    if no_turbo is not None:
+        turbo = no_turbo == "0"
+    elif boost is not None:
+        turbo = boost == "1"
+    else:
+        turbo = None
+    return {
+        "cpu": cpu,
+        "model": cpu_model(),
+        "governor": read_file(base + "scaling_governor"),
+        "driver": read_file(base + "scaling_driver"),
+        "cur_khz": khz("scaling_cur_freq"),
+        "min_khz": khz("scaling_min_freq"),
+        "max_khz": khz("scaling_max_freq"),
+        "turbo": turbo,
+    }
+
+
+def git_revision():
+    try:
+        rev = subprocess.run(["git", "rev-parse", "--short", "HEAD"],
+                             capture_output=True, text=True, check=True)
+        dirty = subprocess.run(["git", "status", "--porcelain",
+                                "--untracked-files=no"],
+                               capture_output=True, text=True, check=True)
+    except (OSError, subprocess.CalledProcessError):
+        return None
+    return rev.stdout.strip() + ("-dirty" if dirty.stdout.strip() else "")
+
+
+def pin(cpu):
+    """Pin this process, and so the benchmarks it starts, to `cpu`."""
+    allowed = sorted(os.sched_getaffinity(0))
+    if cpu is None:
+        # The last CPU tends to see fewer interrupts than CPU 0.
+        cpu = allowed[-1]
+    if cpu not in allowed:
+        sys.exit(f"compare.py: CPU {cpu} not in affinity set {allowed}")
+    os.sched_setaffinity(0, {cpu})
+    return cpu
+
+
+def warn_environment(state):
+    if state["governor"] not in (None, "performance"):
+        print(f"warning: CPU {state['cpu']} governor is "
+              f"'{state['governor']}', not 'performance'", file=sys.stderr)
+    if state["turbo"]:
+        print("warning: turbo/boost is on; results will vary with "
+              "temperature", file=sys.stderr)
+
+
+def run(args):
+    cpu = None
+    if args.cpu != "none":
+        cpu = pin(None if args.cpu == "auto" else int(args.cpu))
+    env = cpu_state(cpu if cpu is not None else 0)
+    warn_environment(env)
+    result = {
+        "context": {
+            "pinned_cpu": cpu,
+            "cpu": env,
+            "host": platform.node(),
+            "kernel": platform.release(),
+            "revision": git_revision(),
+            "repetitions": args.repetitions,
+        },
+        "executables": {},
+        "benchmarks": [],
+    }
+    for exe in args.executables:
+        name = os.path.basename(exe)
+        with tempfile.NamedTemporaryFile(suffix=".json") as out:
+            cmd = [exe,
+                   f"--benchmark_repetitions={args.repetitions}",
+                   "--benchmark_enable_random_interleaving=true",
+                   "--benchmark_display_aggregates_only=true",
+                   f"--benchmark_out={out.name}",
+                   "--benchmark_out_format=json"]
+            if args.filter:
+                cmd.append(f"--benchmark_filter={args.filter}")
+            if args.min_time:
+                cmd.append(f"--benchmark_min_time={args.min_time}")
+            print("+ " + " ".join(cmd), file=sys.stderr)
+            if subprocess.run(cmd).returncode != 0:
+                sys.exit(f"compare.py: {exe} failed")
+            data = json.load(out)
+        result["executables"][name] = data.get("context", {})
+        for b in data.get("benchmarks", []):
+            if b.get("run_type", "iteration") == "iteration":
+                b["executable"] = name
+                result["benchmarks"].append(b)
+    with open(args.output, "w") as f:
+        json.dump(result, f, indent=1)
+    print(f"wrote {len(result['benchmarks'])} samples to {args.output}",
+          file=sys.stderr)
+
+
+# -- statistics -------------------------------------------------------------
+
+def ranks(values):
+    """1-based ranks, ties given their average rank, and the tie sizes."""
+    order = sorted(range(len(values)), key=values.__getitem__)
+    r = [0.0] * len(values)
+    ties = []
+    i = 0
+    while i < len(order):
+        j = i
+        while j + 1 < len(order) and values[order[j + 1]] == values[order[i]]:
+            j += 1
+        for k in range(i, j + 1):
+            r[order[k]] = (i + j) / 2 + 1
+        if j > i:
+            ties.append(j - i + 1)
+        i = j + 1
+    return r, ties
+
+
+def u_distribution(n1, n2):
+    """Counts of each U under H0 for samples of n1 and n2 without ties."""
+    table = {}
+
+    def f(a, b):
+        if a == 0 or b == 0:
+            return [1]
+        if (a, b) not in table:
+            left, right = f(a - 1, b), f(a, b - 1)
+            counts = [0] * (a * b + 1)
+            for u, c in enumerate(left):
+                counts[u + b] += c
+            for u, c in enumerate(right):
+                counts[u] += c
+            table[a, b] = counts
+        return table[a, b]
+
+    return f(n1, n2)
+
+
+def mann_whitney(x, y):
+    """Two-sided p-value of the Mann-Whitney U test of x against y: exact
+    for small samples without ties, else the normal approximation with tie
+    and continuity corrections."""
+    n1, n2 = len(x), len(y)
+    r, ties = ranks(list(x) + list(y))
+    u = sum(r[:n1]) - n1 * (n1 + 1) / 2
+    if not ties and n1 * n2 <= 1000:
+        counts = u_distribution(n1, n2)
+        total = sum(counts)
+        tail = min(u, n1 * n2 - u)
+        p = 2 * sum(counts[: int(tail) + 1]) / total
+        return min(p, 1.0)
+    n = n1 + n2
+    mean = n1 * n2 / 2
+    var = n1 * n2 / 12 * ((n + 1) - sum(t ** 3 - t for t in ties)
+                          / (n * (n - 1)))
+    if var <= 0:
+        return 1.0
+    z = max(abs(u - mean) - 0.5, 0) / math.sqrt(var)
+    return math.erfc(z / math.sqrt(2))
+
+
+def hodges_lehmann(x, y, confidence):
+    """Shift of y over x (median of pairwise differences y_j - x_i) and its
+    confidence interval from the order statistics of those differences."""
+    n1, n2 = len(x), len(y)
+    d = sorted(b - a for a in x for b in y)
+    z = statistics.NormalDist().inv_cdf(1 - (1 - confidence) / 2)
+    k = int(n1 * n2 / 2 - z * math.sqrt(n1 * n2 * (n1 + n2 + 1) / 12))
+    if k < 1:
+        return statistics.median(d), d[0], d[-1]
+    return statistics.median(d), d[k - 1], d[len(d) - k]
+
+
+# -- compare ----------------------------------------------------------------
+
+def samples(result, metric):
+    """{(executable, name): [time in ns, ...]}"""
+    out = {}
+    for b in result["benchmarks"]:
+        key = (b["executable"], b.get("run_name", b["name"]))
+        scale = TIME_UNITS.get(b.get("time_unit", "ns"), 1.0)
+        out.setdefault(key, []).append(b[metric] * scale)
+    return out
+
+
+def fmt_time(ns):
+    for unit, scale in (("s", 1e9), ("ms", 1e6), ("us", 1e3)):
+        if ns >= scale:
+            return f"{ns / scale:.3g}{unit}"
+    return f"{ns:.3g}ns"
+
+
+def fmt_pct(ratio):
+    return f"{(ratio - 1) * 100:+.1f}%"
+
+
+def describe(context):
+    cpu = context.get("cpu", {})
+    return (f"{context.get('host')} {context.get('revision')} "
+            f"cpu{context.get('pinned_cpu')} {cpu.get('model')} "
+            f"governor={cpu.get('governor')} turbo={cpu.get('turbo')} "
+            f"khz={cpu.get('min_khz')}-{cpu.get('max_khz')}")
+
+
+def compare(args):
+    with open(args.baseline) as f:
+        base = json.load(f)
+    with open(args.current) as f:
+        cur = json.load(f)
+    print(f"baseline: {describe(base['context'])}")
+    print(f"current:  {describe(cur['context'])}")
+    bcpu, ccpu = base["context"].get("cpu", {}), cur["context"].get("cpu", {})
+    for field in ("model", "governor", "turbo", "min_khz", "max_khz"):
+        if bcpu.get(field) != ccpu.get(field):
+            print(f"warning: {field} differs: {bcpu.get(field)} -> "
+                  f"{ccpu.get(field)}", file=sys.stderr)
+
+    bs, cs = samples(base, args.metric), samples(cur, args.metric)
+    confidence = 1 - args.alpha
+    regressions = improvements = 0
+    executable = None
+    print()
+    print(f"{'benchmark':<48} {'baseline':>9} {'current':>9} {'change':>8} "
+          f"{f'{confidence:.0%} CI':>17} {'p':>7}")
+    for key in sorted(bs.keys() | cs.keys()):
+        exe, name = key
+        if exe != executable:
+            executable = exe
+            print(f"[{exe}]")
+        if key not in bs or key not in cs:
+            where = "current" if key in cs else "baseline"
+            print(f"{name:<48} only in {where}")
+            continue
+        x, y = bs[key], cs[key]
+        p = mann_whitney(x, y)
+        # Ratios via log-times, so the interval is on current / baseline.
+        shift, lo, hi = hodges_lehmann([math.log(v) for v in x],
+                                       [math.log(v) for v in y], confidence)
+        ratio, lo, hi = math.exp(shift), math.exp(lo), math.exp(hi)
+        verdict = ""
+        if p < args.alpha and abs(ratio - 1) >= args.threshold:
+            if ratio > 1:
+                verdict = "REGRESSION"
+                regressions += 1
+            else:
+                verdict = "improvement"
+                improvements += 1
+        if len(x) < 5 or len(y) < 5:
+            verdict = (verdict + " (few samples)").strip()
+        print(f"{name:<48} {fmt_time(statistics.median(x)):>9} "
+              f"{fmt_time(statistics.median(y)):>9} {fmt_pct(ratio):>8} "
+              f"[{fmt_pct(lo):>7},{fmt_pct(hi):>7}] {p:>7.4f} {verdict}")
+    print()
+    print(f"{regressions} regression(s), {improvements} improvement(s) at "
+          f"alpha={args.alpha}, threshold={args.threshold:.0%}")
+    return 1 if regressions else 0
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(
+        description=__doc__, formatter_class=argparse.RawTextHelpFormatter)
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    r = sub.add_parser("run", help="run benchmarks and save the samples")
+    r.add_argument("executables", nargs="+")
+    r.add_argument("-o", "--output", required=True)
+    r.add_argument("-r", "--repetitions", type=int, default=10)
+    r.add_argument("--cpu", default="auto",
+                   help="CPU to pin to: a number, 'auto' (the last allowed "
+                        "CPU) or 'none'. Pinning puts threaded benchmarks "
+                        "on one CPU too")
+    r.add_argument("--filter", help="--benchmark_filter regex")
+    r.add_argument("--min-time", help="--benchmark_min_time")
+
+    c = sub.add_parser("compare", help="compare two runs")
+    c.add_argument("baseline")
+    c.add_argument("current")
+    c.add_argument("--alpha", type=float, default=0.01,
+                   help="significance level (default 0.01)")
+    c.add_argument("--threshold", type=float, default=0.02,
+                   help="smallest change reported, as a fraction "
+                        "(default 0.02)")
+    c.add_argument("--metric", choices=("real_time", "cpu_time"),
+                   default="real_time")
+    return parser.parse_args()
+
+
+if __name__ == '__main__':
+    args = parse_args()
+    if args.command == "run":
+        run(args)
+    else:
+        sys.exit(compare(args))
@@ -0,0 +1,246 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <pltables++/snapshot.h>
+#include <string>
+#include <sys/stat.h>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Deterministic benchmark inputs, generated once and cached on disk.
+//
+// A stream is a pure function of its generator, element type and
+// parameters (count, seed, ...): generators draw from SplitMix64 and reduce
+// to ranges with integer arithmetic only, so the same bytes come out on
+// every machine and standard library (std::uniform_int_distribution is
+// implementation-defined). Streams are stored as one-section snapshots (see
+// pltables++/snapshot.h) in $PLT_DATASET_DIR, by default
+// /tmp/pltables-datasets, under a name spelling out those parameters, and
+// later runs map the file read-only: setup is one mmap(2), and every engine,
+// run and checkout reads the same input. Delete the directory to regenerate.
+// Where the directory cannot be written, the stream lives in memory for the
+// run.
+
+namespace dataset {
+
+// Bump when a generator changes what it produces; stale files are then
+// regenerated rather than reused.
+constexpr uint64_t GeneratorVersion = 1;
+
+class SplitMix64
+{
+public:
+    explicit SplitMix64(uint64_t seed) noexcept : _state{ seed } {}
+
+    uint64_t operator()() noexcept
+    {
+        uint64_t z = (_state += 0x9e3779b97f4a7c15u);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9u;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebu;
+        return z ^ (z >> 31);
+    }
+
+    // Uniform in [0, n), by multiply-high (Lemire); the bias is below 2^-32
+    // for the sizes used here.
+    uint64_t below(uint64_t n) noexcept
+    {
+        return uint64_t((unsigned __int128)(*this)() * n >> 64);
+    }
+
+private:
+    uint64_t _state;
+};
+
+template <class K, class V>
+struct KeyValue
+{
+    K key;
+    V val;
+};
+
+// Read-only view of a stream: a file mapping, or the in-memory fallback.
+template <class T>
+class Stream
+{
+public:
+    Stream() noexcept = default;
+    Stream(const Stream&) = delete;
+    Stream& operator=(const Stream&) = delete;
+    Stream(Stream&& other) noexcept { *this = std::move(other); }
+    Stream& operator=(Stream&& other) noexcept
+    {
+        if (this != &other) {
+            plt::snapshot_unmap(_map, _map_bytes);
+            _map = std::exchange(other._map, nullptr);
+            _map_bytes = std::exchange(other._map_bytes, 0);
+            _data = std::exchange(other._data, nullptr);
+            _size = std::exchange(other._size, 0);
+            _owned = std::move(other._owned);
+        }
+        return *this;
+    }
+    ~Stream() noexcept { plt::snapshot_unmap(_map, _map_bytes); }
+
+    const T* data() const noexcept { return _data; }
+    size_t size() const noexcept { return _size; }
+    const T* begin() const noexcept { return _data; }
+    const T* end() const noexcept { return _data + _size; }
+    const T& operator[](size_t i) const noexcept { return _data[i]; }
+    // True when served from a file mapping.
+    bool mapped() const noexcept { return _map != nullptr; }
+
+    static Stream from_mapping(void* map, size_t bytes, const T* data,
+                               size_t n) noexcept
+    {
+        Stream s;
+        s._map = map;
+        s._map_bytes = bytes;
+        s._data = data;
+        s._size = n;
+        return s;
+    }
+
+    static Stream from_vector(std::vector<T>&& v) noexcept
+    {
+        Stream s;
+        s._owned = std::move(v);
+        s._data = s._owned.data();
+        s._size = s._owned.size();
+        return s;
+    }
+
+private:
+    void* _map = nullptr;
+    size_t _map_bytes = 0;
+    const T* _data = nullptr;
+    size_t _size = 0;
+    std::vector<T> _owned;
+};
+
+inline std::string directory()
+{
+    const char* dir = getenv("PLT_DATASET_DIR");
+    return dir && *dir ? dir : "/tmp/pltables-datasets";
+}
+
+inline uint64_t _fnv1a(const char* s) noexcept
+{
+    uint64_t h = 14695981039346656037ull;
+    for (; *s; ++s) {
+        h ^= static_cast<unsigned char>(*s);
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+// The stream `generator`(params...) of `n` elements: mapped from the cache
+// if a matching file is there, else `fill(T* out, size_t n)` is run and the
+// result written to the cache. At most 5 parameters besides `n`.
+template <class T, class Fill>
+Stream<T> cached(const char* generator, size_t n,
+                 std::initializer_list<uint64_t> params, Fill&& fill)
+{
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "datasets store elements as raw bytes");
+    constexpr size_t MaxParams = 5;
+    std::string path = directory() + "/" + generator + "-b" +
+                       std::to_string(sizeof(T)) + "-n" + std::to_string(n);
+    for (uint64_t p : params)
+        path += "-" + std::to_string(p);
+    path += ".bin";
+
+    auto header = plt::snapshot_header(plt::SnapshotKind::Dataset);
+    header.key_size = sizeof(T);
+    header.key_align = alignof(T);
+    header.hash_id = _fnv1a(generator);
+    header.hash_seed = GeneratorVersion;
+    header.params[0] = n;
+    size_t np = 1;
+    for (uint64_t p : params) {
+        if (np <= MaxParams)
+            header.params[np++] = p;
+    }
+
+    size_t bytes;
+    if (void* map =
+          plt::snapshot_map(path.c_str(), plt::SnapshotMode::ReadOnly, bytes)) {
+        const auto& hdr = *static_cast<const plt::SnapshotHeader*>(map);
+        const bool ok =
+          hdr.kind == header.kind && hdr.key_size == header.key_size &&
+          hdr.key_align == header.key_align &&
+          hdr.hash_id == header.hash_id &&
+          hdr.hash_seed == header.hash_seed &&
+          memcmp(hdr.params, header.params, sizeof(hdr.params)) == 0 &&
+          hdr.nsections == 1 && hdr.sections[0].bytes == n * sizeof(T);
+        if (ok) {
+            const auto* data = reinterpret_cast<const T*>(
+              static_cast<const char*>(map) + hdr.sections[0].offset);
+            return Stream<T>::from_mapping(map, bytes, data, n);
+        }
+        plt::snapshot_unmap(map, bytes);
+    }
+
+    std::vector<T> v(n);
+    fill(v.data(), n);
+    const std::string dir = directory();
+    if (mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST)
+        fprintf(stderr, "dataset: cannot create %s\n", dir.c_str());
+    const void* data[] = { v.data() };
+    const size_t sizes[] = { n * sizeof(T) };
+    if (plt::snapshot_write(path.c_str(), header, data, sizes, 1)) {
+        if (void* map = plt::snapshot_map(path.c_str(),
+                                          plt::SnapshotMode::ReadOnly, bytes)) {
+            const auto& hdr = *static_cast<const plt::SnapshotHeader*>(map);
+            const auto* p = reinterpret_cast<const T*>(
+              static_cast<const char*>(map) + hdr.sections[0].offset);
+            return Stream<T>::from_mapping(map, bytes, p, n);
+        }
+    }
+    return Stream<T>::from_vector(std::move(v));
+}
+
+// `n` ints uniform over the whole int range; repeats are possible.
+inline Stream<int> uniform_ints(size_t n, uint64_t seed)
+{
+    return cached<int>("uniform_ints", n, { seed }, [&](int* out, size_t m) {
+        SplitMix64 gen{ seed };
+        for (size_t i = 0; i < m; ++i)
+            out[i] = int(uint32_t(gen()));
+    });
+}
+
+// `n` key/value pairs, both uniform over the whole int range.
+inline Stream<KeyValue<int, int>> int_pairs(size_t n, uint64_t seed)
+{
+    using KV = KeyValue<int, int>;
+    return cached<KV>("int_pairs", n, { seed }, [&](KV* out, size_t m) {
+        SplitMix64 gen{ seed };
+        for (size_t i = 0; i < m; ++i) {
+            const uint64_t r = gen();
+            out[i] = KV{ int(uint32_t(r)), int(uint32_t(r >> 32)) };
+        }
+    });
+}
+
+// `m` lookups, each the key of a pair of int_pairs(n, seed) picked
+// uniformly at random with `query_seed`: a stream of hits.
+inline Stream<int> int_pair_queries(size_t n, uint64_t seed, size_t m,
+                                    uint64_t query_seed)
+{
+    return cached<int>(
+      "int_pair_queries", m, { n, seed, query_seed }, [&](int* out, size_t k) {
+          const auto pairs = int_pairs(n, seed);
+          SplitMix64 gen{ query_seed };
+          for (size_t i = 0; i < k; ++i)
+              out[i] = pairs[gen.below(pairs.size())].key;
+      });
+}
+
+} // ~dataset
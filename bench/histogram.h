@@ -0,0 +1,172 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Per-operation latency recording for the benchmarks: a cycle-counter
+// clock and an HDR-style log-linear histogram.
+
+namespace latency {
+
+// Timestamp in ticks: the TSC where there is one, nanoseconds otherwise.
+// rdtscp waits for the preceding instructions, so a pair of calls brackets
+// the operation between them.
+inline uint64_t ticks() noexcept
+{
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned aux;
+    return __rdtscp(&aux);
+#else
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return uint64_t(ts.tv_sec) * 1000000000u + uint64_t(ts.tv_nsec);
+#endif
+}
+
+// Nanoseconds per tick, measured once against steady_clock over ~20 ms.
+inline double ns_per_tick()
+{
+    static const double ratio = [] {
+#if defined(__x86_64__) || defined(__i386__)
+        using Clock = std::chrono::steady_clock;
+        const auto c0 = Clock::now();
+        const uint64_t t0 = ticks();
+        while (Clock::now() - c0 < std::chrono::milliseconds(20))
+            ;
+        const uint64_t t1 = ticks();
+        const auto c1 = Clock::now();
+        return std::chrono::duration<double, std::nano>(c1 - c0).count() /
+               double(t1 - t0);
+#else
+        return 1.0;
+#endif
+    }();
+    return ratio;
+}
+
+// Smallest tick difference between two back-to-back ticks() calls.
+inline uint64_t timer_overhead() noexcept
+{
+    uint64_t best = UINT64_MAX;
+    for (int i = 0; i < 1000; ++i) {
+        const uint64_t t0 = ticks();
+        best = std::min(best, ticks() - t0);
+    }
+    return best;
+}
+
+// Log-linear histogram of non-negative integer values, as in HdrHistogram:
+// values below 2^SubBits get a bucket each, and each power of two above is
+// split into 2^(SubBits - 1) equal buckets, so any recorded value is known
+// to within a relative error of 2^-(SubBits - 1). Recording is a bit scan
+// and an increment; the whole 64-bit range fits in a few thousand buckets.
+template <unsigned SubBits = 8>
+class LogLinearHistogram
+{
+    static_assert(SubBits >= 2 && SubBits < 32, "unsupported resolution");
+    static constexpr uint64_t Linear = uint64_t(1) << SubBits;
+    static constexpr uint64_t Half = Linear / 2;
+    static constexpr size_t Buckets = Linear + (64 - SubBits) * Half;
+
+public:
+    LogLinearHistogram() : _counts(Buckets) {}
+
+    void record(uint64_t v) noexcept
+    {
+        ++_counts[_index(v)];
+        ++_total;
+        _max = std::max(_max, v);
+        _min = std::min(_min, v);
+        _sum += double(v);
+    }
+
+    void merge(const LogLinearHistogram& other) noexcept
+    {
+        for (size_t i = 0; i < Buckets; ++i)
+            _counts[i] += other._counts[i];
+        _total += other._total;
+        _max = std::max(_max, other._max);
+        _min = std::min(_min, other._min);
+        _sum += other._sum;
+    }
+
+    void clear() noexcept
+    {
+        std::fill(_counts.begin(), _counts.end(), 0);
+        _total = 0;
+        _max = 0;
+        _min = UINT64_MAX;
+        _sum = 0;
+    }
+
+    uint64_t count() const noexcept { return _total; }
+    uint64_t max() const noexcept { return _max; }
+    uint64_t min() const noexcept { return _total ? _min : 0; }
+    double mean() const noexcept { return _total ? _sum / double(_total) : 0; }
+
+    // Smallest bucket bound at or above the value ranked q * count(), q in
+    // [0, 1]; never above max().
+    uint64_t percentile(double q) const noexcept
+    {
+        if (_total == 0)
+            return 0;
+        const uint64_t rank =
+          std::max<uint64_t>(1, uint64_t(q * double(_total) + 0.5));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < Buckets; ++i) {
+            seen += _counts[i];
+            if (seen >= rank)
+                return std::min(_upper(i), _max);
+        }
+        return _max;
+    }
+
+    // Calls f(lowest, highest, count) for each non-empty bucket in order.
+    template <class F>
+    void for_each_bucket(F&& f) const
+    {
+        for (size_t i = 0; i < Buckets; ++i) {
+            if (_counts[i] != 0)
+                f(_lower(i), _upper(i), _counts[i]);
+        }
+    }
+
+private:
+    static size_t _index(uint64_t v) noexcept
+    {
+        if (v < Linear)
+            return size_t(v);
+        const unsigned msb = 63u - unsigned(__builtin_clzll(v));
+        const unsigned shift = msb - (SubBits - 1);
+        return size_t(Linear + (shift - 1) * Half + ((v >> shift) - Half));
+    }
+    static uint64_t _lower(size_t i) noexcept
+    {
+        if (i < Linear)
+            return i;
+        const size_t shift = (i - Linear) / Half + 1;
+        return (Half + (i - Linear) % Half) << shift;
+    }
+    static uint64_t _upper(size_t i) noexcept
+    {
+        if (i < Linear)
+            return i;
+        const size_t shift = (i - Linear) / Half + 1;
+        return _lower(i) + ((uint64_t(1) << shift) - 1);
+    }
+
+    std::vector<uint64_t> _counts;
+    uint64_t _total = 0;
+    uint64_t _max = 0;
+    uint64_t _min = UINT64_MAX;
+    double _sum = 0;
+};
+
+} // ~latency
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+
+// A failed insert (out of memory, or a full fixed-capacity table) aborts the
+// run: the benchmark drivers have no use for a result past that point.
+[[noreturn]] inline void insertFailed(const char* table)
+{
+    fprintf(stderr, "%s: insert failed (out of memory or table full)\n",
+            table);
+    abort();
+}
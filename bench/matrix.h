@@ -0,0 +1,271 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// Workload matrix from the README's "To test" list: every operation x key
+// type x key pattern x tombstone ratio x table size, for every engine. The
+// engines are split over two translation units because khash and klibtable
+// (its C++ port) share macro and constant names, and the C loatable's
+// typedef shares its name with the C++ loatable.
+//
+// Table state: `size` live keys plus `tomb`% of `size` keys inserted and
+// erased again, which leaves tombstones in the open-addressing tables.
+//   insert    insert the `size` live keys into a table holding only the
+//             tombstones
+//   erase     erase every live key
+//   find_hit  look up live keys
+//   find_miss look up keys that were never inserted
+// Only the operations themselves are timed. Random keys are distinct and
+// probed in random order; sequential keys are 0, 1, 2, ... (or their string
+// and large-key forms) probed in insertion order.
+
+namespace matrix {
+
+enum class Op
+{
+    Insert,
+    Erase,
+    FindHit,
+    FindMiss,
+};
+
+enum class Pattern
+{
+    Random,
+    Sequential,
+};
+
+struct Workload
+{
+    Op op;
+    Pattern pattern;
+    int tomb;
+    size_t size;
+};
+
+// Lookups per find iteration.
+constexpr size_t QueryCount = size_t(1) << 14;
+
+// 32-byte key.
+struct BigKey
+{
+    uint64_t w[4];
+
+    bool operator==(const BigKey& other) const noexcept
+    {
+        return memcmp(w, other.w, sizeof(w)) == 0;
+    }
+};
+
+inline uint32_t big_hash(const BigKey& k) noexcept
+{
+    uint64_t h = k.w[0];
+    for (int i = 1; i < 4; ++i)
+        h = (h ^ k.w[i]) * 0x9e3779b97f4a7c15u;
+    return uint32_t(h ^ (h >> 32));
+}
+
+// X31, as in khash and qoatable.
+inline uint32_t str_hash(const char* s) noexcept
+{
+    uint32_t h = uint8_t(*s);
+    if (h != 0) {
+        for (++s; *s; ++s)
+            h = (h << 5) - h + uint8_t(*s);
+    }
+    return h;
+}
+
+// Bijective mixers, so distinct indices give distinct random keys.
+inline uint32_t mix32(uint32_t x) noexcept
+{
+    x ^= x >> 16;
+    x *= 0x85ebca6bu;
+    x ^= x >> 13;
+    x *= 0xc2b2ae35u;
+    x ^= x >> 16;
+    return x;
+}
+
+inline uint64_t mix64(uint64_t x) noexcept
+{
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9u;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebu;
+    x ^= x >> 31;
+    return x;
+}
+
+template <class Key>
+Key make_key(uint64_t i, Pattern p);
+
+template <>
+inline int make_key<int>(uint64_t i, Pattern p)
+{
+    return p == Pattern::Random ? int(mix32(uint32_t(i))) : int(i);
+}
+
+template <>
+inline std::string make_key<std::string>(uint64_t i, Pattern p)
+{
+    char buf[24];
+    if (p == Pattern::Random)
+        snprintf(buf, sizeof(buf), "%016llx", (unsigned long long)mix64(i));
+    else
+        snprintf(buf, sizeof(buf), "key:%012llu", (unsigned long long)i);
+    return buf;
+}
+
+template <>
+inline BigKey make_key<BigKey>(uint64_t i, Pattern p)
+{
+    if (p == Pattern::Sequential)
+        return BigKey{ { i, 0, 0, 0 } };
+    return BigKey{ { mix64(4 * i), mix64(4 * i + 1), mix64(4 * i + 2),
+                     mix64(4 * i + 3) } };
+}
+
+// The tables with C interfaces, and klibtable, which moves its keys with
+// realloc, hold strings as pointers into the dataset.
+inline int c_key(int k) noexcept
+{
+    return k;
+}
+inline const char* c_key(const std::string& k) noexcept
+{
+    return k.c_str();
+}
+inline const BigKey& c_key(const BigKey& k) noexcept
+{
+    return k;
+}
+
+// Key indices [0, size) are live, the next size * tomb / 100 are inserted
+// and erased, and the ones after those are never inserted.
+template <class Key>
+struct Dataset
+{
+    std::vector<Key> live;
+    std::vector<Key> doomed;
+    std::vector<Key> hits;
+    std::vector<Key> misses;
+};
+
+template <class Key>
+std::shared_ptr<const Dataset<Key>> dataset(Pattern p, int tomb, size_t size)
+{
+    // Engines run back to back on each workload; keep the last one.
+    static std::shared_ptr<const Dataset<Key>> last;
+    static std::tuple<Pattern, int, size_t> lastArgs;
+    if (last && lastArgs == std::make_tuple(p, tomb, size))
+        return last;
+    last.reset();
+
+    auto d = std::make_shared<Dataset<Key>>();
+    const size_t ndoomed = size * size_t(tomb) / 100;
+    d->live.reserve(size);
+    for (size_t i = 0; i < size; ++i)
+        d->live.push_back(make_key<Key>(i, p));
+    for (size_t i = 0; i < ndoomed; ++i)
+        d->doomed.push_back(make_key<Key>(size + i, p));
+    std::mt19937_64 gen(size * 131 + size_t(tomb));
+    std::uniform_int_distribution<size_t> pick(0, size - 1);
+    for (size_t i = 0; i < QueryCount; ++i) {
+        d->hits.push_back(d->live[p == Pattern::Random ? pick(gen) : i % size]);
+        d->misses.push_back(make_key<Key>(size + ndoomed + i, p));
+    }
+    last = d;
+    lastArgs = std::make_tuple(p, tomb, size);
+    return last;
+}
+
+using Clock = std::chrono::steady_clock;
+
+inline double seconds(Clock::duration d)
+{
+    return std::chrono::duration<double>(d).count();
+}
+
+// Engines are default constructible and expose insert(key),
+// find(key) -> bool, erase(key) and size().
+template <class Engine, class Key>
+std::unique_ptr<Engine> build(const Dataset<Key>& d, bool live)
+{
+    auto e = std::make_unique<Engine>();
+    for (const auto& k : d.doomed)
+        e->insert(k);
+    for (const auto& k : d.doomed)
+        e->erase(k);
+    if (live) {
+        for (const auto& k : d.live)
+            e->insert(k);
+    }
+    return e;
+}
+
+template <class Engine, class Key>
+void run(benchmark::State& state, Workload w)
+{
+    const auto d = dataset<Key>(w.pattern, w.tomb, w.size);
+    size_t items = 0;
+    if (w.op == Op::FindHit || w.op == Op::FindMiss) {
+        auto e = build<Engine>(*d, true);
+        const auto& keys = w.op == Op::FindHit ? d->hits : d->misses;
+        for (auto _ : state) {
+            const auto t0 = Clock::now();
+            for (const auto& k : keys)
+                benchmark::DoNotOptimize(e->find(k));
+            state.SetIterationTime(seconds(Clock::now() - t0));
+        }
+        items = keys.size();
+    } else {
+        for (auto _ : state) {
+            auto e = build<Engine>(*d, w.op == Op::Erase);
+            const auto t0 = Clock::now();
+            if (w.op == Op::Insert) {
+                for (const auto& k : d->live)
+                    e->insert(k);
+            } else {
+                for (const auto& k : d->live)
+                    e->erase(k);
+            }
+            state.SetIterationTime(seconds(Clock::now() - t0));
+            benchmark::DoNotOptimize(e->size());
+        }
+        items = d->live.size();
+    }
+    state.SetItemsProcessed(int64_t(state.iterations() * items));
+}
+
+struct EngineEntry
+{
+    const char* name;
+    void (*run)(benchmark::State&, Workload);
+};
+
+// Engines for key type "int", "string" or "big32" from bench_matrix_c.cpp.
+std::vector<EngineEntry> c_engines(const std::string& key);
+
+} // ~matrix
+
+namespace std {
+template <>
+struct hash<matrix::BigKey>
+{
+    size_t operator()(const matrix::BigKey& k) const noexcept
+    {
+        return matrix::big_hash(k);
+    }
+};
+} // ~std
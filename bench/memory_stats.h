@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+// Process memory figures for the benchmarks, from /proc/self/status and the
+// C library. All return 0 where the platform cannot say.
+
+namespace memstat {
+
+// A "Vm...:  <n> kB" line of /proc/self/status, in bytes.
+inline size_t _status_bytes(const char* field) noexcept
+{
+    FILE* f = fopen("/proc/self/status", "r");
+    if (!f)
+        return 0;
+    const size_t len = strlen(field);
+    char line[256];
+    size_t kb = 0;
+    while (fgets(line, sizeof(line), f)) {
+        if (strncmp(line, field, len) == 0 && line[len] == ':') {
+            kb = size_t(strtoull(line + len + 1, nullptr, 10));
+            break;
+        }
+    }
+    fclose(f);
+    return kb * 1024;
+}
+
+// Resident set size.
+inline size_t rss_bytes() noexcept
+{
+    return _status_bytes("VmRSS");
+}
+
+// High-water mark of the resident set since start-up or the last
+// reset_peak_rss().
+inline size_t peak_rss_bytes() noexcept
+{
+    return _status_bytes("VmHWM");
+}
+
+// Reset the high-water mark to the current RSS (Linux 4.0+). Returns false
+// if the kernel refused, in which case peak_rss_bytes() keeps covering the
+// whole run. Memory freed earlier is returned to the system first so it
+// does not count towards the next peak.
+inline bool reset_peak_rss() noexcept
+{
+#if defined(__GLIBC__)
+    malloc_trim(0);
+#endif
+    FILE* f = fopen("/proc/self/clear_refs", "w");
+    if (!f)
+        return false;
+    const bool ok = fputs("5", f) >= 0;
+    return fclose(f) == 0 && ok;
+}
+
+// Bytes malloc has handed out and not had back, slack and chunk headers
+// included.
+inline size_t heap_in_use() noexcept
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+    const struct mallinfo2 mi = mallinfo2();
+    return mi.uordblks + mi.hblkhd;
+#else
+    return 0;
+#endif
+}
+
+} // ~memstat
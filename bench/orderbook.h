@@ -0,0 +1,428 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <queue>
+#include <random>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Limit order book replay for the table benchmarks: a synthetic ITCH-like
+// message stream and a book engine parameterized on the tables that hold
+// the orders and the price levels.
+
+namespace orderbook {
+
+// ITCH 5.0 message types the engine understands. Prices are 4-decimal fixed
+// point, as on the wire.
+enum MsgType : char
+{
+    AddOrder = 'A',
+    OrderExecuted = 'E',
+    OrderCancel = 'X',
+    OrderDelete = 'D',
+    OrderReplace = 'U',
+};
+
+enum Side : uint8_t
+{
+    Buy = 0,
+    Sell = 1,
+};
+
+struct Msg
+{
+    uint64_t ref;
+    uint64_t new_ref; // OrderReplace only
+    int32_t price;    // AddOrder and OrderReplace
+    uint32_t shares;  // shares added, executed or cancelled
+    uint16_t book;    // stock locate
+    char type;
+    uint8_t side;
+};
+
+struct StreamParams
+{
+    size_t messages = size_t(1) << 21;
+    uint16_t books = 8;
+    int32_t tick = 100;
+    // Most orders are cancelled within a few dozen messages; the rest rest
+    // on the book for a long time.
+    double short_mean = 30;
+    double long_mean = 500000;
+    double long_fraction = 0.1;
+    // Chance per message of a partial execution or cancel of a random live
+    // order, and of the mid price moving one tick.
+    double partial_rate = 0.08;
+    double move_rate = 0.02;
+    uint64_t seed = 1;
+};
+
+// Deterministic for a given StreamParams. Order references increase
+// monotonically, as in ITCH. Adds are priced a geometric number of ticks
+// behind their book's current mid, so most land within a few ticks of the
+// touch; the mid takes a random walk. There is no matching.
+// An order's lifetime is drawn at entry; when it ends the order is deleted
+// (55%), replaced with a new reference and price (25%), executed in full
+// (15%) or cancelled in full (5%).
+inline std::vector<Msg> generate_stream(const StreamParams& p)
+{
+    struct Live
+    {
+        int32_t price;
+        uint32_t shares;
+        uint16_t book;
+        uint8_t side;
+        size_t slot; // index in `refs`
+    };
+    std::mt19937_64 gen(p.seed);
+    std::uniform_real_distribution<double> uni(0.0, 1.0);
+    std::geometric_distribution<int> depth(0.35);
+    std::geometric_distribution<int> lots(0.5);
+    std::exponential_distribution<double> short_life(1.0 / p.short_mean);
+    std::exponential_distribution<double> long_life(1.0 / p.long_mean);
+    std::uniform_int_distribution<uint16_t> pick_book(0, p.books - 1);
+
+    std::vector<int32_t> mid(p.books);
+    for (auto& m : mid)
+        m = int32_t(100 + gen() % 900) * 100 * p.tick;
+    std::unordered_map<uint64_t, Live> live;
+    std::vector<uint64_t> refs;
+    using Death = std::pair<uint64_t, uint64_t>; // (message index, ref)
+    std::priority_queue<Death, std::vector<Death>, std::greater<Death>> dies;
+    uint64_t next_ref = 1;
+    std::vector<Msg> out;
+    out.reserve(p.messages);
+
+    auto lifetime = [&] {
+        const double t =
+          uni(gen) < p.long_fraction ? long_life(gen) : short_life(gen);
+        return uint64_t(t) + 1;
+    };
+    auto enter = [&](uint16_t book, uint8_t side, int32_t price,
+                     uint32_t shares) {
+        const uint64_t ref = next_ref++;
+        live.emplace(ref, Live{ price, shares, book, side, refs.size() });
+        refs.push_back(ref);
+        dies.emplace(out.size() + lifetime(), ref);
+        return ref;
+    };
+    auto leave = [&](uint64_t ref) {
+        auto it = live.find(ref);
+        const size_t slot = it->second.slot;
+        refs[slot] = refs.back();
+        live.at(refs[slot]).slot = slot;
+        refs.pop_back();
+        live.erase(it);
+    };
+    auto quote = [&](uint16_t book, uint8_t side) {
+        const int32_t away = int32_t(1 + depth(gen)) * p.tick;
+        return side == Buy ? mid[book] - away : mid[book] + away;
+    };
+
+    while (out.size() < p.messages) {
+        Msg m{};
+        if (!dies.empty() && dies.top().first <= out.size()) {
+            const uint64_t ref = dies.top().second;
+            dies.pop();
+            auto it = live.find(ref);
+            if (it == live.end())
+                continue; // already gone through a partial event
+            const Live o = it->second;
+            const double r = uni(gen);
+            m.ref = ref;
+            m.book = o.book;
+            m.side = o.side;
+            if (r < 0.55) {
+                m.type = OrderDelete;
+                leave(ref);
+            } else if (r < 0.80) {
+                m.type = OrderReplace;
+                m.price = quote(o.book, o.side);
+                m.shares = 100 * uint32_t(1 + lots(gen));
+                leave(ref);
+                m.new_ref = enter(o.book, o.side, m.price, m.shares);
+            } else {
+                m.type = r < 0.95 ? OrderExecuted : OrderCancel;
+                m.shares = o.shares;
+                leave(ref);
+            }
+        } else if (!refs.empty() && uni(gen) < p.partial_rate) {
+            const uint64_t ref = refs[gen() % refs.size()];
+            Live& o = live.at(ref);
+            m.type = uni(gen) < 0.5 ? OrderExecuted : OrderCancel;
+            m.ref = ref;
+            m.book = o.book;
+            m.side = o.side;
+            m.shares = std::max<uint32_t>(1, o.shares / 2);
+            o.shares -= m.shares;
+            if (o.shares == 0)
+                leave(ref);
+        } else {
+            const uint16_t book = pick_book(gen);
+            if (uni(gen) < p.move_rate)
+                mid[book] += gen() % 2 ? p.tick : -p.tick;
+            m.type = AddOrder;
+            m.book = book;
+            m.side = uint8_t(gen() % 2);
+            m.price = quote(book, m.side);
+            m.shares = 100 * uint32_t(1 + lots(gen));
+            m.ref = enter(book, m.side, m.price, m.shares);
+        }
+        out.push_back(m);
+    }
+    return out;
+}
+
+struct Order
+{
+    int32_t price;
+    uint32_t shares;
+    uint16_t book;
+    uint8_t side;
+};
+
+struct Level
+{
+    uint64_t shares;
+    uint32_t orders;
+};
+
+// Price level containers hold one side of one book. They are constructed
+// from the side and the tick and expose add, remove, best, empty, size and
+// level.
+
+// Price levels kept in a hash map from price to Level. The best price is
+// tracked on add and, when its level empties, found again by stepping one
+// tick at a time away from the touch.
+template <class LevelMap>
+class HashLevels
+{
+public:
+    HashLevels(bool buy, int32_t tick) noexcept : _tick{ tick }, _buy{ buy } {}
+
+    void add(int32_t price, uint32_t shares) noexcept
+    {
+        Level& l = *_levels.insert(price);
+        l.shares += shares;
+        if (l.orders++ == 0) {
+            if (_levels.size() == 1 || (_buy ? price > _best : price < _best))
+                _best = price;
+            _worst = _levels.size() == 1 ? price
+                     : _buy ? std::min(_worst, price)
+                            : std::max(_worst, price);
+        }
+    }
+
+    void remove(int32_t price, uint32_t shares, bool last) noexcept
+    {
+        Level& l = *_levels.find(price);
+        l.shares -= shares;
+        if (!last || --l.orders != 0)
+            return;
+        _levels.erase(price);
+        if (price != _best || _levels.size() == 0)
+            return;
+        const int32_t step = _buy ? -_tick : _tick;
+        do {
+            _best += step;
+        } while (_best != _worst && !_levels.find(_best));
+    }
+
+    size_t size() const noexcept { return _levels.size(); }
+    bool empty() const noexcept { return _levels.size() == 0; }
+    int32_t best() const noexcept { return _best; }
+    const Level* level(int32_t price) noexcept { return _levels.find(price); }
+
+private:
+    LevelMap _levels;
+    int32_t _best = 0;
+    // Bounds the search for the next best price; not tightened on erase.
+    int32_t _worst = 0;
+    int32_t _tick;
+    bool _buy;
+};
+
+// Price levels in an ordered map, the textbook baseline: the best price is
+// the first or last key.
+class MapLevels
+{
+public:
+    MapLevels(bool buy, int32_t /*tick*/) noexcept : _buy{ buy } {}
+
+    void add(int32_t price, uint32_t shares)
+    {
+        Level& l = _levels[price];
+        l.shares += shares;
+        ++l.orders;
+    }
+
+    void remove(int32_t price, uint32_t shares, bool last) noexcept
+    {
+        auto it = _levels.find(price);
+        it->second.shares -= shares;
+        if (last && --it->second.orders == 0)
+            _levels.erase(it);
+    }
+
+    size_t size() const noexcept { return _levels.size(); }
+    bool empty() const noexcept { return _levels.empty(); }
+    int32_t best() const noexcept
+    {
+        return _buy ? _levels.rbegin()->first : _levels.begin()->first;
+    }
+    const Level* level(int32_t price) const noexcept
+    {
+        auto it = _levels.find(price);
+        return it == _levels.end() ? nullptr : &it->second;
+    }
+
+private:
+    std::map<int32_t, Level> _levels;
+    bool _buy;
+};
+
+// Price levels in a price ladder (pltables++/price_ladder.h, or anything
+// with its interface): a tick-indexed window around the touch with a bitmap
+// for the best price.
+template <class Ladder>
+class LadderLevels
+{
+public:
+    LadderLevels(bool buy, int32_t tick) noexcept
+      : _ladder(buy ? Ladder::Side::Bid : Ladder::Side::Ask, tick)
+    {
+    }
+
+    void add(int32_t price, uint32_t shares) noexcept
+    {
+        Level& l = *_ladder.insert(price).first;
+        l.shares += shares;
+        ++l.orders;
+    }
+
+    void remove(int32_t price, uint32_t shares, bool last) noexcept
+    {
+        Level& l = *_ladder.find(price);
+        l.shares -= shares;
+        if (last && --l.orders == 0)
+            _ladder.erase(price);
+    }
+
+    size_t size() const noexcept { return _ladder.size(); }
+    bool empty() const noexcept { return _ladder.empty(); }
+    int32_t best() const noexcept { return _ladder.best(); }
+    const Level* level(int32_t price) noexcept { return _ladder.find(price); }
+
+private:
+    Ladder _ladder;
+};
+
+// Order-reference map plus per-book, per-side price levels. OrderMap maps
+// uint64_t references to Order through find/insert/erase returning value
+// pointers (see the adapters in bench_orderbook.cpp); Levels is one of the
+// price level containers above.
+template <class OrderMap, class Levels>
+class Book
+{
+public:
+    explicit Book(uint16_t books, int32_t tick = 100)
+      : _bounds(2 * size_t(books))
+      , _tick{ tick }
+    {
+        for (uint16_t b = 0; b < books; ++b) {
+            _levels.emplace_back(true, tick);
+            _levels.emplace_back(false, tick);
+        }
+    }
+
+    void apply(const Msg& m) noexcept
+    {
+        switch (m.type) {
+            case AddOrder:
+                _add(m.ref, m.book, m.side, m.price, m.shares);
+                break;
+            case OrderExecuted:
+            case OrderCancel:
+                _reduce(m.ref, m.shares);
+                break;
+            case OrderDelete:
+                _reduce(m.ref, UINT32_MAX);
+                break;
+            case OrderReplace:
+                _reduce(m.ref, UINT32_MAX);
+                _add(m.new_ref, m.book, m.side, m.price, m.shares);
+                break;
+        }
+    }
+
+    size_t orders() const noexcept { return _orders.size(); }
+    Levels& levels(uint16_t book, uint8_t side) noexcept
+    {
+        return _levels[2 * size_t(book) + side];
+    }
+
+    // Sum over all levels of shares, of price * shares and of the order
+    // count, to check that engines agree. Walks every tick each side has
+    // ever quoted, so call it outside the timed region.
+    uint64_t checksum() noexcept
+    {
+        uint64_t shares = 0;
+        uint64_t notional = 0;
+        uint64_t orders = 0;
+        for (size_t s = 0; s < _levels.size(); ++s) {
+            const Bounds& b = _bounds[s];
+            for (int64_t p = b.lo; p <= b.hi; p += _tick) {
+                const Level* l = _levels[s].level(int32_t(p));
+                if (!l)
+                    continue;
+                shares += l->shares;
+                notional += uint64_t(p) * l->shares;
+                orders += l->orders;
+            }
+        }
+        return shares + 31 * notional + 961 * orders + _orders.size();
+    }
+
+private:
+    void _add(uint64_t ref, uint16_t book, uint8_t side, int32_t price,
+              uint32_t shares) noexcept
+    {
+        *_orders.insert(ref) = Order{ price, shares, book, side };
+        levels(book, side).add(price, shares);
+        Bounds& b = _bounds[2 * size_t(book) + side];
+        b.lo = std::min(b.lo, int64_t(price));
+        b.hi = std::max(b.hi, int64_t(price));
+    }
+
+    void _reduce(uint64_t ref, uint32_t shares) noexcept
+    {
+        Order* o = _orders.find(ref);
+        const Order order = *o;
+        shares = std::min(shares, order.shares);
+        const bool last = shares == order.shares;
+        if (last)
+            _orders.erase(ref);
+        else
+            o->shares -= shares;
+        levels(order.book, order.side).remove(order.price, shares, last);
+    }
+
+    // Range of prices each side has quoted, for checksum().
+    struct Bounds
+    {
+        int64_t lo = INT64_MAX;
+        int64_t hi = INT64_MIN;
+    };
+
+    OrderMap _orders;
+    std::deque<Levels> _levels; // level containers need not be movable
+    std::vector<Bounds> _bounds;
+    int32_t _tick;
+};
+
+} // ~orderbook
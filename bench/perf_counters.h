@@ -0,0 +1,263 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Hardware performance counters for the benchmarks through
+// perf_event_open(2): instructions, cycles, branch mispredicts, last-level
+// cache misses, L1d read misses and dTLB read misses, counted in user space
+// for the calling thread only.
+//
+//     perf::Counters pc;
+//     pc.start();
+//     for (auto _ : state) {
+//         pc.pause_timing(state);   // instead of state.PauseTiming()
+//         ...
+//         pc.resume_timing(state);  // instead of state.ResumeTiming()
+//         ...
+//     }
+//     pc.stop();
+//     pc.report(state, ops);        // <event>/op user counters
+//
+// Each event is opened on its own rather than as a group, so a PMU with
+// fewer counters than events multiplexes them and the counts are scaled by
+// enabled/running time. Events the kernel or hardware refuses (no PMU in a
+// VM, perf_event_paranoid > 2, no permission) are skipped; with none open
+// report() adds nothing and the benchmark runs as before, with one note on
+// stderr per process. Set PLT_PERF_COUNTERS=0 to turn the counters off.
+
+namespace perf {
+
+enum Event
+{
+    Instructions,
+    Cycles,
+    BranchMisses,
+    CacheMisses,
+    L1dMisses,
+    DtlbMisses,
+    EventCount,
+};
+
+inline const char* eventName(Event e)
+{
+    switch (e) {
+        case Instructions:
+            return "instructions";
+        case Cycles:
+            return "cycles";
+        case BranchMisses:
+            return "branch-misses";
+        case CacheMisses:
+            return "cache-misses";
+        case L1dMisses:
+            return "L1d-misses";
+        case DtlbMisses:
+            return "dTLB-misses";
+        case EventCount:
+            break;
+    }
+    return "";
+}
+
+class Counters
+{
+public:
+    Counters() noexcept
+    {
+        for (int e = 0; e < EventCount; ++e)
+            _fds[e] = _open(Event(e));
+        if (!available())
+            _warn_once();
+    }
+
+    Counters(const Counters&) = delete;
+    Counters& operator=(const Counters&) = delete;
+
+    ~Counters() noexcept
+    {
+#if defined(__linux__)
+        for (int fd : _fds) {
+            if (fd >= 0)
+                close(fd);
+        }
+#endif
+    }
+
+    bool available() const noexcept
+    {
+        for (int fd : _fds) {
+            if (fd >= 0)
+                return true;
+        }
+        return false;
+    }
+
+    bool available(Event e) const noexcept { return _fds[e] >= 0; }
+
+    // Counting accumulates across start()/stop() pairs until reset().
+#if defined(__linux__)
+    void start() noexcept { _ioctl(PERF_EVENT_IOC_ENABLE); }
+    void stop() noexcept { _ioctl(PERF_EVENT_IOC_DISABLE); }
+    void reset() noexcept { _ioctl(PERF_EVENT_IOC_RESET); }
+#else
+    void start() noexcept {}
+    void stop() noexcept {}
+    void reset() noexcept {}
+#endif
+
+    void pause_timing(benchmark::State& state) noexcept
+    {
+        stop();
+        state.PauseTiming();
+    }
+
+    void resume_timing(benchmark::State& state) noexcept
+    {
+        state.ResumeTiming();
+        start();
+    }
+
+    // Count of `e` so far, scaled for multiplexing; 0 if unavailable.
+    double value(Event e) const noexcept
+    {
+#if defined(__linux__)
+        if (_fds[e] < 0)
+            return 0;
+        uint64_t buf[3]; // value, time enabled, time running
+        if (read(_fds[e], buf, sizeof(buf)) != ssize_t(sizeof(buf)) ||
+            buf[2] == 0)
+            return 0;
+        return double(buf[0]) * (double(buf[1]) / double(buf[2]));
+#else
+        (void)e;
+        return 0;
+#endif
+    }
+
+    // Adds <event>/op for every open event, and IPC with both instructions
+    // and cycles, to the benchmark's user counters.
+    void report(benchmark::State& state, double ops) const
+    {
+        if (ops <= 0)
+            return;
+        for (int e = 0; e < EventCount; ++e) {
+            if (_fds[e] >= 0)
+                state.counters[std::string(eventName(Event(e))) + "/op"] =
+                  value(Event(e)) / ops;
+        }
+        if (available(Instructions) && available(Cycles)) {
+            const double cycles = value(Cycles);
+            if (cycles > 0)
+                state.counters["IPC"] = value(Instructions) / cycles;
+        }
+    }
+
+private:
+    static bool _enabled() noexcept
+    {
+        const char* env = getenv("PLT_PERF_COUNTERS");
+        return !env || strcmp(env, "0") != 0;
+    }
+
+    static int _open(Event e) noexcept
+    {
+#if defined(__linux__)
+        if (!_enabled())
+            return -1;
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format =
+          PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        const auto cache = [](uint64_t id) {
+            return id | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                   (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        };
+        switch (e) {
+            case Instructions:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+                break;
+            case Cycles:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_CPU_CYCLES;
+                break;
+            case BranchMisses:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+                break;
+            case CacheMisses:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_CACHE_MISSES;
+                break;
+            case L1dMisses:
+                attr.type = PERF_TYPE_HW_CACHE;
+                attr.config = cache(PERF_COUNT_HW_CACHE_L1D);
+                break;
+            case DtlbMisses:
+                attr.type = PERF_TYPE_HW_CACHE;
+                attr.config = cache(PERF_COUNT_HW_CACHE_DTLB);
+                break;
+            case EventCount:
+                return -1;
+        }
+        const long fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        if (fd < 0)
+            _last_errno() = errno;
+        return int(fd);
+#else
+        (void)e;
+        return -1;
+#endif
+    }
+
+    void _ioctl(unsigned long request) noexcept
+    {
+#if defined(__linux__)
+        for (int fd : _fds) {
+            if (fd >= 0)
+                ioctl(fd, request, 0);
+        }
+#endif
+        (void)request;
+    }
+
+    static int& _last_errno() noexcept
+    {
+        static int err = 0;
+        return err;
+    }
+
+    static void _warn_once() noexcept
+    {
+        static bool warned = false;
+        if (warned)
+            return;
+        warned = true;
+        if (!_enabled())
+            return;
+        fprintf(stderr,
+                "perf: hardware counters unavailable (%s); "
+                "running without them\n",
+                _last_errno() ? strerror(_last_errno()) : "unsupported");
+    }
+
+    int _fds[EventCount];
+};
+
+} // ~perf
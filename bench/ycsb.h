@@ -0,0 +1,271 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <vector>
+
+// YCSB-style key-value workloads for the tables: an operation mix drawn
+// over a key distribution, generated up front as a stream of (operation,
+// key) pairs so the timed replay does nothing but table operations.
+//
+// Records are identified by dense IDs 0, 1, 2, ... in insertion order and
+// stored under a scrambled 64-bit key, as YCSB does with hashed insert
+// order, so the tables see no sequential pattern.
+
+namespace ycsb {
+
+enum OpType : uint8_t
+{
+    Read,
+    Update,
+    Insert,
+    Erase,
+    ReadModifyWrite,
+    Scan, // one point read of a scan
+};
+
+struct Op
+{
+    uint64_t key;
+    OpType type;
+};
+
+// Operation proportions; they need not sum to 1.
+struct Mix
+{
+    const char* name;
+    double read;
+    double update;
+    double insert;
+    double erase;
+    double rmw;
+    double scan;
+};
+
+// The YCSB core workloads. Hash tables cannot range scan, so E reads the
+// records of a scan one at a time, in ID order.
+inline const Mix coreMixes[] = {
+    { "A", 0.50, 0.50, 0, 0, 0, 0 }, // update heavy
+    { "B", 0.95, 0.05, 0, 0, 0, 0 }, // read mostly
+    { "C", 1.00, 0, 0, 0, 0, 0 },    // read only
+    { "D", 0.95, 0, 0.05, 0, 0, 0 }, // read latest
+    { "E", 0, 0, 0.05, 0, 0, 0.95 }, // short ranges
+    { "F", 0.50, 0, 0, 0, 0.50, 0 }, // read-modify-write
+    // Not a YCSB workload: the table keeps turning over.
+    { "churn", 0.50, 0, 0.25, 0.25, 0, 0 },
+};
+
+enum class Distribution
+{
+    Uniform,
+    Zipfian,
+    Latest,
+    Hotspot,
+};
+
+inline const char* distributionName(Distribution d)
+{
+    switch (d) {
+        case Distribution::Uniform:
+            return "uniform";
+        case Distribution::Zipfian:
+            return "zipfian";
+        case Distribution::Latest:
+            return "latest";
+        case Distribution::Hotspot:
+            return "hotspot";
+    }
+    return "";
+}
+
+struct Params
+{
+    size_t records = size_t(1) << 20; // loaded before the timed run
+    size_t ops = size_t(1) << 20;
+    double theta = 0.99;   // Zipfian skew
+    double hot_data = 0.2; // Hotspot: this fraction of the records
+    double hot_ops = 0.8;  // gets this fraction of the accesses
+    size_t max_scan = 10;  // scan lengths are uniform in [1, max_scan]
+    uint64_t seed = 1;
+};
+
+// Bijective, so distinct IDs give distinct keys.
+inline uint64_t record_key(uint64_t id) noexcept
+{
+    id ^= id >> 30;
+    id *= 0xbf58476d1ce4e5b9u;
+    id ^= id >> 27;
+    id *= 0x94d049bb133111ebu;
+    id ^= id >> 31;
+    return id;
+}
+
+// Zipfian ranks in [0, n), rank 0 the most popular, after Gray et al.,
+// "Quickly Generating Billion-Record Synthetic Databases", as in YCSB. The
+// item count can grow; zeta(n) is extended incrementally.
+class Zipfian
+{
+public:
+    Zipfian(uint64_t n, double theta) noexcept
+      : _theta{ theta }, _alpha{ 1.0 / (1.0 - theta) },
+        _zeta2{ 1.0 + std::pow(0.5, theta) }
+    {
+        grow(n);
+    }
+
+    void grow(uint64_t n) noexcept
+    {
+        for (; _n < n; ++_n)
+            _zetan += 1.0 / std::pow(double(_n + 1), _theta);
+        _eta = (1.0 - std::pow(2.0 / double(_n), 1.0 - _theta)) /
+               (1.0 - _zeta2 / _zetan);
+    }
+
+    uint64_t n() const noexcept { return _n; }
+
+    template <class Gen>
+    uint64_t operator()(Gen& gen) noexcept
+    {
+        const double u = std::uniform_real_distribution<double>(0, 1)(gen);
+        const double uz = u * _zetan;
+        if (uz < 1.0)
+            return 0;
+        if (uz < _zeta2)
+            return 1;
+        const auto r =
+          uint64_t(double(_n) * std::pow(_eta * u - _eta + 1.0, _alpha));
+        return r < _n ? r : _n - 1;
+    }
+
+private:
+    double _theta;
+    double _alpha;
+    double _zeta2;
+    double _zetan = 0;
+    double _eta = 0;
+    uint64_t _n = 0;
+};
+
+// Picks record IDs in [0, n) for the current record count n.
+class KeyChooser
+{
+public:
+    KeyChooser(Distribution d, const Params& p) noexcept
+      : _dist{ d }, _zipf{ p.records, p.theta }, _hot_data{ p.hot_data },
+        _hot_ops{ p.hot_ops }
+    {
+    }
+
+    template <class Gen>
+    uint64_t operator()(Gen& gen, uint64_t n) noexcept
+    {
+        switch (_dist) {
+            case Distribution::Uniform:
+                return std::uniform_int_distribution<uint64_t>(0, n - 1)(gen);
+            case Distribution::Zipfian:
+                // Scrambled, so the popular records are spread over the IDs.
+                return record_key(_zipfian(gen, n)) % n;
+            case Distribution::Latest:
+                return n - 1 - _zipfian(gen, n);
+            case Distribution::Hotspot: {
+                using uniform = std::uniform_int_distribution<uint64_t>;
+                const auto hot = std::max<uint64_t>(1, uint64_t(_hot_data * n));
+                std::uniform_real_distribution<double> u(0, 1);
+                if (u(gen) < _hot_ops || hot == n)
+                    return uniform(0, hot - 1)(gen);
+                return uniform(hot, n - 1)(gen);
+            }
+        }
+        return 0;
+    }
+
+private:
+    template <class Gen>
+    uint64_t _zipfian(Gen& gen, uint64_t n) noexcept
+    {
+        if (n > _zipf.n())
+            _zipf.grow(n);
+        uint64_t r;
+        do {
+            r = _zipf(gen);
+        } while (r >= n);
+        return r;
+    }
+
+    Distribution _dist;
+    Zipfian _zipf;
+    double _hot_data;
+    double _hot_ops;
+};
+
+// The operation stream for one run: p.ops operations (scans count one per
+// record read) after p.records initial inserts of IDs [0, records). Inserts
+// take the next ID.
+inline std::vector<Op> generate(const Mix& mix, Distribution d,
+                                const Params& p)
+{
+    std::mt19937_64 gen(p.seed);
+    KeyChooser choose(d, p);
+    const double weights[] = { mix.read, mix.update, mix.insert,
+                               mix.erase, mix.rmw,   mix.scan };
+    std::discrete_distribution<int> pick(std::begin(weights),
+                                         std::end(weights));
+    std::uniform_int_distribution<size_t> scan_len(1, p.max_scan);
+    uint64_t n = p.records;
+    std::vector<Op> ops;
+    ops.reserve(p.ops);
+    while (ops.size() < p.ops) {
+        const auto type = OpType(pick(gen));
+        if (type == Insert) {
+            ops.push_back({ record_key(n++), Insert });
+        } else if (type == Scan) {
+            const uint64_t first = choose(gen, n);
+            const size_t len = scan_len(gen);
+            for (uint64_t id = first; id < n && id < first + len; ++id)
+                ops.push_back({ record_key(id), Scan });
+        } else {
+            ops.push_back({ record_key(choose(gen, n)), type });
+        }
+    }
+    ops.resize(p.ops);
+    return ops;
+}
+
+// Runs the stream against a table adapter (see adapters.h) holding
+// uint64_t values. Returns the number of reads that found their record.
+template <class Map>
+size_t replay(Map& map, const std::vector<Op>& ops) noexcept
+{
+    size_t hits = 0;
+    for (const Op& op : ops) {
+        switch (op.type) {
+            case Read:
+            case Scan:
+                hits += map.find(op.key) != nullptr;
+                break;
+            case Update:
+                if (auto* v = map.find(op.key))
+                    *v = op.key;
+                break;
+            case Insert:
+                *map.insert(op.key) = op.key;
+                break;
+            case Erase:
+                map.erase(op.key);
+                break;
+            case ReadModifyWrite:
+                if (auto* v = map.find(op.key)) {
+                    ++hits;
+                    *v += 1;
+                }
+                break;
+        }
+    }
+    return hits;
+}
+
+} // ~ycsb
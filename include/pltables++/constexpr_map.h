@@ -0,0 +1,222 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace plt {
+
+// Seeded hashes usable in constant expressions (std::hash is not constexpr).
+// Integers and enums are mixed with the splitmix64 finalizer, strings are
+// FNV-1a folded into it.
+template <class Key, class = void>
+struct constexpr_hash;
+
+constexpr uint64_t constexpr_mix(uint64_t x, uint64_t seed) noexcept
+{
+    x += (seed + 1) * 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+template <class Key>
+struct constexpr_hash<
+  Key, std::enable_if_t<std::is_integral_v<Key> || std::is_enum_v<Key>>>
+{
+    constexpr uint64_t operator()(Key key, uint64_t seed) const noexcept
+    {
+        if constexpr (std::is_enum_v<Key>)
+            return constexpr_mix(
+              static_cast<uint64_t>(static_cast<std::underlying_type_t<Key>>(key)),
+              seed);
+        else
+            return constexpr_mix(static_cast<uint64_t>(key), seed);
+    }
+};
+
+template <>
+struct constexpr_hash<std::string_view>
+{
+    constexpr uint64_t operator()(std::string_view key,
+                                  uint64_t seed) const noexcept
+    {
+        uint64_t h = 14695981039346656037ull;
+        for (char c : key) {
+            h ^= static_cast<unsigned char>(c);
+            h *= 1099511628211ull;
+        }
+        return constexpr_mix(h, seed);
+    }
+};
+
+} // ~plt
+
+// Immutable map whose contents are fixed at compile time.
+//
+//     constexpr constexpr_map venues{ std::array{
+//         std::pair{ 1, 'N' }, std::pair{ 4, 'Q' }, ... } };
+//
+// The constructor searches, at compile time, for a hash seed that puts every
+// key in its own slot of a power-of-2 index with 4x as many slots as keys;
+// find() is then a hash and one compare. If no seed within SeedTries is
+// collision-free (large N) it keeps the seed with the shortest linear-probing
+// displacement and find() scans at most max_probe() + 1 slots.
+//
+// Keys known at compile time need no runtime hashing at all: see
+// constexpr_lookup() below.
+template <class Key, class T, size_t N,
+          class Hash = plt::constexpr_hash<Key>,
+          class KeyEq = std::equal_to<>>
+class constexpr_map
+{
+    static_assert(N > 0, "constexpr_map needs at least one entry");
+    // The seed search is bounded by the work the compiler's constexpr
+    // evaluator has to do, roughly SearchBudget slot writes.
+    constexpr static size_t SearchBudget = size_t(1) << 15;
+
+    static constexpr size_t _roundup_pow_2(size_t x) noexcept
+    {
+        size_t n = 8;
+        while (n < x)
+            n *= 2;
+        return n;
+    }
+
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<Key, T>;
+    using const_iterator = const value_type*;
+    using index_type = std::conditional_t<
+      N < UINT8_MAX, uint8_t,
+      std::conditional_t<N < UINT16_MAX, uint16_t, uint32_t>>;
+
+    constexpr static size_t SlotCount = _roundup_pow_2(4 * N);
+    constexpr static size_t Mask = SlotCount - 1;
+    constexpr static size_t SeedTries =
+      std::max<size_t>(1, std::min<size_t>(1024, SearchBudget / SlotCount));
+
+    constexpr explicit constexpr_map(
+      const std::array<value_type, N>& items) noexcept
+      : _items{ items }
+    {
+        for (size_t i = 0; i < N; ++i)
+            for (size_t j = i + 1; j < N; ++j)
+                if (KeyEq{}(_items[i].first, _items[j].first))
+                    _duplicate_key();
+
+        size_t best = SlotCount;
+        for (uint64_t seed = 0; seed < SeedTries && best != 0; ++seed) {
+            const size_t probe = _place(seed, best);
+            if (probe < best) {
+                best = probe;
+                _seed = seed;
+            }
+        }
+        _max_probe = _place(_seed, SlotCount);
+    }
+
+    constexpr size_t size() const noexcept { return N; }
+    constexpr bool empty() const noexcept { return false; }
+    constexpr uint64_t seed() const noexcept { return _seed; }
+    // Slots find() may look at beyond the home slot; 0 for a perfect hash.
+    constexpr size_t max_probe() const noexcept { return _max_probe; }
+    // Everything lives in the object; nothing is allocated.
+    constexpr size_t memory_usage() const noexcept { return sizeof(*this); }
+
+    constexpr const_iterator begin() const noexcept { return _items.data(); }
+    constexpr const_iterator end() const noexcept
+    {
+        return _items.data() + N;
+    }
+
+    // Position of `key` in the initializer array, or size() if absent.
+    constexpr size_t index_of(const Key& key) const noexcept
+    {
+        size_t i = Hash{}(key, _seed) & Mask;
+        for (size_t d = 0; d <= _max_probe; ++d) {
+            const size_t s = _slots[i];
+            if (s == 0)
+                break;
+            if (KeyEq{}(_items[s - 1].first, key))
+                return s - 1;
+            i = (i + 1) & Mask;
+        }
+        return N;
+    }
+
+    constexpr const_iterator find(const Key& key) const noexcept
+    {
+        return begin() + index_of(key);
+    }
+
+    constexpr bool contains(const Key& key) const noexcept
+    {
+        return index_of(key) != N;
+    }
+
+    constexpr const value_type& at_index(size_t i) const noexcept
+    {
+        return _items[i];
+    }
+
+private:
+    static void _duplicate_key() noexcept
+    {
+        // Not constexpr: reaching this while constant-evaluating is a compile
+        // error, which is the point.
+        assert(false && "constexpr_map: duplicate key");
+    }
+
+    // Fill _slots with linear probing under `seed`; returns the longest
+    // displacement from a home slot, or `limit` as soon as it is reached.
+    constexpr size_t _place(uint64_t seed, size_t limit) noexcept
+    {
+        for (size_t i = 0; i < SlotCount; ++i)
+            _slots[i] = 0;
+        size_t longest = 0;
+        for (size_t k = 0; k < N; ++k) {
+            size_t i = Hash{}(_items[k].first, seed) & Mask;
+            size_t d = 0;
+            while (_slots[i] != 0) {
+                i = (i + 1) & Mask;
+                if (++d >= limit)
+                    return limit;
+            }
+            _slots[i] = static_cast<index_type>(k + 1);
+            longest = d > longest ? d : longest;
+        }
+        return longest;
+    }
+
+    std::array<value_type, N> _items;
+    // 1 + index into _items, 0 = empty.
+    std::array<index_type, SlotCount> _slots{};
+    uint64_t _seed = 0;
+    size_t _max_probe = 0;
+};
+
+template <class Key, class T, size_t N>
+constexpr_map(const std::array<std::pair<Key, T>, N>&)
+  -> constexpr_map<Key, T, N>;
+
+// Lookup of a key known at compile time in a map with static storage
+// duration: the slot is resolved during compilation, so this compiles to a
+// load of the value. A missing key is a compile error.
+//
+//     static constexpr constexpr_map venues{ ... };
+//     char v = constexpr_lookup<venues, 4>();
+template <const auto& Map, auto K>
+constexpr const auto& constexpr_lookup() noexcept
+{
+    constexpr size_t i = Map.index_of(K);
+    static_assert(i != Map.size(), "key is not in the map");
+    return Map.at_index(i).second;
+}
@@ -0,0 +1,403 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <pltables++/linear_open_address.h>
+#include <type_traits>
+#include <utility>
+
+// Integer-keyed map that stores dense key ranges as a direct-mapped array.
+//
+// While the keys are sparse it is a loatable. Once it holds at least
+// DirectMinSize entries spanning a range at least DenseLoad full, the values
+// move into an array indexed by `key - base()` with a presence bitmap, and a
+// lookup is a subtraction, a bit test and a load. Inserts outside the window
+// re-center it on the live keys (sequential IDs retiring at the bottom and
+// arriving at the top keep a window about the size of the live range); when
+// the entries fill less than SparseLoad of the window it goes back to hashing.
+//
+// Not copyable or movable.
+template <class Key, class T, class Hash = std::hash<Key>,
+          class KeyEq = std::equal_to<Key>,
+          class Alloc = loa_default_allocator>
+class dense_loatable : private Alloc
+{
+    static_assert(std::is_integral_v<Key>, "dense_loatable needs integer keys");
+    using ukey = std::make_unsigned_t<Key>;
+
+public:
+    using table_type = loatable<Key, T, Hash, KeyEq, Alloc>;
+    using key_type = Key;
+    using mapped_type = T;
+    using InsertResult = typename table_type::InsertResult;
+    class iterator;
+
+    // Entries below which the map always hashes.
+    constexpr static size_t DirectMinSize = 64;
+    // Hashed -> direct when size() >= DenseLoad * (max - min + 1).
+    constexpr static double DenseLoad = 0.5;
+    // Direct -> hashed when size() < SparseLoad * span().
+    constexpr static double SparseLoad = 0.125;
+
+    static bool insert_failed(InsertResult r) noexcept
+    {
+        return table_type::insert_failed(r);
+    }
+    static bool item_inserted(InsertResult r) noexcept
+    {
+        return table_type::item_inserted(r);
+    }
+
+    dense_loatable() noexcept = default;
+    dense_loatable(const dense_loatable&) = delete;
+    dense_loatable& operator=(const dense_loatable&) = delete;
+    ~dense_loatable() noexcept { _free_direct(); }
+
+    void clear() noexcept
+    {
+        _free_direct();
+        _table.clear();
+        _next_check = DirectMinSize;
+    }
+
+    bool is_direct() const noexcept { return _bits != nullptr; }
+    size_t size() const noexcept
+    {
+        return is_direct() ? _size : _table.size();
+    }
+    bool empty() const noexcept { return size() == 0u; }
+    // Key stored at slot 0 of the direct array, and its slot count.
+    key_type base() const noexcept { return _base; }
+    size_t span() const noexcept { return _span; }
+
+    // Bytes held by the map, slack included: the hash table while hashing,
+    // the bitmap and value array while direct (see loatable::memory_usage).
+    size_t memory_usage() const noexcept
+    {
+        const Alloc& alloc = *this;
+        return sizeof(*this) - sizeof(_table) + _table.memory_usage() +
+               plt::allocated_bytes(alloc, _bits, _span / 64, sizeof(*_bits)) +
+               plt::allocated_bytes(alloc, _vals, _span, sizeof(T));
+    }
+
+    iterator begin() noexcept
+    {
+        if (!is_direct())
+            return iterator{ _table.begin() };
+        return iterator{ this, _next_live(0) };
+    }
+    iterator end() noexcept
+    {
+        return is_direct() ? iterator{ this, _span } : iterator{ _table.end() };
+    }
+
+    iterator find(const key_type& key) noexcept
+    {
+        if (!is_direct())
+            return iterator{ _table.find(key) };
+        const size_t i = _offset(key);
+        return iterator{ this, i < _span && _test(i) ? i : _span };
+    }
+
+    bool contains(const key_type& key) noexcept { return find(key) != end(); }
+
+    template <class... Args>
+    std::pair<iterator, InsertResult> insert(const key_type& key,
+                                             Args&&... args) noexcept
+    {
+        if (!is_direct())
+            return _insert_hashed(key, std::forward<Args>(args)...);
+        size_t i = _offset(key);
+        if (i >= _span) {
+            if (!_recenter(key))
+                return std::make_pair(end(), InsertResult::Error);
+            if (!is_direct())
+                return _insert_hashed(key, std::forward<Args>(args)...);
+            i = _offset(key);
+        }
+        if (_test(i))
+            return std::make_pair(iterator{ this, i }, InsertResult::Present);
+        new (&_vals[i]) T(std::forward<Args>(args)...);
+        _bits[i / 64] |= uint64_t(1) << (i % 64);
+        ++_size;
+        return std::make_pair(iterator{ this, i }, InsertResult::Inserted);
+    }
+
+    size_t erase(const key_type& key) noexcept
+    {
+        if (!is_direct())
+            return _table.erase(key);
+        const size_t i = _offset(key);
+        if (i >= _span || !_test(i))
+            return 0u;
+        _vals[i].~T();
+        _bits[i / 64] &= ~(uint64_t(1) << (i % 64));
+        --_size;
+        if (_size < _span * SparseLoad && _span > DirectMinSize)
+            _to_hashed(); // on failure the direct array simply stays
+        return 1u;
+    }
+
+private:
+    size_t _offset(const key_type& key) const noexcept
+    {
+        return size_t(ukey(ukey(key) - ukey(_base)));
+    }
+    key_type _key_at(size_t i) const noexcept
+    {
+        return key_type(ukey(ukey(_base) + ukey(i)));
+    }
+    bool _test(size_t i) const noexcept
+    {
+        return (_bits[i / 64] >> (i % 64)) & 1u;
+    }
+    // First live slot at or after `i`, or _span.
+    size_t _next_live(size_t i) const noexcept
+    {
+        if (i >= _span)
+            return _span;
+        size_t w = i / 64;
+        uint64_t word = _bits[w] & (~uint64_t(0) << (i % 64));
+        while (word == 0) {
+            if (++w == _span / 64)
+                return _span;
+            word = _bits[w];
+        }
+        return w * 64 + size_t(__builtin_ctzll(word));
+    }
+    size_t _prev_live(size_t i) const noexcept
+    {
+        size_t w = i / 64;
+        uint64_t word = _bits[w] & (~uint64_t(0) >> (63 - i % 64));
+        while (word == 0)
+            word = _bits[--w];
+        return w * 64 + 63 - size_t(__builtin_clzll(word));
+    }
+
+    // Window for `n` keys with at least n / 2 slots of headroom, so a
+    // window sliding by one key at a time is rebuilt every n / 2 inserts.
+    static size_t _window_span(size_t n) noexcept
+    {
+        n += n / 2;
+        size_t s = DirectMinSize;
+        while (s < n)
+            s *= 2;
+        return s;
+    }
+
+    template <class... Args>
+    std::pair<iterator, InsertResult> _insert_hashed(const key_type& key,
+                                                     Args&&... args) noexcept
+    {
+        auto r = _table.insert(key, std::forward<Args>(args)...);
+        if (r.second != InsertResult::Inserted &&
+            r.second != InsertResult::ReusedSlot)
+            return std::make_pair(iterator{ r.first }, r.second);
+        if (_table.size() == 1u || key < _min)
+            _min = key;
+        if (_table.size() == 1u || key > _max)
+            _max = key;
+        if (_table.size() >= DirectMinSize && _dense_enough() && _to_direct())
+            return std::make_pair(find(key), r.second);
+        return std::make_pair(iterator{ r.first }, r.second);
+    }
+
+    // _min and _max are not updated on erase; they are tightened with a
+    // rescan each time the size doubles, so a stale range cannot keep a dense
+    // map hashed for long.
+    bool _dense_enough() noexcept
+    {
+        auto dense = [this] {
+            const size_t range = size_t(ukey(ukey(_max) - ukey(_min))) + 1;
+            return range != 0 && _table.size() >= DenseLoad * range;
+        };
+        if (dense())
+            return true;
+        if (_table.size() < _next_check)
+            return false;
+        _next_check = 2 * _table.size();
+        auto it = _table.begin();
+        _min = _max = it.key();
+        for (; it != _table.end(); ++it) {
+            _min = std::min(_min, it.key());
+            _max = std::max(_max, it.key());
+        }
+        return dense();
+    }
+
+    bool _alloc_direct(size_t span, uint64_t*& bits, T*& vals) noexcept
+    {
+        Alloc& alloc = *this;
+        bits = static_cast<uint64_t*>(alloc.allocate(span / 64, sizeof(*bits)));
+        vals = static_cast<T*>(alloc.allocate(span, sizeof(T)));
+        if (!bits || !vals) {
+            if (bits)
+                alloc.deallocate(bits, span / 64, sizeof(*bits));
+            if (vals)
+                alloc.deallocate(vals, span, sizeof(T));
+            return false;
+        }
+        return true;
+    }
+
+    void _free_direct() noexcept
+    {
+        if (!_bits)
+            return;
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (size_t i = _next_live(0); i != _span; i = _next_live(i + 1))
+                _vals[i].~T();
+        }
+        Alloc& alloc = *this;
+        alloc.deallocate(_bits, _span / 64, sizeof(*_bits));
+        alloc.deallocate(_vals, _span, sizeof(T));
+        _bits = nullptr;
+        _vals = nullptr;
+        _span = _size = 0;
+    }
+
+    bool _to_direct() noexcept
+    {
+        const size_t range = size_t(ukey(ukey(_max) - ukey(_min))) + 1;
+        const size_t span = _window_span(range);
+        uint64_t* bits;
+        T* vals;
+        if (!_alloc_direct(span, bits, vals))
+            return false;
+        _base = _min;
+        _bits = bits;
+        _vals = vals;
+        _span = span;
+        _size = _table.size();
+        for (auto it = _table.begin(); it != _table.end(); ++it) {
+            const size_t i = _offset(it.key());
+            new (&_vals[i]) T(std::move(it.value()));
+            _bits[i / 64] |= uint64_t(1) << (i % 64);
+        }
+        _table.clear();
+        return true;
+    }
+
+    // Sized so that no insert below can grow the table. Should one fail
+    // anyway, the moved values are put back and the map stays direct.
+    bool _to_hashed() noexcept
+    {
+        if (!_table.reserve(size_t(_size / table_type::max_load_factor()) + 1))
+            return false;
+        bool first = true;
+        for (size_t i = _next_live(0); i != _span; i = _next_live(i + 1)) {
+            const key_type key = _key_at(i);
+            if (insert_failed(_table.insert(key, std::move(_vals[i])).second)) {
+                for (auto it = _table.begin(); it != _table.end(); ++it)
+                    _vals[_offset(it.key())] = std::move(it.value());
+                _table.clear();
+                return false;
+            }
+            if (first)
+                _min = key;
+            _max = key;
+            first = false;
+        }
+        _free_direct();
+        _next_check = std::max(DirectMinSize, 2 * _table.size());
+        return true;
+    }
+
+    // Move the window so that it covers the live keys and `key`, or switch
+    // to hashing if that window would be too sparse.
+    bool _recenter(const key_type& key) noexcept
+    {
+        key_type lo = key, hi = key;
+        if (_size != 0) {
+            lo = std::min(lo, _key_at(_next_live(0)));
+            hi = std::max(hi, _key_at(_prev_live(_span - 1)));
+        }
+        const size_t range = size_t(ukey(ukey(hi) - ukey(lo))) + 1;
+        if (range == 0 || _size + 1 < range * SparseLoad)
+            return _to_hashed();
+        const size_t span = _window_span(range);
+        uint64_t* bits;
+        T* vals;
+        if (!_alloc_direct(span, bits, vals))
+            return _to_hashed();
+        // Leave the headroom on the side the keys are moving towards.
+        const key_type base =
+          key == lo && _size != 0 ? key_type(ukey(ukey(hi) + 1 - ukey(span)))
+                                  : lo;
+        for (size_t i = _next_live(0); i != _span; i = _next_live(i + 1)) {
+            const size_t j = size_t(ukey(ukey(_key_at(i)) - ukey(base)));
+            new (&vals[j]) T(std::move(_vals[i]));
+            bits[j / 64] |= uint64_t(1) << (j % 64);
+        }
+        const size_t n = _size;
+        _free_direct();
+        _base = base;
+        _bits = bits;
+        _vals = vals;
+        _span = span;
+        _size = n;
+        return true;
+    }
+
+    table_type _table;
+    uint64_t* _bits = nullptr;
+    T* _vals = nullptr;
+    size_t _span = 0;
+    size_t _size = 0;
+    key_type _base = 0;
+    key_type _min = 0;
+    key_type _max = 0;
+    size_t _next_check = DirectMinSize;
+};
+
+template <class Key, class T, class Hash, class KeyEq, class Alloc>
+class dense_loatable<Key, T, Hash, KeyEq, Alloc>::iterator
+{
+    using table_iterator = typename table_type::iterator;
+    friend class dense_loatable;
+
+    constexpr iterator(dense_loatable* map, size_t i) noexcept
+      : _map{ map }, _index{ i }
+    {}
+    constexpr explicit iterator(table_iterator it) noexcept : _it{ it } {}
+
+public:
+    // By value: direct slots do not store their key.
+    key_type key() const noexcept
+    {
+        return _map ? _map->_key_at(_index) : _it.key();
+    }
+    mapped_type& value() const noexcept
+    {
+        return _map ? _map->_vals[_index] : _it.value();
+    }
+    mapped_type& val() const noexcept { return value(); }
+
+    iterator& operator++() noexcept
+    {
+        if (_map)
+            _index = _map->_next_live(_index + 1);
+        else
+            ++_it;
+        return *this;
+    }
+
+    friend bool operator==(const iterator& lhs, const iterator& rhs) noexcept
+    {
+        return lhs._map == rhs._map &&
+               (lhs._map ? lhs._index == rhs._index : lhs._it == rhs._it);
+    }
+    friend bool operator!=(const iterator& lhs, const iterator& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+
+private:
+    dense_loatable* _map = nullptr;
+    size_t _index = 0;
+    table_iterator _it{};
+};
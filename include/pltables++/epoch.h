@@ -0,0 +1,334 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <vector>
+
+namespace plt {
+
+// Epoch-based memory reclamation for concurrent tables.
+//
+// Readers bracket each access with enter()/exit() (or a Guard). A writer that
+// unlinks memory -- e.g. the old flag/key/value arrays after a resize --
+// hands it to retire() instead of freeing it; it is released once every
+// reader that could have seen it has left its critical section.
+//
+// Fast path: enter() is a relaxed load of the global epoch plus a plain store
+// to the reader's own cache line; exit() is a release store. No atomic RMW.
+// The StoreLoad ordering enter() needs is provided from the reclaimer side by
+// membarrier(2) when the kernel supports it; otherwise enter() falls back to
+// a full fence.
+//
+// Long-running readers may call quiescent() instead of exit()+enter() to
+// announce they no longer hold references (QSBR style).
+class EpochDomain
+{
+public:
+    using deleter_type = void (*)(void* ptr, size_t size);
+
+    // Retired objects are collected in per-thread batches; every BatchSize
+    // retires the participant tries to advance the epoch and free old batches,
+    // which bounds how long garbage can live while readers keep moving.
+    constexpr static size_t BatchSize = 64;
+
+    class Participant;
+    class Guard;
+
+    explicit EpochDomain(bool asymmetric = true) noexcept
+    {
+        _asymmetric = asymmetric && _membarrier_register();
+    }
+
+    EpochDomain(const EpochDomain&) = delete;
+    EpochDomain& operator=(const EpochDomain&) = delete;
+
+    ~EpochDomain() noexcept
+    {
+        assert(_records.empty() && "participants must leave before domain");
+        for (auto& r : _orphans)
+            r.fn(r.ptr, r.size);
+    }
+
+    uint64_t epoch() const noexcept
+    {
+        return _global.load(std::memory_order_acquire);
+    }
+
+    bool asymmetric() const noexcept { return _asymmetric; }
+
+    // Try to advance the global epoch and free everything orphaned by threads
+    // that have left. Returns the number of objects freed.
+    size_t reclaim() noexcept
+    {
+        std::lock_guard<std::mutex> lock{ _lock };
+        _try_advance_locked();
+        return _free_orphans_locked();
+    }
+
+    // Number of objects retired by departed participants not yet freed.
+    size_t pending_orphans() const noexcept
+    {
+        std::lock_guard<std::mutex> lock{ _lock };
+        return _orphans.size();
+    }
+
+private:
+    constexpr static uint64_t Active = 1;
+    constexpr static uint64_t EpochStep = 2;
+
+    struct Retired
+    {
+        void* ptr;
+        size_t size;
+        deleter_type fn;
+        uint64_t epoch;
+    };
+
+    struct alignas(64) Record
+    {
+        std::atomic<uint64_t> local{ 0 };
+    };
+
+    static bool _membarrier_register() noexcept
+    {
+#ifdef SYS_membarrier
+        constexpr int CmdPrivateExpedited = 1 << 3;
+        constexpr int CmdRegisterPrivateExpedited = 1 << 4;
+        long cmds = syscall(SYS_membarrier, 0 /* QUERY */, 0);
+        if (cmds < 0 || !(cmds & CmdPrivateExpedited))
+            return false;
+        return syscall(SYS_membarrier, CmdRegisterPrivateExpedited, 0) == 0;
+#else
+        return false;
+#endif
+    }
+
+    void _heavy_barrier() noexcept
+    {
+#ifdef SYS_membarrier
+        if (_asymmetric) {
+            constexpr int CmdPrivateExpedited = 1 << 3;
+            if (syscall(SYS_membarrier, CmdPrivateExpedited, 0) == 0)
+                return;
+        }
+#endif
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    Record* _add_record()
+    {
+        auto* rec = new Record{};
+        std::lock_guard<std::mutex> lock{ _lock };
+        _records.push_back(rec);
+        return rec;
+    }
+
+    // Hand a departing participant's garbage to the domain. Returns false,
+    // leaving `limbo` untouched, if the orphan list cannot grow.
+    bool _adopt_orphans(std::vector<Retired>& limbo) noexcept
+    {
+        std::lock_guard<std::mutex> lock{ _lock };
+        try {
+            _orphans.insert(_orphans.end(), limbo.begin(), limbo.end());
+        } catch (const std::bad_alloc&) {
+            return false;
+        }
+        limbo.clear();
+        return true;
+    }
+
+    void _remove_record(Record* rec) noexcept
+    {
+        std::lock_guard<std::mutex> lock{ _lock };
+        _records.erase(std::find(_records.begin(), _records.end(), rec));
+        delete rec;
+        _try_advance_locked();
+        _free_orphans_locked();
+    }
+
+    // An epoch can only advance once every active reader has observed the
+    // current one. Anything retired at epoch `e` is unreachable once the
+    // global epoch reaches `e + 2 * EpochStep`.
+    bool _try_advance_locked() noexcept
+    {
+        const uint64_t cur = _global.load(std::memory_order_relaxed);
+        _heavy_barrier();
+        for (Record* rec : _records) {
+            const uint64_t local = rec->local.load(std::memory_order_acquire);
+            if ((local & Active) && (local & ~Active) != cur)
+                return false;
+        }
+        _global.store(cur + EpochStep, std::memory_order_release);
+        return true;
+    }
+
+    static bool _is_safe(uint64_t retired, uint64_t global) noexcept
+    {
+        return global >= retired + 2 * EpochStep;
+    }
+
+    size_t _free_orphans_locked() noexcept
+    {
+        const uint64_t global = _global.load(std::memory_order_relaxed);
+        size_t n = 0;
+        auto it = std::remove_if(
+          _orphans.begin(), _orphans.end(), [&](const Retired& r) {
+              if (!_is_safe(r.epoch, global))
+                  return false;
+              r.fn(r.ptr, r.size);
+              ++n;
+              return true;
+          });
+        _orphans.erase(it, _orphans.end());
+        return n;
+    }
+
+    bool _try_advance() noexcept
+    {
+        std::lock_guard<std::mutex> lock{ _lock };
+        return _try_advance_locked();
+    }
+
+    std::atomic<uint64_t> _global{ 0 };
+    bool _asymmetric = false;
+    mutable std::mutex _lock;
+    std::vector<Record*> _records;
+    std::vector<Retired> _orphans;
+};
+
+// One per thread per domain. Not thread-safe itself.
+class EpochDomain::Participant
+{
+public:
+    explicit Participant(EpochDomain& domain)
+      : _domain{ &domain }
+      , _rec{ domain._add_record() }
+    {
+        try {
+            _limbo.reserve(BatchSize);
+        } catch (...) {
+            _domain->_remove_record(_rec);
+            throw;
+        }
+    }
+
+    Participant(const Participant&) = delete;
+    Participant& operator=(const Participant&) = delete;
+
+    // Leftover garbage is orphaned to the domain; if that needs memory that
+    // is not available, the destructor waits it out with synchronize().
+    ~Participant() noexcept
+    {
+        if (!_domain->_adopt_orphans(_limbo))
+            synchronize();
+        _domain->_remove_record(_rec);
+    }
+
+    void enter() noexcept
+    {
+        assert(!in_critical_section());
+        _announce();
+    }
+
+    void exit() noexcept
+    {
+        assert(in_critical_section());
+        _rec->local.store(0, std::memory_order_release);
+    }
+
+    // Equivalent to exit() followed by enter(): the caller holds no
+    // references obtained before this point.
+    void quiescent() noexcept { _announce(); }
+
+    bool in_critical_section() const noexcept
+    {
+        return (_rec->local.load(std::memory_order_relaxed) & Active) != 0;
+    }
+
+    // Defer `fn(ptr, size)` until no reader can still hold `ptr`. The limbo
+    // list grows BatchSize entries at a time; if that allocation throws
+    // std::bad_alloc, `ptr` is not retired and still belongs to the caller.
+    void retire(void* ptr, size_t size = 0,
+                deleter_type fn = &EpochDomain::Participant::_free)
+    {
+        if (!ptr)
+            return;
+        if (_limbo.size() == _limbo.capacity())
+            _limbo.reserve(_limbo.size() + BatchSize);
+        const uint64_t e = _domain->_global.load(std::memory_order_acquire);
+        _limbo.push_back(Retired{ ptr, size, fn, e });
+        if (_limbo.size() % BatchSize == 0)
+            collect();
+    }
+
+    // Try to advance the epoch and free this thread's eligible garbage.
+    // Returns the number of objects freed. Never allocates.
+    size_t collect() noexcept
+    {
+        _domain->_try_advance();
+        const uint64_t global = _domain->_global.load(std::memory_order_acquire);
+        size_t n = 0;
+        auto it = std::remove_if(
+          _limbo.begin(), _limbo.end(), [&](const Retired& r) {
+              if (!EpochDomain::_is_safe(r.epoch, global))
+                  return false;
+              r.fn(r.ptr, r.size);
+              ++n;
+              return true;
+          });
+        _limbo.erase(it, _limbo.end());
+        return n;
+    }
+
+    // Block until everything this thread retired has been freed. Must be
+    // called outside a critical section.
+    void synchronize() noexcept
+    {
+        assert(!in_critical_section());
+        while (!_limbo.empty())
+            collect();
+    }
+
+    size_t pending() const noexcept { return _limbo.size(); }
+
+    EpochDomain& domain() const noexcept { return *_domain; }
+
+private:
+    static void _free(void* ptr, size_t) noexcept { free(ptr); }
+
+    void _announce() noexcept
+    {
+        const uint64_t e = _domain->_global.load(std::memory_order_relaxed);
+        _rec->local.store(e | Active, std::memory_order_release);
+        if (_domain->_asymmetric)
+            std::atomic_signal_fence(std::memory_order_seq_cst);
+        else
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    EpochDomain* _domain;
+    Record* _rec;
+    std::vector<Retired> _limbo;
+};
+
+class EpochDomain::Guard
+{
+public:
+    explicit Guard(Participant& p) noexcept : _p{ p } { _p.enter(); }
+    Guard(const Guard&) = delete;
+    Guard& operator=(const Guard&) = delete;
+    ~Guard() noexcept { _p.exit(); }
+
+private:
+    Participant& _p;
+};
+
+} // ~plt
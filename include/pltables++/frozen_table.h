@@ -0,0 +1,605 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <pltables++/snapshot.h>
+#include <pltables++/thread_pool.h>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Immutable map over a fixed key set, indexed by a minimal perfect hash.
+//
+// The hash is BBHash-style: level l is a bit array of about gamma * |K_l|
+// bits; every key of K_l whose level-l position is not shared with another
+// key sets its bit, the colliding keys form K_{l+1}. A key's slot is the rank
+// of its bit among all levels, so the n keys and values fill arrays of exactly
+// n entries. Keys still colliding after MaxLevels levels (expected: none) go
+// to a small fallback list placed after the ranked ones.
+//
+// With the default gamma = 1 the bit arrays and rank samples take about
+// 3.1 bits per key and keys and values fill their arrays completely. A
+// lookup tests one bit per level it descends (about 2.7 on average; 1.6 with
+// gamma = 2 at ~3.7 bits per key), ranks it and compares a single key slot --
+// there is no probing. Keys outside the set are rejected by that compare.
+//
+// Built with freeze() or build(); may be saved to and mapped from a snapshot
+// file like loatable.
+template <class Key, class T, class Hash = std::hash<Key>,
+          class KeyEq = std::equal_to<Key>>
+class frozen_table : private Hash, private KeyEq
+{
+    static_assert(std::is_trivially_copyable_v<Key>,
+                  "Key type must satisfy TriviallyCopyable");
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "Mapped type must satisfy TriviallyCopyable");
+    constexpr static size_t MaxLevels = 32;
+    // One cumulative popcount per RankBlock bits.
+    constexpr static size_t RankBlock = 512;
+    constexpr static size_t WordsPerBlock = RankBlock / 64;
+    // Fixed work-unit size so the build does not depend on the pool size.
+    constexpr static size_t ChunkSize = 1 << 14;
+
+public:
+    class const_iterator;
+
+    using key_type = Key;
+    using mapped_type = T;
+    using hasher = Hash;
+    using key_equal = KeyEq;
+
+    constexpr static double DefaultGamma = 1.0;
+
+    frozen_table() noexcept = default;
+    explicit frozen_table(const hasher& hash,
+                          const key_equal& eq = key_equal()) noexcept
+      : Hash(hash)
+      , KeyEq(eq)
+    {
+    }
+    frozen_table(const frozen_table&) = delete;
+    frozen_table& operator=(const frozen_table&) = delete;
+    frozen_table(frozen_table&& other) noexcept { _take(other); }
+    frozen_table& operator=(frozen_table&& other) noexcept
+    {
+        if (this != &other) {
+            clear();
+            _take(other);
+        }
+        return *this;
+    }
+    ~frozen_table() noexcept { clear(); }
+
+    void clear() noexcept
+    {
+        plt::snapshot_unmap(_mapping, _mapping_bytes);
+        _mapping = nullptr;
+        _mapping_bytes = 0;
+        _own_levels.clear();
+        _own_bits.clear();
+        _own_ranks.clear();
+        _own_fallback.clear();
+        _own_keys.clear();
+        _own_vals.clear();
+        _levels = nullptr;
+        _bits = nullptr;
+        _ranks = nullptr;
+        _fallback = nullptr;
+        _keys = nullptr;
+        _vals = nullptr;
+        _size = _nlevels = _nwords = _nfallback = 0;
+    }
+
+    size_t size() const noexcept { return _size; }
+    bool empty() const noexcept { return _size == 0u; }
+    hasher hash_function() const noexcept { return *this; }
+    key_equal key_eq() const noexcept { return *this; }
+    size_t levels() const noexcept { return _nlevels; }
+
+    // Bits of hash metadata (level bit arrays, rank samples) per key.
+    double bits_per_key() const noexcept
+    {
+        if (_size == 0)
+            return 0.0;
+        // One rank sample per block plus the trailing total.
+        const size_t bits = 64 * (_nwords + _nblocks() + 1 + 2 * _nlevels);
+        return double(bits) / double(_size);
+    }
+
+    // Bytes held by the table: the object, the capacity of its arrays, or
+    // the whole mapping when loaded from a snapshot.
+    size_t memory_usage() const noexcept
+    {
+        if (_mapping)
+            return sizeof(*this) + _mapping_bytes;
+        return sizeof(*this) +
+               sizeof(uint64_t) * (_own_levels.capacity() +
+                                   _own_bits.capacity() +
+                                   _own_ranks.capacity()) +
+               sizeof(Key) *
+                 (_own_fallback.capacity() + _own_keys.capacity()) +
+               sizeof(T) * _own_vals.capacity();
+    }
+
+    // Replace the contents with keys[i] -> vals[i], i < n. Keys must be
+    // distinct. Larger gamma builds faster and descends fewer levels at the
+    // cost of more bits per key.
+    bool build(const Key* keys, const T* vals, size_t n, plt::ThreadPool& pool,
+               double gamma = DefaultGamma)
+    {
+        clear();
+        if (n == 0)
+            return true;
+        gamma = std::max(gamma, 0.5);
+
+        std::vector<_item> cur(n);
+        pool.parallel_for(_chunks(n), [&](size_t c) {
+            const size_t end = std::min(n, (c + 1) * ChunkSize);
+            auto hashfn = hash_function();
+            for (size_t i = c * ChunkSize; i < end; ++i)
+                cur[i] = _item{ static_cast<uint64_t>(hashfn(keys[i])), i };
+        });
+
+        // Global bit of every key placed by a level, ranked into a slot once
+        // all levels are known.
+        std::vector<uint64_t> placed_bit(n);
+        std::vector<_item> next;
+        std::vector<std::vector<_item>> chunk_next;
+        const bool shared = pool.size() > 1;
+        for (size_t l = 0; l < MaxLevels && !cur.empty(); ++l) {
+            const size_t m = _level_bits(cur.size(), gamma);
+            const size_t base = _own_bits.size();
+            _own_bits.resize(base + m / 64, 0);
+            std::vector<uint64_t> collide(m / 64, 0);
+            uint64_t* bits = _own_bits.data() + base;
+            const size_t nchunks = _chunks(cur.size());
+
+            pool.parallel_for(nchunks, [&](size_t c) {
+                const size_t end = std::min(cur.size(), (c + 1) * ChunkSize);
+                for (size_t k = c * ChunkSize; k < end; ++k) {
+                    const uint64_t p = _position(cur[k].h, l, m);
+                    const uint64_t b = uint64_t(1) << (p % 64);
+                    if (shared) {
+                        if (__atomic_fetch_or(&bits[p / 64], b,
+                                              __ATOMIC_RELAXED) &
+                            b)
+                            __atomic_fetch_or(&collide[p / 64], b,
+                                              __ATOMIC_RELAXED);
+                    } else {
+                        collide[p / 64] |= bits[p / 64] & b;
+                        bits[p / 64] |= b;
+                    }
+                }
+            });
+            for (size_t w = 0; w < m / 64; ++w)
+                bits[w] &= ~collide[w];
+
+            chunk_next.resize(nchunks);
+            pool.parallel_for(nchunks, [&](size_t c) {
+                const size_t end = std::min(cur.size(), (c + 1) * ChunkSize);
+                chunk_next[c].clear();
+                for (size_t k = c * ChunkSize; k < end; ++k) {
+                    const uint64_t p = _position(cur[k].h, l, m);
+                    if ((collide[p / 64] >> (p % 64)) & 1u)
+                        chunk_next[c].push_back(cur[k]);
+                    else
+                        placed_bit[cur[k].i] = 64 * base + p;
+                }
+            });
+            next.clear();
+            for (size_t c = 0; c < nchunks; ++c)
+                next.insert(next.end(), chunk_next[c].begin(),
+                            chunk_next[c].end());
+            _own_levels.push_back(base);
+            _own_levels.push_back(m);
+            cur.swap(next);
+        }
+
+        _own_ranks.resize((_own_bits.size() + WordsPerBlock - 1) /
+                            WordsPerBlock +
+                          1);
+        uint64_t total = 0;
+        for (size_t w = 0; w < _own_bits.size(); ++w) {
+            if (w % WordsPerBlock == 0)
+                _own_ranks[w / WordsPerBlock] = total;
+            total += __builtin_popcountll(_own_bits[w]);
+        }
+        _own_ranks.back() = total;
+        assert(total + cur.size() == n);
+
+        _own_fallback.resize(cur.size());
+        _own_keys.resize(n);
+        _own_vals.resize(n);
+        _levels = _own_levels.data();
+        _bits = _own_bits.data();
+        _ranks = _own_ranks.data();
+        _fallback = _own_fallback.data();
+        _keys = _own_keys.data();
+        _vals = _own_vals.data();
+        _size = n;
+        _nlevels = _own_levels.size() / 2;
+        _nwords = _own_bits.size();
+        _nfallback = cur.size();
+
+        Key* okeys = _own_keys.data();
+        T* ovals = _own_vals.data();
+        for (size_t j = 0; j < cur.size(); ++j) {
+            const size_t i = cur[j].i;
+            _own_fallback[j] = keys[i];
+            okeys[total + j] = keys[i];
+            ovals[total + j] = vals[i];
+            placed_bit[i] = UINT64_MAX;
+        }
+        pool.parallel_for(_chunks(n), [&](size_t c) {
+            const size_t end = std::min(n, (c + 1) * ChunkSize);
+            for (size_t i = c * ChunkSize; i < end; ++i) {
+                if (placed_bit[i] == UINT64_MAX)
+                    continue;
+                const size_t s = _rank(placed_bit[i]);
+                okeys[s] = keys[i];
+                ovals[s] = vals[i];
+            }
+        });
+        return true;
+    }
+
+    bool build(const Key* keys, const T* vals, size_t n, size_t nthreads = 1,
+               double gamma = DefaultGamma)
+    {
+        plt::ThreadPool pool{ nthreads };
+        return build(keys, vals, n, pool, gamma);
+    }
+
+    // Slot of `key` in [0, size()), or size() if it is not in the map.
+    size_t index_of(const key_type& key) const noexcept
+    {
+        if (_size == 0)
+            return 0;
+        const size_t s =
+          _slot(key, static_cast<uint64_t>(hash_function()(key)));
+        if (s < _size && key_eq()(key, _keys[s]))
+            return s;
+        return _size;
+    }
+
+    const_iterator find(const key_type& key) const noexcept
+    {
+        return { this, index_of(key) };
+    }
+
+    bool contains(const key_type& key) const noexcept
+    {
+        return index_of(key) != _size;
+    }
+
+    const_iterator begin() const noexcept { return { this, 0 }; }
+    const_iterator end() const noexcept { return { this, _size }; }
+
+    bool save(const char* path) const noexcept
+    {
+        auto hdr = _snapshot_header();
+        hdr.params[0] = _size;
+        hdr.params[1] = _nlevels;
+        hdr.params[2] = _nwords;
+        hdr.params[3] = _nfallback;
+        const void* data[] = { _levels, _bits, _ranks, _fallback, _keys, _vals };
+        const size_t bytes[] = { 2 * _nlevels * sizeof(uint64_t),
+                                 _nwords * sizeof(uint64_t),
+                                 _size ? (_nblocks() + 1) * sizeof(uint64_t)
+                                       : 0,
+                                 _nfallback * sizeof(Key),
+                                 _size * sizeof(Key),
+                                 _size * sizeof(T) };
+        return plt::snapshot_write(path, hdr, data, bytes, 6);
+    }
+
+    // Serve the map straight from a snapshot written by save(). The hash
+    // function id and seed must match: unlike loatable a frozen table cannot
+    // be repaired by a rehash, so a mismatch is refused.
+    bool load_mmap(const char* path,
+                   plt::SnapshotMode mode = plt::SnapshotMode::ReadOnly) noexcept
+    {
+        size_t bytes;
+        void* map = plt::snapshot_map(path, mode, bytes);
+        if (!map)
+            return false;
+        const auto& hdr = *static_cast<const plt::SnapshotHeader*>(map);
+        const auto ref = _snapshot_header();
+        const size_t n = hdr.params[0];
+        const size_t nlevels = hdr.params[1];
+        const size_t nwords = hdr.params[2];
+        const size_t nfallback = hdr.params[3];
+        const size_t nblocks = (nwords + WordsPerBlock - 1) / WordsPerBlock;
+        bool ok =
+          hdr.kind == ref.kind && hdr.key_size == ref.key_size &&
+          hdr.key_align == ref.key_align && hdr.val_size == ref.val_size &&
+          hdr.val_align == ref.val_align && hdr.hash_id == ref.hash_id &&
+          hdr.hash_seed == ref.hash_seed && hdr.nsections == 6 &&
+          nlevels <= MaxLevels && nfallback <= n &&
+          hdr.sections[0].bytes == 2 * nlevels * sizeof(uint64_t) &&
+          hdr.sections[1].bytes == nwords * sizeof(uint64_t) &&
+          hdr.sections[2].bytes == (n ? (nblocks + 1) * sizeof(uint64_t) : 0) &&
+          hdr.sections[3].bytes == nfallback * sizeof(Key) &&
+          hdr.sections[4].bytes == n * sizeof(Key) &&
+          hdr.sections[5].bytes == n * sizeof(T);
+        const char* base = static_cast<const char*>(map);
+        const auto* levels =
+          reinterpret_cast<const uint64_t*>(base + hdr.sections[0].offset);
+        for (size_t l = 0; ok && l < nlevels; ++l)
+            ok = levels[2 * l + 1] % 64 == 0 && levels[2 * l + 1] != 0 &&
+                 levels[2 * l] + levels[2 * l + 1] / 64 <= nwords;
+        if (!ok) {
+            plt::snapshot_unmap(map, bytes);
+            return false;
+        }
+        clear();
+        _mapping = map;
+        _mapping_bytes = bytes;
+        _levels = levels;
+        _bits =
+          reinterpret_cast<const uint64_t*>(base + hdr.sections[1].offset);
+        _ranks =
+          reinterpret_cast<const uint64_t*>(base + hdr.sections[2].offset);
+        _fallback =
+          reinterpret_cast<const Key*>(base + hdr.sections[3].offset);
+        _keys = reinterpret_cast<const Key*>(base + hdr.sections[4].offset);
+        _vals = reinterpret_cast<const T*>(base + hdr.sections[5].offset);
+        _size = n;
+        _nlevels = nlevels;
+        _nwords = nwords;
+        _nfallback = nfallback;
+        return true;
+    }
+
+private:
+    struct _item
+    {
+        uint64_t h;
+        size_t i;
+    };
+
+    static size_t _chunks(size_t n) noexcept
+    {
+        return (n + ChunkSize - 1) / ChunkSize;
+    }
+
+    static size_t _level_bits(size_t n, double gamma) noexcept
+    {
+        const size_t m = static_cast<size_t>(gamma * double(n)) + 1;
+        return (m + 63) / 64 * 64;
+    }
+
+    size_t _nblocks() const noexcept
+    {
+        return (_nwords + WordsPerBlock - 1) / WordsPerBlock;
+    }
+
+    // Independent position per level: a splitmix64 finalizer over the key's
+    // hash and the level, reduced to [0, m) by multiply-shift.
+    static uint64_t _position(uint64_t h, size_t level, uint64_t m) noexcept
+    {
+        h += (level + 1) * 0x9E3779B97F4A7C15ull;
+        h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ull;
+        h = (h ^ (h >> 27)) * 0x94d049bb133111ebull;
+        h ^= h >> 31;
+        return static_cast<uint64_t>((static_cast<__uint128_t>(h) * m) >> 64);
+    }
+
+    uint64_t _rank(uint64_t bit) const noexcept
+    {
+        const size_t w = bit / 64;
+        const size_t block = w / WordsPerBlock;
+        uint64_t r = _ranks[block];
+        for (size_t i = block * WordsPerBlock; i < w; ++i)
+            r += __builtin_popcountll(_bits[i]);
+        const uint64_t below = (uint64_t(1) << (bit % 64)) - 1;
+        return r + __builtin_popcountll(_bits[w] & below);
+    }
+
+    // Candidate slot for a key with hash `h`; the caller compares the key.
+    size_t _slot(const key_type& key, uint64_t h) const noexcept
+    {
+        for (size_t l = 0; l < _nlevels; ++l) {
+            const uint64_t m = _levels[2 * l + 1];
+            const uint64_t p = _position(h, l, m);
+            const uint64_t bit = 64 * _levels[2 * l] + p;
+            if ((_bits[bit / 64] >> (bit % 64)) & 1u)
+                return _rank(bit);
+        }
+        auto keyeq = key_eq();
+        const size_t ranked = _size - _nfallback;
+        for (size_t j = 0; j < _nfallback; ++j) {
+            if (keyeq(key, _fallback[j]))
+                return ranked + j;
+        }
+        return _size;
+    }
+
+    plt::SnapshotHeader _snapshot_header() const noexcept
+    {
+        auto hdr = plt::snapshot_header(plt::SnapshotKind::FrozenTable);
+        hdr.key_size = sizeof(key_type);
+        hdr.key_align = alignof(key_type);
+        hdr.val_size = sizeof(mapped_type);
+        hdr.val_align = alignof(mapped_type);
+        hdr.hash_id = plt::hash_identity<Hash>::id();
+        hdr.hash_seed = plt::hash_identity<Hash>::seed(hash_function());
+        return hdr;
+    }
+
+    void _take(frozen_table& other) noexcept
+    {
+        static_cast<Hash&>(*this) = static_cast<Hash&>(other);
+        static_cast<KeyEq&>(*this) = static_cast<KeyEq&>(other);
+        _own_levels.swap(other._own_levels);
+        _own_bits.swap(other._own_bits);
+        _own_ranks.swap(other._own_ranks);
+        _own_fallback.swap(other._own_fallback);
+        _own_keys.swap(other._own_keys);
+        _own_vals.swap(other._own_vals);
+        _mapping = std::exchange(other._mapping, nullptr);
+        _mapping_bytes = std::exchange(other._mapping_bytes, 0);
+        _levels = std::exchange(other._levels, nullptr);
+        _bits = std::exchange(other._bits, nullptr);
+        _ranks = std::exchange(other._ranks, nullptr);
+        _fallback = std::exchange(other._fallback, nullptr);
+        _keys = std::exchange(other._keys, nullptr);
+        _vals = std::exchange(other._vals, nullptr);
+        _size = std::exchange(other._size, 0);
+        _nlevels = std::exchange(other._nlevels, 0);
+        _nwords = std::exchange(other._nwords, 0);
+        _nfallback = std::exchange(other._nfallback, 0);
+    }
+
+private:
+    // Views used by lookups; point into the vectors below or the mapping.
+    // _levels holds (first word, bit count) per level.
+    const uint64_t* _levels = nullptr;
+    const uint64_t* _bits = nullptr;
+    const uint64_t* _ranks = nullptr;
+    const Key* _fallback = nullptr;
+    const Key* _keys = nullptr;
+    const T* _vals = nullptr;
+    size_t _size = 0;
+    size_t _nlevels = 0;
+    size_t _nwords = 0;
+    size_t _nfallback = 0;
+
+    std::vector<uint64_t> _own_levels;
+    std::vector<uint64_t> _own_bits;
+    std::vector<uint64_t> _own_ranks;
+    std::vector<Key> _own_fallback;
+    std::vector<Key> _own_keys;
+    std::vector<T> _own_vals;
+    void* _mapping = nullptr;
+    size_t _mapping_bytes = 0;
+};
+
+template <class Key, class T, class Hash, class KeyEq>
+class frozen_table<Key, T, Hash, KeyEq>::const_iterator
+{
+    using table_type = frozen_table<Key, T, Hash, KeyEq>;
+    friend table_type;
+    const table_type* _table = nullptr;
+    size_t _index = 0;
+
+public:
+    constexpr const_iterator() noexcept = default;
+
+    constexpr const_iterator(const table_type* table, size_t index) noexcept
+      : _table{ table }
+      , _index{ index }
+    {
+    }
+
+    const Key& key() const noexcept
+    {
+        assert(_index < _table->size());
+        return _table->_keys[_index];
+    }
+
+    const T& value() const noexcept
+    {
+        assert(_index < _table->size());
+        return _table->_vals[_index];
+    }
+
+    const T& val() const noexcept { return value(); }
+
+    const_iterator& operator++() noexcept
+    {
+        ++_index;
+        return *this;
+    }
+
+    const_iterator operator++(int) noexcept
+    {
+        const_iterator tmp = *this;
+        ++_index;
+        return tmp;
+    }
+
+    friend bool operator==(const_iterator lhs, const_iterator rhs) noexcept
+    {
+        return lhs._index == rhs._index && lhs._table == rhs._table;
+    }
+
+    friend bool operator!=(const_iterator lhs, const_iterator rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+};
+
+// Hasher and key comparison freeze() carries over from the source table:
+// its hash_function() / key_eq() when it has them, else std::hash and
+// std::equal_to.
+template <class Table, class Key, class = void>
+struct frozen_source_hash
+{
+    using type = std::hash<Key>;
+    static type get(const Table&) { return {}; }
+};
+
+template <class Table, class Key>
+struct frozen_source_hash<
+  Table, Key, std::void_t<decltype(std::declval<const Table&>().hash_function())>>
+{
+    using type = decltype(std::declval<const Table&>().hash_function());
+    static type get(const Table& t) { return t.hash_function(); }
+};
+
+template <class Table, class Key, class = void>
+struct frozen_source_keyeq
+{
+    using type = std::equal_to<Key>;
+    static type get(const Table&) { return {}; }
+};
+
+template <class Table, class Key>
+struct frozen_source_keyeq<
+  Table, Key, std::void_t<decltype(std::declval<const Table&>().key_eq())>>
+{
+    using type = decltype(std::declval<const Table&>().key_eq());
+    static type get(const Table& t) { return t.key_eq(); }
+};
+
+// Snapshot the current contents of any table with a key()/value() iterator
+// (loatable, klibtable, ...) into a frozen_table hashed with the source's
+// hasher. The source is not changed.
+template <class Table,
+          class Key = std::remove_cv_t<std::remove_reference_t<
+            decltype(std::declval<Table&>().begin().key())>>,
+          class T = std::remove_cv_t<std::remove_reference_t<
+            decltype(std::declval<Table&>().begin().value())>>,
+          class Hash = typename frozen_source_hash<Table, Key>::type,
+          class KeyEq = typename frozen_source_keyeq<Table, Key>::type>
+frozen_table<Key, T, Hash, KeyEq>
+freeze(Table& table, plt::ThreadPool& pool,
+       double gamma = frozen_table<Key, T>::DefaultGamma)
+{
+    std::vector<Key> keys;
+    std::vector<T> vals;
+    keys.reserve(table.size());
+    vals.reserve(table.size());
+    for (auto it = table.begin(); it != table.end(); ++it) {
+        keys.push_back(it.key());
+        vals.push_back(it.value());
+    }
+    frozen_table<Key, T, Hash, KeyEq> frozen{
+        frozen_source_hash<Table, Key>::get(table),
+        frozen_source_keyeq<Table, Key>::get(table)
+    };
+    frozen.build(keys.data(), vals.data(), keys.size(), pool, gamma);
+    return frozen;
+}
+
+template <class Table>
+auto freeze(Table& table, size_t nthreads = 1)
+{
+    plt::ThreadPool pool{ nthreads };
+    return freeze(table, pool);
+}
@@ -0,0 +1,198 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <pltables++/snapshot.h>
+#include <pltables/hash/batch.h>
+#include <pltables/hash/hash.h>
+#include <string_view>
+#include <type_traits>
+
+namespace plt {
+
+// The functions of pltables/hash as `Hash` parameters for the tables:
+//
+//     loatable<uint64_t, Order, plt::wy_hash> orders;
+//
+// Integral keys go through the algorithm's integer mixer and strings
+// (anything convertible to std::string_view) through its byte hash. The
+// tables index with `hash & mask`, so the low bits must be good: of these
+// only fibonacci_hash is a poor fit, kept for comparison. Their output does
+// not depend on the build, so snapshots written with one of them load
+// without a rehash wherever the library is used.
+template <class Algo>
+struct hasher
+{
+    template <class K,
+              std::enable_if_t<std::is_integral_v<K> || std::is_enum_v<K>,
+                               int> = 0>
+    size_t operator()(K key) const noexcept
+    {
+        return static_cast<size_t>(Algo::mix(static_cast<uint64_t>(key)));
+    }
+
+    size_t operator()(std::string_view s) const noexcept
+    {
+        return static_cast<size_t>(Algo::bytes(s.data(), s.size()));
+    }
+};
+
+namespace hash_algo {
+
+constexpr uint64_t _name_id(const char* s) noexcept
+{
+    uint64_t h = 14695981039346656037ull;
+    for (; *s; ++s) {
+        h ^= static_cast<unsigned char>(*s);
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+struct wang
+{
+    static constexpr uint64_t id = _name_id("plt::wang64");
+    static uint64_t mix(uint64_t k) noexcept { return plt_hash_wang64(k); }
+};
+
+struct fibonacci
+{
+    static constexpr uint64_t id = _name_id("plt::fibonacci64");
+    static uint64_t mix(uint64_t k) noexcept
+    {
+        return plt_hash_fibonacci64(k);
+    }
+};
+
+struct murmur3
+{
+    static constexpr uint64_t id = _name_id("plt::murmur3");
+    static uint64_t mix(uint64_t k) noexcept
+    {
+        return plt_hash_murmur3_fmix64(k);
+    }
+    static uint64_t bytes(const void* p, size_t n) noexcept
+    {
+        return plt_hash_murmur3_32(p, n, 0);
+    }
+};
+
+struct fnv1a
+{
+    static constexpr uint64_t id = _name_id("plt::fnv1a64");
+    static uint64_t mix(uint64_t k) noexcept
+    {
+        return plt_hash_fnv1a64(&k, sizeof(k), 0);
+    }
+    static uint64_t bytes(const void* p, size_t n) noexcept
+    {
+        return plt_hash_fnv1a64(p, n, 0);
+    }
+};
+
+struct wy
+{
+    static constexpr uint64_t id = _name_id("plt::wy");
+    static uint64_t mix(uint64_t k) noexcept { return plt_hash_wymix64(k); }
+    static uint64_t bytes(const void* p, size_t n) noexcept
+    {
+        return plt_hash_wy(p, n, 0);
+    }
+};
+
+struct crc32c
+{
+    static constexpr uint64_t id = _name_id("plt::crc32c");
+    static uint64_t mix(uint64_t k) noexcept
+    {
+        return plt_hash_crc32c_u64(k);
+    }
+    static uint64_t bytes(const void* p, size_t n) noexcept
+    {
+        return plt_hash_crc32c_u64(plt_crc32c(p, n, 0));
+    }
+};
+
+} // ~hash_algo
+
+using wang_hash = hasher<hash_algo::wang>;
+using fibonacci_hash = hasher<hash_algo::fibonacci>;
+using murmur3_hash = hasher<hash_algo::murmur3>;
+using fnv1a_hash = hasher<hash_algo::fnv1a>;
+using wy_hash = hasher<hash_algo::wy>;
+using crc32c_hash = hasher<hash_algo::crc32c>;
+
+template <class Algo>
+struct hash_identity<hasher<Algo>>
+{
+    static uint64_t id() noexcept { return Algo::id; }
+    static uint64_t seed(const hasher<Algo>&) noexcept { return 0; }
+};
+
+// Murmur3's finalizer at the key's width (fmix32 for keys of up to 4 bytes,
+// fmix64 for 8), with the batched form that loatable's find_batch() and
+// insert_batch() pick up: 8 or 16 keys per instruction on AVX2 or AVX-512.
+struct fmix_hash
+{
+    template <class K,
+              std::enable_if_t<(std::is_integral_v<K> || std::is_enum_v<K>) &&
+                                 sizeof(K) <= 8,
+                               int> = 0>
+    size_t operator()(K key) const noexcept
+    {
+        if constexpr (sizeof(K) <= 4)
+            return plt_hash_murmur3_fmix32(static_cast<uint32_t>(key));
+        else
+            return static_cast<size_t>(
+              plt_hash_murmur3_fmix64(static_cast<uint64_t>(key)));
+    }
+
+    // idx[j] = (*this)(keys[j]) & mask for j < n.
+    template <class K>
+    void hash_batch(const K* keys, size_t n, size_t mask,
+                    size_t* idx) const noexcept
+    {
+        constexpr size_t Chunk = 64;
+        if constexpr (_is_word<K, uint32_t>()) {
+            uint32_t out[Chunk];
+            const auto* k = reinterpret_cast<const uint32_t*>(keys);
+            for (size_t j = 0; j < n; j += Chunk) {
+                const size_t m = std::min(Chunk, n - j);
+                plt_hash_fmix32_batch(k + j, m, uint32_t(mask), out);
+                for (size_t i = 0; i < m; ++i)
+                    idx[j + i] = out[i];
+            }
+        } else if constexpr (_is_word<K, uint64_t>() &&
+                             std::is_same_v<size_t, uint64_t>) {
+            plt_hash_fmix64_batch(reinterpret_cast<const uint64_t*>(keys), n,
+                                  mask, reinterpret_cast<uint64_t*>(idx));
+        } else {
+            for (size_t j = 0; j < n; ++j)
+                idx[j] = (*this)(keys[j]) & mask;
+        }
+    }
+
+private:
+    // Keys the kernels may read in place: W itself or its signed twin.
+    template <class K, class W>
+    static constexpr bool _is_word() noexcept
+    {
+        if constexpr (std::is_integral_v<K>)
+            return std::is_same_v<std::make_unsigned_t<K>, W>;
+        else
+            return false;
+    }
+};
+
+template <>
+struct hash_identity<fmix_hash>
+{
+    static uint64_t id() noexcept
+    {
+        return hash_algo::_name_id("plt::fmix");
+    }
+    static uint64_t seed(const fmix_hash&) noexcept { return 0; }
+};
+
+} // ~plt
@@ -1,16 +1,92 @@
 #pragma once
 
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <cstdlib>
 #include <cstring>
+#include <cstdint>
 #include <functional>
+#include <new>
+#include <pltables++/memory.h>
+#include <pltables++/snapshot.h>
+#include <pltables++/thread_pool.h>
 #include <type_traits>
 #include <utility>
+#include <vector>
+
+// Default storage policy: mirrors `loacalloc` / `loafreearray` from the C
+// table. `allocate` must return zeroed memory.
+struct loa_default_allocator
+{
+    static void* allocate(size_t nmemb, size_t size) noexcept
+    {
+        return calloc(nmemb, size);
+    }
+    static void deallocate(void* ptr, size_t /*nmemb*/,
+                           size_t /*size*/) noexcept
+    {
+        free(ptr);
+    }
+    static size_t usable_size(const void* ptr, size_t nmemb,
+                              size_t size) noexcept
+    {
+        return plt::malloc_usable_bytes(ptr, nmemb * size);
+    }
+};
+
+// Storage policy for a fixed-capacity table whose arrays live inside the
+// table object (see static_loatable). Never allocates; the table reports
+// InsertResult::Error instead of growing.
+template <class Key, class T, size_t Capacity>
+struct loa_inline_storage
+{
+    static_assert(Capacity >= 8 && (Capacity & (Capacity - 1)) == 0,
+                  "Capacity must be a power of 2 no smaller than 8");
+    constexpr static size_t fixed_capacity = Capacity;
+
+    loa_inline_storage() noexcept = default;
+    // The table points into these arrays.
+    loa_inline_storage(const loa_inline_storage&) = delete;
+    loa_inline_storage& operator=(const loa_inline_storage&) = delete;
+
+    size_t* flags() noexcept { return _flags; }
+    Key* keys() noexcept { return reinterpret_cast<Key*>(_keys); }
+    T* vals() noexcept { return reinterpret_cast<T*>(_vals); }
+
+private:
+    size_t _flags[Capacity / sizeof(size_t)] = {};
+    alignas(Key) unsigned char _keys[Capacity * sizeof(Key)];
+    alignas(T) unsigned char _vals[Capacity * sizeof(T)];
+};
+
+template <class Alloc, class = void>
+struct loa_fixed_capacity : std::integral_constant<size_t, 0>
+{};
+
+template <class Alloc>
+struct loa_fixed_capacity<Alloc, std::void_t<decltype(Alloc::fixed_capacity)>>
+  : std::integral_constant<size_t, Alloc::fixed_capacity>
+{};
+
+// Whether Hash can compute many masked home slots in one call, as
+// plt::fmix_hash does with SIMD (used by find_batch() and insert_batch()).
+template <class Hash, class Key, class = void>
+struct loa_hash_batch : std::false_type
+{};
+
+template <class Hash, class Key>
+struct loa_hash_batch<
+  Hash, Key,
+  std::void_t<decltype(std::declval<const Hash&>().hash_batch(
+    std::declval<const Key*>(), size_t(), size_t(), std::declval<size_t*>()))>>
+  : std::true_type
+{};
 
 template <class Key, class T, class Hash = std::hash<Key>,
-          class KeyEq = std::equal_to<Key>>
-class loatable : private Hash, private KeyEq
+          class KeyEq = std::equal_to<Key>,
+          class Alloc = loa_default_allocator>
+class loatable : private Hash, private KeyEq, private Alloc
 {
     // require NoThrowConstructible as well?
     static_assert(std::is_nothrow_move_constructible_v<Key>);
@@ -25,6 +101,16 @@ class loatable : private Hash, private KeyEq
     //               "Mapped type must satisfy TriviallyCopyable");
     constexpr static double MaxLoadFactor = 0.77;
     constexpr static size_t MinTableSize = 8;
+    // Slicing of the table for build_parallel() and parallel resizes.
+    constexpr static size_t MinRegionSize = 4096;
+    constexpr static size_t MaxRegions = 1024;
+    // Below this many live entries a resize stays single-threaded even when a
+    // pool is configured: waking the pool costs more than the rehash.
+    constexpr static size_t ParallelResizeThreshold = 1 << 16;
+    // Non-zero when the arrays are inline in the storage policy.
+    constexpr static size_t FixedCapacity = loa_fixed_capacity<Alloc>::value;
+    // Keys hashed and prefetched together by find_batch()/insert_batch().
+    constexpr static size_t BatchBlock = 32;
 
 public:
     enum class InsertResult
@@ -53,8 +139,15 @@ public:
       std::pair<std::reference_wrapper<const Key>, std::reference_wrapper<T>>;
     using hasher = Hash;
     using key_equal = KeyEq;
+    using allocator_type = Alloc;
+    using pair_type = std::pair<Key, T>;
 
-    constexpr loatable() noexcept = default;
+    constexpr loatable() noexcept
+    {
+        if constexpr (FixedCapacity != 0)
+            _install_inline_arrays();
+    }
+    explicit loatable(const allocator_type& alloc) noexcept : Alloc(alloc) {}
     ~loatable() noexcept { clear(); }
     void clear() noexcept
     {
@@ -72,9 +165,12 @@ public:
             }
         }
         // clang-format on
-        free(_flags);
-        free(_keys);
-        free(_vals);
+        if constexpr (FixedCapacity != 0) {
+            memset(_flags, 0, _fsize(_asize) * sizeof(size_t));
+            _size = _used = 0;
+            return;
+        }
+        _free_arrays(_flags, _keys, _vals, _asize);
         _flags = nullptr;
         _keys = nullptr;
         _vals = nullptr;
@@ -82,24 +178,171 @@ public:
     }
     constexpr size_t capacity() const noexcept { return _asize; }
     constexpr size_t size() const noexcept { return _size; }
+
+    // Bytes held by the table: the object itself plus the flag, key and
+    // value arrays as reserved by the allocator, slack included. A table
+    // served from a snapshot counts the whole mapping.
+    size_t memory_usage() const noexcept
+    {
+        if constexpr (FixedCapacity != 0) {
+            return sizeof(*this);
+        } else {
+            if (_in_mapping(_flags))
+                return sizeof(*this) + _mapping_bytes;
+            const Alloc& alloc = *this;
+            return sizeof(*this) +
+                   plt::allocated_bytes(alloc, _flags, _fsize(_asize),
+                                        sizeof(size_t)) +
+                   plt::allocated_bytes(alloc, _keys, _asize,
+                                        sizeof(key_type)) +
+                   plt::allocated_bytes(alloc, _vals, _asize,
+                                        sizeof(mapped_type));
+        }
+    }
     constexpr bool empty() const noexcept { return _size == 0u; }
     hasher hash_function() const noexcept { return *this; }
     key_equal key_eq() const noexcept { return *this; }
+    allocator_type get_allocator() const noexcept { return *this; }
+    // Inserts grow the table once capacity() * max_load_factor() slots are
+    // used.
+    static constexpr double max_load_factor() noexcept { return MaxLoadFactor; }
 
     bool resize(size_t newsize)
     {
+        if constexpr (FixedCapacity != 0)
+            return newsize <= _cutoff;
         newsize = _roundup_pow_2(std::max(newsize, _cutoff + 1));
         return _resize_fast(newsize);
     }
 
+    // Rehash on `pool` when the table holds at least `threshold` entries.
+    // `pool` is not owned and must outlive the table (or be reset with
+    // nullptr). The layout after a parallel resize is the same for any pool
+    // size, but may differ from a serial one where clusters wrap past the
+    // end of the table.
+    void set_parallel_resize(plt::ThreadPool* pool,
+                             size_t threshold = ParallelResizeThreshold) noexcept
+    {
+        _pool = pool;
+        _parallel_threshold = threshold;
+    }
+
     bool reserve(size_t newsize)
     {
+        if constexpr (FixedCapacity != 0)
+            return newsize <= _cutoff;
         newsize = std::max(newsize, size_t(1));
         newsize = std::max(newsize, _asize);
         newsize = _roundup_pow_2(newsize);
         return _resize_fast(newsize);
     }
 
+    // Write the table's arrays to a snapshot file (see plt::snapshot_write).
+    // Keys and values must be trivially copyable.
+    bool save(const char* path) const noexcept
+    {
+        static_assert(std::is_trivially_copyable_v<Key> &&
+                        std::is_trivially_copyable_v<T>,
+                      "snapshots store keys and values as raw bytes");
+        auto hdr = _snapshot_header();
+        hdr.params[0] = _asize;
+        hdr.params[1] = _size;
+        hdr.params[2] = _used;
+        const void* data[] = { _flags, _keys, _vals };
+        const size_t bytes[] = { _fsize(_asize) * sizeof(size_t),
+                                 _asize * sizeof(key_type),
+                                 _asize * sizeof(mapped_type) };
+        return plt::snapshot_write(path, hdr, data, bytes, 3);
+    }
+
+    // Replace the contents of the table with a snapshot written by save().
+    // Lookups are served straight from the mapping; pages are faulted in on
+    // first touch. If the file was written with a different hash function or
+    // seed, the entries are rehashed into ordinary memory instead.
+    //
+    // ReadOnly: the table must not be modified (insert, erase, writes through
+    // iterators). CopyOnWrite: any modification is allowed and only touches
+    // private copies of the affected pages. Either way the mapping is
+    // released by clear(), by the destructor or when a resize moves the
+    // table elsewhere.
+    bool load_mmap(const char* path,
+                   plt::SnapshotMode mode = plt::SnapshotMode::ReadOnly) noexcept
+    {
+        static_assert(std::is_trivially_copyable_v<Key> &&
+                        std::is_trivially_copyable_v<T>,
+                      "snapshots store keys and values as raw bytes");
+        static_assert(FixedCapacity == 0, "inline tables cannot be mapped");
+        size_t bytes;
+        void* map = plt::snapshot_map(path, mode, bytes);
+        if (!map)
+            return false;
+        const auto& hdr = *static_cast<const plt::SnapshotHeader*>(map);
+        const auto ref = _snapshot_header();
+        const size_t asize = hdr.params[0];
+        const size_t size = hdr.params[1];
+        const size_t used = hdr.params[2];
+        const bool ok =
+          hdr.kind == ref.kind && hdr.key_size == ref.key_size &&
+          hdr.key_align == ref.key_align && hdr.val_size == ref.val_size &&
+          hdr.val_align == ref.val_align && hdr.nsections == 3 &&
+          (asize == 0 ||
+           (asize >= MinTableSize && (asize & (asize - 1)) == 0)) &&
+          size <= used && (asize == 0 || used < asize) &&
+          hdr.sections[0].bytes == _fsize(asize) * sizeof(size_t) &&
+          hdr.sections[1].bytes == asize * sizeof(key_type) &&
+          hdr.sections[2].bytes == asize * sizeof(mapped_type);
+        if (!ok) {
+            plt::snapshot_unmap(map, bytes);
+            return false;
+        }
+        clear();
+        if (asize == 0) {
+            plt::snapshot_unmap(map, bytes);
+            return true;
+        }
+        char* base = static_cast<char*>(map);
+        _flags = reinterpret_cast<size_t*>(base + hdr.sections[0].offset);
+        _keys = reinterpret_cast<key_type*>(base + hdr.sections[1].offset);
+        _vals = reinterpret_cast<mapped_type*>(base + hdr.sections[2].offset);
+        _mapping = map;
+        _mapping_bytes = bytes;
+        _readonly = mode == plt::SnapshotMode::ReadOnly;
+        _asize = asize;
+        _size = size;
+        _used = used;
+        _cutoff = asize * MaxLoadFactor;
+        if (hdr.hash_id != ref.hash_id || hdr.hash_seed != ref.hash_seed) {
+            if (!_resize_fast(std::max(asize, _roundup_pow_2(size + 1)))) {
+                clear();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // True while the arrays live in a snapshot mapping.
+    bool is_mapped() const noexcept { return _in_mapping(_flags); }
+
+    // Replace the contents of the table with [begin, end). If a key appears
+    // more than once the first occurrence wins, as with repeated insert().
+    bool build_parallel(const pair_type* begin, const pair_type* end,
+                        size_t nthreads)
+    {
+        plt::ThreadPool pool{ nthreads };
+        return build_parallel(begin, end, pool);
+    }
+
+    bool build_parallel(const pair_type* begin, const pair_type* end,
+                        plt::ThreadPool& pool)
+    {
+        static_assert(FixedCapacity == 0, "use insert() on inline tables");
+        assert(begin <= end);
+        const size_t n = static_cast<size_t>(end - begin);
+        if (n <= UINT32_MAX)
+            return _build_parallel<uint32_t>(begin, n, pool);
+        return _build_parallel<size_t>(begin, n, pool);
+    }
+
     constexpr const_iterator find(key_type key) const noexcept
     {
         return _cfind(key);
@@ -111,6 +354,48 @@ public:
         return { this, it._index };
     }
 
+    // Looks up every key in [begin, end), `out[j]` being find(begin[j]).
+    // Keys go BatchBlock at a time: the block's home slots are computed
+    // first, with one hash_batch() call when the hasher has it, and their
+    // flags and keys prefetched before any is probed, so the cache misses of
+    // a block overlap instead of queueing behind each other.
+    void find_batch(const key_type* begin, const key_type* end,
+                    const_iterator* out) const noexcept
+    {
+        if (!_flags) {
+            for (; begin != end; ++begin)
+                *out++ = this->end();
+            return;
+        }
+        size_t idx[BatchBlock];
+        while (begin != end) {
+            const size_t m = std::min<size_t>(BatchBlock, end - begin);
+            _home_slots(begin, m, idx);
+            for (size_t j = 0; j < m; ++j) {
+                __builtin_prefetch(&_flags[idx[j] / sizeof(size_t)]);
+                __builtin_prefetch(&_keys[idx[j]]);
+            }
+            for (size_t j = 0; j < m; ++j)
+                out[j] = _cfind_from(idx[j], begin[j]);
+            begin += m;
+            out += m;
+        }
+    }
+
+    void find_batch(const key_type* begin, const key_type* end,
+                    iterator* out) noexcept
+    {
+        const_iterator its[BatchBlock];
+        while (begin != end) {
+            const size_t m = std::min<size_t>(BatchBlock, end - begin);
+            std::as_const(*this).find_batch(begin, begin + m, its);
+            for (size_t j = 0; j < m; ++j)
+                out[j] = iterator{ this, its[j]._index };
+            begin += m;
+            out += m;
+        }
+    }
+
     constexpr iterator begin() noexcept
     {
         size_t i;
@@ -144,20 +429,86 @@ public:
     insert(key_type key, Args&&... args) noexcept(
       std::is_nothrow_constructible_v<Key>&& std::is_nothrow_constructible_v<T>)
     {
-        if (_used >= _cutoff)
-            if (!_resize_fast(_size != 0u ? 2u * _asize : MinTableSize))
+        assert(!_is_readonly_mapping());
+        if (_used >= _cutoff) {
+            if constexpr (FixedCapacity != 0) {
+                if (_size != _used)
+                    _purge_tombstones();
+                if (_used >= _cutoff) {
+                    auto it = find(key);
+                    return std::make_pair(it, it != end()
+                                                ? InsertResult::Present
+                                                : InsertResult::Error);
+                }
+            } else if (!_resize_fast(_size != 0u ? 2u * _asize : MinTableSize))
                 return std::make_pair(end(), InsertResult::Error);
+        }
         assert(_asize > _size);
-        const size_t mask = _asize - 1;
+        return _insert_from(hash_function()(key) & _mask(), key,
+                            std::forward<Args>(args)...);
+    }
+
+    // Inserts every pair in [begin, end) as insert(key, value) would, in
+    // order, storing each outcome in `results[j]` when given. Blocks are
+    // hashed and prefetched as in find_batch(); a block that could fill the
+    // table goes through insert() one pair at a time so it can grow.
+    // Returns false if any insert failed.
+    bool insert_batch(const pair_type* begin, const pair_type* end,
+                      InsertResult* results = nullptr) noexcept(
+      noexcept(insert(std::declval<key_type>(),
+                      std::declval<const mapped_type&>())))
+    {
+        assert(!_is_readonly_mapping());
+        bool ok = true;
+        size_t idx[BatchBlock];
+        while (begin != end) {
+            const size_t m = std::min<size_t>(BatchBlock, end - begin);
+            const bool fits = _used + m < _cutoff;
+            if (fits) {
+                _home_slots(begin, m, idx);
+                for (size_t j = 0; j < m; ++j) {
+                    __builtin_prefetch(&_flags[idx[j] / sizeof(size_t)], 1);
+                    __builtin_prefetch(&_keys[idx[j]], 1);
+                }
+            }
+            for (size_t j = 0; j < m; ++j) {
+                const InsertResult r =
+                  fits ? _insert_from(idx[j], begin[j].first, begin[j].second)
+                           .second
+                       : insert(begin[j].first, begin[j].second).second;
+                ok &= !insert_failed(r);
+                if (results)
+                    *results++ = r;
+            }
+            begin += m;
+        }
+        return ok;
+    }
+
+private:
+    // The probe of insert(), from home slot `i`, once there is room.
+    template <class... Args>
+    std::pair<iterator, InsertResult>
+    _insert_from(size_t i, key_type key, Args&&... args) noexcept(
+      std::is_nothrow_constructible_v<Key>&& std::is_nothrow_constructible_v<T>)
+    {
+        const size_t mask = _mask();
         auto* flags = _flags;
         auto* keys = _keys;
         auto* vals = _vals;
         auto keyeq = key_eq();
-        size_t i = hash_function()(key) & mask;
+        size_t reuse = SIZE_MAX;
         for (;;) {
-            if (!_is_alive(flags, i)) {
-                auto result = _is_tombstone(flags, i) ? InsertResult::ReusedSlot
-                                                      : InsertResult::Inserted;
+            if (_is_tombstone(flags, i)) {
+                // The key may still be further along the probe path.
+                if (reuse == SIZE_MAX)
+                    reuse = i;
+            } else if (!_is_alive(flags, i)) {
+                auto result = InsertResult::Inserted;
+                if (reuse != SIZE_MAX) {
+                    i = reuse;
+                    result = InsertResult::ReusedSlot;
+                }
                 new (&keys[i]) Key{ key };
                 try {
                     new (&vals[i]) T(std::forward<Args>(args)...);
@@ -169,7 +520,7 @@ public:
                 }
                 _animate(flags, i);
                 ++_size;
-                ++_used;
+                _used += result == InsertResult::Inserted;
                 return std::make_pair(iterator{ this, i }, result);
             } else if (keyeq(key, keys[i])) {
                 return std::make_pair(iterator{ this, i },
@@ -180,9 +531,16 @@ public:
         __builtin_unreachable();
     }
 
+public:
     constexpr void erase(const_iterator it) noexcept
     {
         assert(it != end());
+        assert(!_is_readonly_mapping());
+        if constexpr (!std::is_trivially_destructible_v<Key> ||
+                      !std::is_trivially_destructible_v<T>) {
+            _keys[it._index].~Key();
+            _vals[it._index].~T();
+        }
         _set_tombstone(_flags, it._index);
         --_size;
     }
@@ -198,14 +556,19 @@ public:
 
 private:
     constexpr const_iterator _cfind(key_type key) const noexcept
+    {
+        if (!_flags) // TODO: always allocate?
+            return end();
+        return _cfind_from(hash_function()(key) & _mask(), key);
+    }
+
+    constexpr const_iterator _cfind_from(size_t i,
+                                         key_type key) const noexcept
     {
         const auto* flags = _flags;
         const auto* keys = _keys;
-        const size_t mask = _asize - 1;
+        const size_t mask = _mask();
         auto keyeq = key_eq();
-        size_t i = hash_function()(key) & mask;
-        if (!_flags) // TODO: always allocate?
-            return end();
         for (;;) {
             if (_is_alive(flags, i)) {
                 if (keyeq(key, keys[i]))
@@ -218,6 +581,227 @@ private:
         return { this, _asize };
     }
 
+    // Parallel fill of freshly allocated arrays. The new table is split into
+    // 2^k regions of consecutive slots (k depends only on `asize`). Items are
+    // radix-partitioned, stably, by the region of their home slot and each
+    // region is filled by one thread with probes that stop at the region's
+    // end. Items whose probe runs off the end are returned in `spill`, in
+    // region order, for the caller to insert serially once the arrays are
+    // installed; that threads chains across region boundaries (and the wrap)
+    // exactly as sequential inserts would. The resulting layout does not
+    // depend on the number of threads.
+    //
+    // All scratch is allocated before the first item is constructed, so a
+    // std::bad_alloc leaves `src` and the new arrays untouched.
+    //
+    // `Source` provides: chunks(), chunk_begin(c) / chunk_end(c) over item
+    // indices, live(i), key(i), and construct(i, key*, val*).
+    template <class Index, class Source>
+    size_t _fill_regions(plt::ThreadPool& pool, const Source& src,
+                         size_t asize, size_t* flgs, key_type* keys,
+                         mapped_type* vals, std::vector<Index>& spill)
+    {
+        const size_t mask = asize - 1;
+        size_t nregions = 1;
+        while (nregions < MaxRegions && asize / (2 * nregions) >= MinRegionSize)
+            nregions *= 2;
+        const unsigned shift =
+          __builtin_ctzll(asize) - __builtin_ctzll(nregions);
+        const size_t nchunks = src.chunks();
+
+        std::vector<size_t> offsets(nchunks * nregions, 0);
+        pool.parallel_for(nchunks, [&](size_t c) {
+            auto hashfn = hash_function();
+            size_t* hist = &offsets[c * nregions];
+            for (size_t i = src.chunk_begin(c); i < src.chunk_end(c); ++i) {
+                if (src.live(i))
+                    ++hist[(hashfn(src.key(i)) & mask) >> shift];
+            }
+        });
+        std::vector<size_t> region_begin(nregions + 1);
+        size_t total = 0;
+        for (size_t r = 0; r < nregions; ++r) {
+            region_begin[r] = total;
+            for (size_t c = 0; c < nchunks; ++c) {
+                const size_t count = offsets[c * nregions + r];
+                offsets[c * nregions + r] = total;
+                total += count;
+            }
+        }
+        region_begin[nregions] = total;
+
+        std::vector<Index> order(total);
+        pool.parallel_for(nchunks, [&](size_t c) {
+            auto hashfn = hash_function();
+            size_t* next = &offsets[c * nregions];
+            for (size_t i = src.chunk_begin(c); i < src.chunk_end(c); ++i) {
+                if (src.live(i))
+                    order[next[(hashfn(src.key(i)) & mask) >> shift]++] = i;
+            }
+        });
+
+        // A region's overflow is packed at the front of its own run of
+        // `order`, behind the read position.
+        std::vector<size_t> placed(nregions, 0);
+        std::vector<size_t> spilled(nregions, 0);
+        pool.parallel_for(nregions, [&](size_t r) {
+            auto hashfn = hash_function();
+            auto keyeq = key_eq();
+            const size_t hi = (r + 1) << shift;
+            size_t count = 0;
+            size_t nspill = 0;
+            for (size_t k = region_begin[r]; k < region_begin[r + 1]; ++k) {
+                const Index item = order[k];
+                const key_type& key = src.key(item);
+                size_t i = hashfn(key) & mask;
+                for (;;) {
+                    if (i == hi) {
+                        order[region_begin[r] + nspill++] = item;
+                        break;
+                    } else if (!_is_alive(flgs, i)) {
+                        src.construct(item, &keys[i], &vals[i]);
+                        _set_live(flgs, i);
+                        ++count;
+                        break;
+                    } else if (keyeq(key, keys[i])) {
+                        break;
+                    }
+                    ++i;
+                }
+            }
+            placed[r] = count;
+            spilled[r] = nspill;
+        });
+
+        size_t n = 0;
+        size_t out = 0;
+        for (size_t r = 0; r < nregions; ++r) {
+            n += placed[r];
+            for (size_t k = 0; k < spilled[r]; ++k)
+                order[out++] = order[region_begin[r] + k];
+        }
+        order.resize(out);
+        spill.swap(order);
+        return n;
+    }
+
+    struct _pair_source
+    {
+        const pair_type* data;
+        size_t n;
+        size_t nchunks;
+
+        size_t chunks() const noexcept { return nchunks; }
+        size_t chunk_begin(size_t c) const noexcept { return n * c / nchunks; }
+        size_t chunk_end(size_t c) const noexcept
+        {
+            return n * (c + 1) / nchunks;
+        }
+        bool live(size_t) const noexcept { return true; }
+        const key_type& key(size_t i) const noexcept { return data[i].first; }
+        void construct(size_t i, key_type* k, mapped_type* v) const
+        {
+            new (k) Key{ data[i].first };
+            new (v) T(data[i].second);
+        }
+    };
+
+    struct _table_source
+    {
+        const size_t* flags;
+        key_type* keys;
+        mapped_type* vals;
+        size_t asize;
+        size_t nchunks;
+
+        size_t chunks() const noexcept { return nchunks; }
+        size_t chunk_begin(size_t c) const noexcept
+        {
+            return asize * c / nchunks;
+        }
+        size_t chunk_end(size_t c) const noexcept
+        {
+            return asize * (c + 1) / nchunks;
+        }
+        bool live(size_t i) const noexcept { return _is_alive(flags, i); }
+        const key_type& key(size_t i) const noexcept { return keys[i]; }
+        void construct(size_t i, key_type* k, mapped_type* v) const noexcept
+        {
+            new (k) Key{ std::move(keys[i]) };
+            new (v) T{ std::move(vals[i]) };
+        }
+    };
+
+    template <class Index>
+    bool _build_parallel(const pair_type* data, size_t n,
+                         plt::ThreadPool& pool)
+    {
+        clear();
+        if (n == 0)
+            return true;
+        size_t asize = _roundup_pow_2(n);
+        while (static_cast<size_t>(asize * MaxLoadFactor) <= n)
+            asize *= 2;
+        size_t* flgs;
+        key_type* keys;
+        mapped_type* vals;
+        if (!_alloc_arrays(asize, flgs, keys, vals))
+            return false;
+        std::vector<Index> spill;
+        const _pair_source src{ data, n, pool.size() };
+        size_t placed;
+        try {
+            placed = _fill_regions(pool, src, asize, flgs, keys, vals, spill);
+        } catch (const std::bad_alloc&) {
+            _free_arrays(flgs, keys, vals, asize);
+            return false;
+        }
+        _flags = flgs;
+        _keys = keys;
+        _vals = vals;
+        _asize = asize;
+        _cutoff = asize * MaxLoadFactor;
+        _size = _used = placed;
+        for (Index i : spill)
+            insert(data[i].first, data[i].second);
+        return true;
+    }
+
+    // Parallel counterpart of the rehash loop in _resize_fast(). Stripes of
+    // the old table are scanned concurrently and the moved entries land in
+    // the same places whatever the pool size. Returns false, with nothing
+    // moved, if the scratch space cannot be allocated.
+    template <class Index>
+    bool _rehash_parallel(size_t* flgs, key_type* keys, mapped_type* vals,
+                          size_t newsize) noexcept
+    {
+        auto* oldflgs = _flags;
+        auto* oldkeys = _keys;
+        auto* oldvals = _vals;
+        const auto oldasize = _asize;
+        std::vector<Index> spill;
+        const _table_source src{ oldflgs, oldkeys, oldvals, oldasize,
+                                 _pool->size() };
+        size_t placed;
+        try {
+            placed =
+              _fill_regions(*_pool, src, newsize, flgs, keys, vals, spill);
+        } catch (const std::bad_alloc&) {
+            return false;
+        }
+        _flags = flgs;
+        _keys = keys;
+        _vals = vals;
+        _asize = newsize;
+        _cutoff = newsize * MaxLoadFactor;
+        _size = _used = placed;
+        for (Index i : spill)
+            insert(std::move(oldkeys[i]), std::move(oldvals[i]));
+        assert(_size == _used);
+        _free_arrays(oldflgs, oldkeys, oldvals, oldasize);
+        return true;
+    }
+
     static constexpr size_t _roundup_pow_2(size_t x) noexcept
     {
         x = std::max(x, MinTableSize);
@@ -236,22 +820,25 @@ private:
         assert(newsize != 0);
         assert((newsize & (newsize - 1)) == 0); // table size must be power of 2
         assert(newsize * MaxLoadFactor > _size);
-        auto* flgs =
-          static_cast<size_t*>(calloc(newsize / sizeof(*flgs), sizeof(*flgs)));
-        auto* keys = static_cast<key_type*>(calloc(newsize, sizeof(key_type)));
-        auto* vals =
-          static_cast<mapped_type*>(calloc(newsize, sizeof(mapped_type)));
-        if (!flgs || !keys || !vals) {
-            free(flgs);
-            free(keys);
-            free(vals);
+        size_t* flgs;
+        key_type* keys;
+        mapped_type* vals;
+        if (!_alloc_arrays(newsize, flgs, keys, vals))
             return false;
+        // Falls through to the serial rehash if the parallel one cannot get
+        // its scratch space.
+        if (_pool && _pool->size() > 1 && _size >= _parallel_threshold) {
+            const bool done =
+              _asize <= UINT32_MAX
+                ? _rehash_parallel<uint32_t>(flgs, keys, vals, newsize)
+                : _rehash_parallel<size_t>(flgs, keys, vals, newsize);
+            if (done)
+                return true;
         }
         auto hashfn = hash_function();
         const auto* oldflgs = _flags;
-        const auto* oldkeys = _keys;
-        const auto* oldvals = _vals;
-        const auto oldasize = _asize;
+        auto* oldkeys = _keys;
+        auto* oldvals = _vals;
         const size_t mask = newsize - 1;
         for (size_t i = 0; i < _asize; ++i) {
             if (!_is_alive(oldflgs, i))
@@ -273,9 +860,7 @@ private:
             // clang-format on
             _set_live(flgs, j);
         }
-        free(_flags);
-        free(_keys);
-        free(_vals);
+        _free_arrays(_flags, _keys, _vals, _asize);
         _flags = flgs;
         _keys = keys;
         _vals = vals;
@@ -285,6 +870,168 @@ private:
         return true;
     }
 
+    // Masked home slots of the first `m` keys, m <= BatchBlock.
+    void _home_slots(const key_type* keys, size_t m,
+                     size_t* idx) const noexcept
+    {
+        const size_t mask = _mask();
+        if constexpr (loa_hash_batch<Hash, Key>::value) {
+            hash_function().hash_batch(keys, m, mask, idx);
+        } else {
+            auto hashfn = hash_function();
+            for (size_t j = 0; j < m; ++j)
+                idx[j] = hashfn(keys[j]) & mask;
+        }
+    }
+
+    void _home_slots(const pair_type* pairs, size_t m,
+                     size_t* idx) const noexcept
+    {
+        if constexpr (loa_hash_batch<Hash, Key>::value &&
+                      std::is_trivial_v<Key>) {
+            key_type keys[BatchBlock];
+            for (size_t j = 0; j < m; ++j)
+                keys[j] = pairs[j].first;
+            _home_slots(keys, m, idx);
+        } else {
+            const size_t mask = _mask();
+            auto hashfn = hash_function();
+            for (size_t j = 0; j < m; ++j)
+                idx[j] = hashfn(pairs[j].first) & mask;
+        }
+    }
+
+    // Compile-time constant for inline tables.
+    constexpr size_t _mask() const noexcept
+    {
+        if constexpr (FixedCapacity != 0)
+            return FixedCapacity - 1;
+        else
+            return _asize - 1;
+    }
+
+    void _install_inline_arrays() noexcept
+    {
+        Alloc& storage = *this;
+        _flags = storage.flags();
+        _keys = storage.keys();
+        _vals = storage.vals();
+        _asize = FixedCapacity;
+        _cutoff = FixedCapacity * MaxLoadFactor;
+    }
+
+    // Inline tables cannot grow out of their tombstones, so they are cleared
+    // in place: walking from a never-used slot, every live entry moves back to
+    // the first free slot on its probe path. Entries before it are final and
+    // the ones after only ever vacate later slots, so probe paths stay intact.
+    void _purge_tombstones() noexcept
+    {
+        const size_t mask = _mask();
+        // No probe path crosses a slot that was never used.
+        size_t start = 0;
+        while (!_is_dead(_flags, start))
+            ++start;
+        for (size_t i = 0; i <= mask; ++i)
+            if (_is_tombstone(_flags, i))
+                _set_dead(_flags, i);
+        auto hash = hash_function();
+        for (size_t n = 1; n <= mask; ++n) {
+            const size_t i = (start + n) & mask;
+            if (!_is_alive(_flags, i))
+                continue;
+            size_t j = hash(_keys[i]) & mask;
+            while (j != i && _is_alive(_flags, j))
+                j = (j + 1) & mask;
+            if (j == i)
+                continue;
+            new (&_keys[j]) Key(std::move(_keys[i]));
+            new (&_vals[j]) T(std::move(_vals[i]));
+            _keys[i].~Key();
+            _vals[i].~T();
+            _set_live(_flags, j);
+            _set_dead(_flags, i);
+        }
+        _used = _size;
+    }
+
+    static constexpr size_t _fsize(size_t asize) noexcept
+    {
+        return asize / sizeof(size_t);
+    }
+
+    bool _alloc_arrays(size_t asize, size_t*& flgs, key_type*& keys,
+                       mapped_type*& vals) noexcept
+    {
+        if constexpr (FixedCapacity != 0) {
+            (void)asize;
+            flgs = nullptr;
+            keys = nullptr;
+            vals = nullptr;
+            return false;
+        } else {
+            Alloc& alloc = *this;
+            flgs = static_cast<size_t*>(
+              alloc.allocate(_fsize(asize), sizeof(*flgs)));
+            keys =
+              static_cast<key_type*>(alloc.allocate(asize, sizeof(key_type)));
+            vals = static_cast<mapped_type*>(
+              alloc.allocate(asize, sizeof(mapped_type)));
+            if (!flgs || !keys || !vals) {
+                _free_arrays(flgs, keys, vals, asize);
+                return false;
+            }
+            return true;
+        }
+    }
+
+    void _free_arrays(size_t* flgs, key_type* keys, mapped_type* vals,
+                      size_t asize) noexcept
+    {
+        if constexpr (FixedCapacity != 0) {
+            (void)flgs, (void)keys, (void)vals, (void)asize;
+            return;
+        } else {
+            if (_in_mapping(flgs)) {
+                plt::snapshot_unmap(_mapping, _mapping_bytes);
+                _mapping = nullptr;
+                _mapping_bytes = 0;
+                _readonly = false;
+                return;
+            }
+            Alloc& alloc = *this;
+            if (flgs)
+                alloc.deallocate(flgs, _fsize(asize), sizeof(*flgs));
+            if (keys)
+                alloc.deallocate(keys, asize, sizeof(key_type));
+            if (vals)
+                alloc.deallocate(vals, asize, sizeof(mapped_type));
+        }
+    }
+
+    plt::SnapshotHeader _snapshot_header() const noexcept
+    {
+        auto hdr = plt::snapshot_header(plt::SnapshotKind::LoaTable);
+        hdr.key_size = sizeof(key_type);
+        hdr.key_align = alignof(key_type);
+        hdr.val_size = sizeof(mapped_type);
+        hdr.val_align = alignof(mapped_type);
+        hdr.hash_id = plt::hash_identity<Hash>::id();
+        hdr.hash_seed = plt::hash_identity<Hash>::seed(hash_function());
+        return hdr;
+    }
+
+    bool _in_mapping(const void* p) const noexcept
+    {
+        const char* base = static_cast<const char*>(_mapping);
+        const char* c = static_cast<const char*>(p);
+        return base && c >= base && c < base + _mapping_bytes;
+    }
+
+    bool _is_readonly_mapping() const noexcept
+    {
+        return _readonly && _in_mapping(_flags);
+    }
+
     static constexpr bool _is_alive(const size_t* flags, size_t i) noexcept
     {
         constexpr size_t n = sizeof(*flags);
@@ -297,6 +1044,11 @@ private:
         return ((flags[i / n] & (1u << (2 * (i % n) + 1))) != 0);
     }
 
+    static constexpr bool _is_dead(const size_t* flags, size_t i) noexcept
+    {
+        return !_is_alive(flags, i) && !_is_tombstone(flags, i);
+    }
+
     static void _animate(size_t* flags, size_t i) noexcept
     {
         constexpr size_t n = sizeof(*flags);
@@ -310,6 +1062,12 @@ private:
         flags[i / n] |= (1u << (2 * (i % n)));
     }
 
+    static void _set_dead(size_t* flags, size_t i) noexcept
+    {
+        constexpr size_t n = sizeof(*flags);
+        flags[i / n] &= ~(size_t(3) << (2 * (i % n)));
+    }
+
     static void _set_tombstone(size_t* flags, size_t i) noexcept
     {
         constexpr size_t n = sizeof(*flags);
@@ -317,7 +1075,7 @@ private:
         flags[i / n] |= (1u << (2 * (i % n) + 1));
     }
 
-    constexpr size_t _next_occupied_slot(size_t i) noexcept
+    constexpr size_t _next_occupied_slot(size_t i) const noexcept
     {
         assert(i != _asize);
         for (i = i + 1; i != _asize; ++i) {
@@ -335,13 +1093,18 @@ private:
     size_t _asize = 0;
     size_t _used = 0;
     size_t _cutoff = 0;
+    plt::ThreadPool* _pool = nullptr;
+    size_t _parallel_threshold = ParallelResizeThreshold;
+    void* _mapping = nullptr;
+    size_t _mapping_bytes = 0;
+    bool _readonly = false;
 };
 
-template <class Key, class T, class Hash, class KeyEq>
-class loatable<Key, T, Hash, KeyEq>::iterator
+template <class Key, class T, class Hash, class KeyEq, class Alloc>
+class loatable<Key, T, Hash, KeyEq, Alloc>::iterator
 {
-    using table_type = loatable<Key, T, Hash, KeyEq>;
-    friend class loatable<Key, T, Hash, KeyEq>;
+    using table_type = loatable<Key, T, Hash, KeyEq, Alloc>;
+    friend class loatable<Key, T, Hash, KeyEq, Alloc>;
     table_type* _table = nullptr;
     size_t _index = 0;
 
@@ -448,11 +1211,11 @@ public:
     }
 };
 
-template <class Key, class T, class Hash, class KeyEq>
-class loatable<Key, T, Hash, KeyEq>::const_iterator
+template <class Key, class T, class Hash, class KeyEq, class Alloc>
+class loatable<Key, T, Hash, KeyEq, Alloc>::const_iterator
 {
-    using table_type = loatable<Key, T, Hash, KeyEq>;
-    friend class loatable<Key, T, Hash, KeyEq>;
+    using table_type = loatable<Key, T, Hash, KeyEq, Alloc>;
+    friend class loatable<Key, T, Hash, KeyEq, Alloc>;
     const table_type* _table = nullptr;
     size_t _index = 0;
 
@@ -568,3 +1331,11 @@ public:
         other = tmp;
     }
 };
+
+// loatable with `Capacity` slots stored inline: no heap, a compile-time
+// probe mask, and InsertResult::Error once the load factor is reached
+// (Capacity * MaxLoadFactor entries). Not copyable or movable.
+template <class Key, class T, size_t Capacity, class Hash = std::hash<Key>,
+          class KeyEq = std::equal_to<Key>>
+using static_loatable =
+  loatable<Key, T, Hash, KeyEq, loa_inline_storage<Key, T, Capacity>>;
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <type_traits>
+#include <unistd.h>
+#include <utility>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#elif defined(__APPLE__)
+#include <malloc/malloc.h>
+#endif
+
+namespace plt {
+
+// Memory accounting for the tables' memory_usage(). Tables report the bytes
+// their allocator actually set aside, which for malloc is the request plus
+// the allocator's rounding slack, so that bytes per entry compare engines
+// at equal budgets rather than at equal element counts.
+
+// Bytes reserved for `p`, a block of `bytes` requested from malloc, calloc
+// or realloc. Falls back to the request where the C library cannot say.
+inline size_t malloc_usable_bytes(const void* p, size_t bytes) noexcept
+{
+    if (!p)
+        return 0;
+#if defined(__GLIBC__)
+    (void)bytes;
+    return malloc_usable_size(const_cast<void*>(p));
+#elif defined(__APPLE__)
+    (void)bytes;
+    return malloc_size(p);
+#else
+    return bytes;
+#endif
+}
+
+// Bytes of whole pages spanned by an mmap(2) of `bytes`.
+inline size_t page_rounded_bytes(size_t bytes) noexcept
+{
+    static const size_t page = size_t(sysconf(_SC_PAGESIZE));
+    return (bytes + page - 1) / page * page;
+}
+
+template <class Alloc, class = void>
+struct has_usable_size : std::false_type
+{};
+
+template <class Alloc>
+struct has_usable_size<
+  Alloc, std::void_t<decltype(std::declval<const Alloc&>().usable_size(
+           static_cast<const void*>(nullptr), size_t(), size_t()))>>
+  : std::true_type
+{};
+
+// Bytes behind `p`, an array of `nmemb` elements of `size` bytes from
+// `alloc.allocate()`. Storage policies may define
+// `usable_size(ptr, nmemb, size)`; otherwise the request is all that is
+// known.
+template <class Alloc>
+size_t allocated_bytes(const Alloc& alloc, const void* p, size_t nmemb,
+                       size_t size) noexcept
+{
+    if (!p)
+        return 0;
+    if constexpr (has_usable_size<Alloc>::value)
+        return alloc.usable_size(p, nmemb, size);
+    else
+        return nmemb * size;
+}
+
+} // ~plt
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <dirent.h>
+#include <pltables++/memory.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace plt {
+
+// Minimal NUMA placement helpers. Talks to the kernel directly (getcpu(2),
+// mbind(2)) so nothing needs to link against libnuma. Every call degrades to
+// "node 0" / ordinary allocation on kernels or machines without NUMA support.
+
+constexpr int NumaNoNode = -1;
+
+inline int numa_current_node() noexcept
+{
+    unsigned cpu = 0;
+    unsigned node = 0;
+#ifdef SYS_getcpu
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0)
+        return static_cast<int>(node);
+#endif
+    return 0;
+}
+
+inline int numa_node_count() noexcept
+{
+    DIR* dir = opendir("/sys/devices/system/node");
+    if (!dir)
+        return 1;
+    int count = 0;
+    while (dirent* ent = readdir(dir)) {
+        const char* p = ent->d_name;
+        if (p[0] == 'n' && p[1] == 'o' && p[2] == 'd' && p[3] == 'e' &&
+            p[4] >= '0' && p[4] <= '9')
+            ++count;
+    }
+    closedir(dir);
+    return count > 0 ? count : 1;
+}
+
+inline bool numa_pin_to_cpu(int cpu) noexcept
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+// Prefer (not require) `node` for [addr, addr+bytes). Must be called before the
+// pages are first touched. Returns false if the kernel refused.
+inline bool numa_bind(void* addr, size_t bytes, int node) noexcept
+{
+#ifdef SYS_mbind
+    constexpr int MPOL_PREFERRED_ = 1;
+    constexpr unsigned long MaxNode = 8 * sizeof(unsigned long);
+    if (node < 0 || static_cast<unsigned long>(node) >= MaxNode)
+        return false;
+    unsigned long mask = 1ul << node;
+    return syscall(SYS_mbind, addr, bytes, MPOL_PREFERRED_, &mask, MaxNode + 1,
+                   0) == 0;
+#else
+    (void)addr;
+    (void)bytes;
+    (void)node;
+    return false;
+#endif
+}
+
+// Zeroed, page-granular allocation placed on `node`.
+inline void* numa_alloc_onnode(size_t bytes, int node) noexcept
+{
+    void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED)
+        return nullptr;
+    if (node != NumaNoNode)
+        numa_bind(p, bytes, node);
+    return p;
+}
+
+inline void numa_free(void* ptr, size_t bytes) noexcept
+{
+    if (ptr)
+        munmap(ptr, bytes);
+}
+
+// Storage policy for `loatable` that places the flag, key and value arrays on
+// a fixed node. Small arrays don't justify a page each, so they come from
+// calloc() and rely on first-touch placement by the owning thread instead.
+struct NumaAllocator
+{
+    constexpr static size_t MinMappedBytes = 64 * 1024;
+
+    int node = NumaNoNode;
+
+    constexpr NumaAllocator() noexcept = default;
+    constexpr explicit NumaAllocator(int n) noexcept : node{ n } {}
+
+    void* allocate(size_t nmemb, size_t size) const noexcept
+    {
+        const size_t bytes = nmemb * size;
+        if (bytes < MinMappedBytes)
+            return calloc(nmemb, size);
+        return numa_alloc_onnode(bytes, node);
+    }
+
+    void deallocate(void* ptr, size_t nmemb, size_t size) const noexcept
+    {
+        const size_t bytes = nmemb * size;
+        if (bytes < MinMappedBytes)
+            free(ptr);
+        else
+            numa_free(ptr, bytes);
+    }
+
+    size_t usable_size(const void* ptr, size_t nmemb,
+                       size_t size) const noexcept
+    {
+        const size_t bytes = nmemb * size;
+        if (bytes < MinMappedBytes)
+            return malloc_usable_bytes(ptr, bytes);
+        return page_rounded_bytes(bytes);
+    }
+};
+
+} // ~plt
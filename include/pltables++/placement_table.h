@@ -0,0 +1,436 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <pltables++/snapshot.h>
+#include <type_traits>
+#include <utility>
+
+// Linear-probing table that lives entirely inside a caller-supplied region,
+// e.g. a shm_open(3) or memfd_create(2) mapping shared between processes.
+//
+// Nothing inside the region is a pointer: the header records the array
+// offsets relative to the start of the region, so each process may map it at
+// a different address. The `placement_table` object itself is only a handle
+// (region base + size) and is cheap to create in every process. No heap is
+// used; the capacity is fixed by the region size and insert() reports
+// InsertResult::Error once the load-factor cutoff is reached.
+//
+// Intended use is single-writer publication: the owning process constructs
+// the table, fills it and calls publish(); readers attach() afterwards and
+// only read. Concurrent modification while others read is not supported.
+template <class Key, class T, class Hash = std::hash<Key>,
+          class KeyEq = std::equal_to<Key>>
+class placement_table : private Hash, private KeyEq
+{
+    static_assert(std::is_trivially_copyable_v<Key>,
+                  "Key type must satisfy TriviallyCopyable");
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "Mapped type must satisfy TriviallyCopyable");
+    constexpr static double MaxLoadFactor = 0.77;
+    constexpr static size_t MinTableSize = 8;
+    constexpr static uint64_t Magic = 0x504c54504c414345; // "PLTPLACE"
+    constexpr static uint32_t Version = 1;
+    // 2 flag bits per slot, 32 slots per word.
+    constexpr static size_t SlotsPerWord = 32;
+
+    // Fixed-width only, so 32- and 64-bit processes agree on the layout.
+    struct Header
+    {
+        uint64_t magic;
+        uint32_t version;
+        uint32_t published;
+        uint32_t key_size;
+        uint32_t val_size;
+        uint64_t hash_id;
+        uint64_t hash_seed;
+        uint64_t bytes;
+        uint64_t asize;
+        uint64_t size;
+        uint64_t used;
+        uint64_t cutoff;
+        uint64_t flags_offset;
+        uint64_t keys_offset;
+        uint64_t vals_offset;
+    };
+
+public:
+    enum class InsertResult
+    {
+        Error = -1,
+        Present = 0,
+        Inserted = 1,
+        ReusedSlot = 2,
+    };
+
+    static bool insert_failed(InsertResult r) noexcept
+    {
+        return r == InsertResult::Error;
+    }
+    static bool item_inserted(InsertResult r) noexcept
+    {
+        return static_cast<int>(r) >= static_cast<int>(InsertResult::Inserted);
+    }
+
+    class iterator;
+
+    using key_type = Key;
+    using mapped_type = T;
+    using hasher = Hash;
+    using key_equal = KeyEq;
+
+    // Detached handle; valid() is false.
+    constexpr placement_table() noexcept = default;
+
+    // Format `region` as an empty table with the largest power-of-2 capacity
+    // that fits in `bytes`. `region` must be aligned for Key, T and uint64_t.
+    // If it is too small valid() is false and the region is not touched.
+    placement_table(void* region, size_t bytes) noexcept
+    {
+        const size_t asize = _max_asize(bytes);
+        if (!region || asize == 0)
+            return;
+        assert(reinterpret_cast<uintptr_t>(region) % _region_align() == 0);
+        auto* hdr = static_cast<Header*>(region);
+        memset(hdr, 0, sizeof(Header));
+        hdr->version = Version;
+        hdr->key_size = sizeof(Key);
+        hdr->val_size = sizeof(T);
+        hdr->hash_id = plt::hash_identity<Hash>::id();
+        hdr->hash_seed = plt::hash_identity<Hash>::seed(hash_function());
+        hdr->bytes = bytes;
+        hdr->asize = asize;
+        hdr->cutoff = asize * MaxLoadFactor;
+        hdr->flags_offset = _align(sizeof(Header), alignof(uint64_t));
+        hdr->keys_offset = _align(
+          hdr->flags_offset + _fsize(asize) * sizeof(uint64_t), alignof(Key));
+        hdr->vals_offset =
+          _align(hdr->keys_offset + asize * sizeof(Key), alignof(T));
+        memset(static_cast<char*>(region) + hdr->flags_offset, 0,
+               _fsize(asize) * sizeof(uint64_t));
+        hdr->magic = Magic;
+        _base = static_cast<char*>(region);
+        _bytes = bytes;
+    }
+
+    // Bytes a region needs to hold `n` entries without reaching the cutoff.
+    static constexpr size_t required_bytes(size_t n) noexcept
+    {
+        size_t asize = MinTableSize;
+        while (static_cast<size_t>(asize * MaxLoadFactor) <= n)
+            asize *= 2;
+        return _layout_bytes(asize);
+    }
+
+    // Open a table formatted (and published) by another process. Fails --
+    // valid() is false -- if the region was not published, was built for
+    // other key/value types or hash function, or is inconsistent with
+    // `bytes`.
+    static placement_table attach(void* region, size_t bytes) noexcept
+    {
+        placement_table t;
+        const auto* hdr = static_cast<const Header*>(region);
+        if (!region || bytes < sizeof(Header))
+            return t;
+        if (__atomic_load_n(&hdr->published, __ATOMIC_ACQUIRE) == 0)
+            return t;
+        const uint64_t asize = hdr->asize;
+        const bool ok =
+          hdr->magic == Magic && hdr->version == Version &&
+          hdr->key_size == sizeof(Key) && hdr->val_size == sizeof(T) &&
+          hdr->hash_id == plt::hash_identity<Hash>::id() &&
+          hdr->hash_seed == plt::hash_identity<Hash>::seed(t.hash_function()) &&
+          hdr->bytes <= bytes && asize >= MinTableSize &&
+          (asize & (asize - 1)) == 0 && hdr->size <= hdr->used &&
+          hdr->used < asize && hdr->flags_offset % alignof(uint64_t) == 0 &&
+          hdr->keys_offset % alignof(Key) == 0 &&
+          hdr->vals_offset % alignof(T) == 0 &&
+          hdr->flags_offset + _fsize(asize) * sizeof(uint64_t) <= bytes &&
+          hdr->keys_offset + asize * sizeof(Key) <= bytes &&
+          hdr->vals_offset + asize * sizeof(T) <= bytes;
+        if (ok) {
+            t._base = static_cast<char*>(region);
+            t._bytes = bytes;
+        }
+        return t;
+    }
+
+    // Make the current contents visible to attach(). Stores made before
+    // publish() happen-before the loads of any reader that attaches after it.
+    void publish() noexcept
+    {
+        assert(valid());
+        __atomic_store_n(&_header()->published, 1u, __ATOMIC_RELEASE);
+    }
+
+    bool valid() const noexcept { return _base != nullptr; }
+    bool published() const noexcept
+    {
+        return valid() &&
+               __atomic_load_n(&_header()->published, __ATOMIC_ACQUIRE) != 0;
+    }
+    void* region() const noexcept { return _base; }
+    size_t region_bytes() const noexcept { return _bytes; }
+
+    size_t capacity() const noexcept { return valid() ? _header()->asize : 0; }
+    size_t size() const noexcept { return valid() ? _header()->size : 0; }
+    // Bytes taken by the table: the handle and the whole region, which the
+    // table occupies though it does not own it.
+    size_t memory_usage() const noexcept { return sizeof(*this) + _bytes; }
+    bool empty() const noexcept { return size() == 0u; }
+    hasher hash_function() const noexcept { return *this; }
+    key_equal key_eq() const noexcept { return *this; }
+
+    iterator find(const key_type& key) const noexcept
+    {
+        if (!valid())
+            return end();
+        const Header* hdr = _header();
+        const uint64_t* flags = _flags();
+        const Key* keys = _keys();
+        const size_t mask = hdr->asize - 1;
+        auto keyeq = key_eq();
+        size_t i = hash_function()(key) & mask;
+        for (;;) {
+            if (_is_alive(flags, i)) {
+                if (keyeq(key, keys[i]))
+                    return { this, i };
+            } else if (!_is_tombstone(flags, i)) {
+                break;
+            }
+            i = (i + 1) & mask;
+        }
+        return end();
+    }
+
+    bool contains(const key_type& key) const noexcept
+    {
+        return find(key) != end();
+    }
+
+    iterator begin() const noexcept { return { this, _next_alive(0) }; }
+    iterator end() const noexcept { return { this, capacity() }; }
+
+    std::pair<iterator, InsertResult> insert(const key_type& key,
+                                             const mapped_type& val) noexcept
+    {
+        if (!valid())
+            return std::make_pair(end(), InsertResult::Error);
+        Header* hdr = _header();
+        uint64_t* flags = _flags();
+        Key* keys = _keys();
+        T* vals = _vals();
+        const size_t mask = hdr->asize - 1;
+        auto keyeq = key_eq();
+        size_t i = hash_function()(key) & mask;
+        for (;;) {
+            if (!_is_alive(flags, i)) {
+                const bool reuse = _is_tombstone(flags, i);
+                if (reuse) {
+                    const size_t at = _find_alive_after(i, key, mask);
+                    if (at != hdr->asize)
+                        return std::make_pair(iterator{ this, at },
+                                              InsertResult::Present);
+                } else {
+                    // Never fill the last never-used slots: lookups stop
+                    // at the first one.
+                    if (hdr->used >= hdr->cutoff)
+                        return std::make_pair(end(), InsertResult::Error);
+                    ++hdr->used;
+                }
+                new (&keys[i]) Key{ key };
+                new (&vals[i]) T{ val };
+                _set_live(flags, i);
+                ++hdr->size;
+                return std::make_pair(iterator{ this, i },
+                                      reuse ? InsertResult::ReusedSlot
+                                            : InsertResult::Inserted);
+            } else if (keyeq(key, keys[i])) {
+                return std::make_pair(iterator{ this, i },
+                                      InsertResult::Present);
+            }
+            i = (i + 1) & mask;
+        }
+    }
+
+    void erase(iterator it) noexcept
+    {
+        assert(it != end());
+        _set_tombstone(_flags(), it._index);
+        --_header()->size;
+    }
+
+    size_t erase(const key_type& key) noexcept
+    {
+        auto it = find(key);
+        if (it == end())
+            return 0u;
+        erase(it);
+        return 1u;
+    }
+
+private:
+    static constexpr size_t _align(size_t x, size_t a) noexcept
+    {
+        return (x + a - 1) / a * a;
+    }
+
+    static constexpr size_t _region_align() noexcept
+    {
+        size_t a = alignof(uint64_t);
+        a = alignof(Key) > a ? alignof(Key) : a;
+        return alignof(T) > a ? alignof(T) : a;
+    }
+
+    static constexpr size_t _fsize(size_t asize) noexcept
+    {
+        return (asize + SlotsPerWord - 1) / SlotsPerWord;
+    }
+
+    static constexpr size_t _layout_bytes(size_t asize) noexcept
+    {
+        size_t off = _align(sizeof(Header), alignof(uint64_t));
+        off = _align(off + _fsize(asize) * sizeof(uint64_t), alignof(Key));
+        off = _align(off + asize * sizeof(Key), alignof(T));
+        return off + asize * sizeof(T);
+    }
+
+    static constexpr size_t _max_asize(size_t bytes) noexcept
+    {
+        if (bytes < _layout_bytes(MinTableSize))
+            return 0;
+        size_t asize = MinTableSize;
+        while (asize <= SIZE_MAX / 4 && _layout_bytes(2 * asize) <= bytes)
+            asize *= 2;
+        return asize;
+    }
+
+    Header* _header() const noexcept { return reinterpret_cast<Header*>(_base); }
+    uint64_t* _flags() const noexcept
+    {
+        return reinterpret_cast<uint64_t*>(_base + _header()->flags_offset);
+    }
+    Key* _keys() const noexcept
+    {
+        return reinterpret_cast<Key*>(_base + _header()->keys_offset);
+    }
+    T* _vals() const noexcept
+    {
+        return reinterpret_cast<T*>(_base + _header()->vals_offset);
+    }
+
+    // Continue a probe past the tombstone `i` to see whether `key` is
+    // already stored further along. Returns asize if not.
+    size_t _find_alive_after(size_t i, const key_type& key,
+                             size_t mask) const noexcept
+    {
+        const uint64_t* flags = _flags();
+        auto keyeq = key_eq();
+        const Key* keys = _keys();
+        for (i = (i + 1) & mask;; i = (i + 1) & mask) {
+            if (_is_alive(flags, i)) {
+                if (keyeq(key, keys[i]))
+                    return i;
+            } else if (!_is_tombstone(flags, i)) {
+                return _header()->asize;
+            }
+        }
+    }
+
+    size_t _next_alive(size_t i) const noexcept
+    {
+        const size_t asize = capacity();
+        const uint64_t* flags = valid() ? _flags() : nullptr;
+        while (i < asize && !_is_alive(flags, i))
+            ++i;
+        return i;
+    }
+
+    static bool _is_alive(const uint64_t* flags, size_t i) noexcept
+    {
+        return (flags[i / SlotsPerWord] >> (2 * (i % SlotsPerWord))) & 1u;
+    }
+
+    static bool _is_tombstone(const uint64_t* flags, size_t i) noexcept
+    {
+        return (flags[i / SlotsPerWord] >> (2 * (i % SlotsPerWord) + 1)) & 1u;
+    }
+
+    static void _set_live(uint64_t* flags, size_t i) noexcept
+    {
+        const unsigned s = 2 * (i % SlotsPerWord);
+        flags[i / SlotsPerWord] &= ~(uint64_t(2) << s);
+        flags[i / SlotsPerWord] |= uint64_t(1) << s;
+    }
+
+    static void _set_tombstone(uint64_t* flags, size_t i) noexcept
+    {
+        const unsigned s = 2 * (i % SlotsPerWord);
+        flags[i / SlotsPerWord] &= ~(uint64_t(1) << s);
+        flags[i / SlotsPerWord] |= uint64_t(2) << s;
+    }
+
+private:
+    char* _base = nullptr;
+    size_t _bytes = 0;
+};
+
+template <class Key, class T, class Hash, class KeyEq>
+class placement_table<Key, T, Hash, KeyEq>::iterator
+{
+    using table_type = placement_table<Key, T, Hash, KeyEq>;
+    friend table_type;
+    const table_type* _table = nullptr;
+    size_t _index = 0;
+
+public:
+    constexpr iterator() noexcept = default;
+
+    constexpr iterator(const table_type* table, size_t index) noexcept
+      : _table{ table }
+      , _index{ index }
+    {
+    }
+
+    const Key& key() const noexcept
+    {
+        assert(_index < _table->capacity());
+        return _table->_keys()[_index];
+    }
+
+    // Writable only for the owning process, before publish().
+    T& value() const noexcept
+    {
+        assert(_index < _table->capacity());
+        return _table->_vals()[_index];
+    }
+
+    T& val() const noexcept { return value(); }
+
+    iterator& operator++() noexcept
+    {
+        _index = _table->_next_alive(_index + 1);
+        return *this;
+    }
+
+    iterator operator++(int) noexcept
+    {
+        iterator tmp = *this;
+        ++(*this);
+        return tmp;
+    }
+
+    friend bool operator==(iterator lhs, iterator rhs) noexcept
+    {
+        return lhs._index == rhs._index && lhs._table == rhs._table;
+    }
+
+    friend bool operator!=(iterator lhs, iterator rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+};
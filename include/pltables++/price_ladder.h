@@ -0,0 +1,316 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <pltables++/linear_open_address.h>
+#include <pltables++/vector.h>
+#include <utility>
+
+// Price levels of one side of an order book.
+//
+// Prices within window() ticks of base() live in a contiguous plt::Vector
+// indexed by `(price - base) / tick`. A three-level bitmap over the slots
+// (slots, words, words of words) finds the best occupied price, the highest
+// for bids and the lowest for asks, with three bit scans. Prices beyond the
+// window on the far side of the touch go to a spill loatable.
+//
+// The window follows the market: an insert better than the window, or any
+// insert into an empty window, recenters it so the price sits a quarter of
+// the window in from the good edge; so does a far-side insert when the best
+// price has drifted into the far half. Recentering moves the levels that
+// leave the window into the spill table and pulls the spilled ones that now
+// fit back in. When the window empties, the best spilled level is recentered
+// on, so best() never has to search the spill table.
+//
+// Prices must be multiples of the tick. `Alloc` is the spill table's storage
+// policy (see loa_default_allocator).
+template <class T, class Price = int64_t, class Hash = std::hash<Price>,
+          class Alloc = loa_default_allocator>
+class price_ladder
+{
+public:
+    enum class Side
+    {
+        Bid,
+        Ask,
+    };
+
+    using price_type = Price;
+    using mapped_type = T;
+    using spill_type = loatable<Price, T, Hash, std::equal_to<Price>, Alloc>;
+
+    constexpr static size_t DefaultWindow = 4096;
+    constexpr static size_t MaxWindow = size_t(1) << 18;
+
+    // `window` is rounded up to a power of 2 between 64 and MaxWindow.
+    price_ladder(Side side, Price tick, size_t window = DefaultWindow) noexcept
+      : _tick{ tick }, _bid{ side == Side::Bid }
+    {
+        assert(tick > 0);
+        size_t w = 64;
+        while (w < window && w < MaxWindow)
+            w *= 2;
+        _window = w;
+        _slots = plt::Vector<T>(int(w));
+        _leaf = plt::Vector<uint64_t>(int(w / 64));
+        _mid = plt::Vector<uint64_t>(int((w + 4095) / 4096));
+    }
+
+    Side side() const noexcept { return _bid ? Side::Bid : Side::Ask; }
+    Price tick() const noexcept { return _tick; }
+    size_t window() const noexcept { return _window; }
+    Price base() const noexcept { return _base; }
+
+    size_t size() const noexcept { return _count + _spill.size(); }
+    bool empty() const noexcept { return size() == 0u; }
+    size_t in_window() const noexcept { return _count; }
+    size_t spilled() const noexcept { return _spill.size(); }
+
+    // Bytes held by the ladder: the window, its bitmaps and the spill table
+    // (see loatable::memory_usage).
+    size_t memory_usage() const noexcept
+    {
+        return sizeof(*this) - sizeof(_slots) - sizeof(_leaf) - sizeof(_mid) -
+               sizeof(_spill) + _slots.memory_usage() + _leaf.memory_usage() +
+               _mid.memory_usage() + _spill.memory_usage();
+    }
+
+    // Highest bid or lowest ask. The ladder must not be empty.
+    Price best() const noexcept
+    {
+        assert(_count != 0);
+        return _price_at(_best_slot());
+    }
+    T& best_level() noexcept { return _slots[_best_slot()]; }
+
+    T* find(Price price) noexcept
+    {
+        const size_t i = _slot_of(price);
+        if (i < _window)
+            return _test(i) ? &_slots[i] : nullptr;
+        auto it = _spill.find(price);
+        return it == _spill.end() ? nullptr : &it.value();
+    }
+
+    // The level at `price`, value-initialized if it was not there, and
+    // whether it was inserted. nullptr only if the spill table could not
+    // grow, in which case the ladder is unchanged.
+    std::pair<T*, bool> insert(Price price) noexcept
+    {
+        size_t i = _slot_of(price);
+        if (i >= _window) {
+            const bool better = _bid ? price > _price_at(_window - 1)
+                                     : price < _base;
+            bool moved = true;
+            if (_count == 0 || better)
+                moved = _recenter(price);
+            else if (_far_half(_best_slot()))
+                moved = _recenter(best());
+            if (!moved)
+                return { nullptr, false };
+            i = _slot_of(price);
+        }
+        if (i >= _window) {
+            auto r = _spill.insert(price);
+            if (spill_type::insert_failed(r.second))
+                return { nullptr, false };
+            return { &r.first.value(),
+                     spill_type::item_inserted(r.second) };
+        }
+        if (_test(i))
+            return { &_slots[i], false };
+        _slots[i] = T{};
+        _set(i);
+        ++_count;
+        return { &_slots[i], true };
+    }
+
+    size_t erase(Price price) noexcept
+    {
+        const size_t i = _slot_of(price);
+        if (i >= _window)
+            return _spill.erase(price);
+        if (!_test(i))
+            return 0u;
+        _clear(i);
+        --_count;
+        if (_count == 0 && _spill.size() != 0) {
+            // An empty window has nothing to spill, so this cannot fail.
+            const bool moved = _recenter(_best_spilled());
+            assert(moved);
+            (void)moved;
+        }
+        return 1u;
+    }
+
+    void clear() noexcept
+    {
+        for (auto& w : _leaf)
+            w = 0;
+        for (auto& w : _mid)
+            w = 0;
+        _top = 0;
+        _count = 0;
+        _spill.clear();
+    }
+
+private:
+    // Slot of `price`, or >= _window when outside.
+    size_t _slot_of(Price price) const noexcept
+    {
+        assert((price - _base) % _tick == 0);
+        return price < _base ? SIZE_MAX : size_t((price - _base) / _tick);
+    }
+    Price _price_at(size_t i) const noexcept
+    {
+        return _base + Price(i) * _tick;
+    }
+    // Slot a quarter of the window in from the good edge.
+    size_t _anchor() const noexcept
+    {
+        return _bid ? _window - _window / 4 : _window / 4;
+    }
+    bool _far_half(size_t i) const noexcept
+    {
+        return _bid ? i < _window / 2 : i >= _window / 2;
+    }
+
+    bool _test(size_t i) const noexcept
+    {
+        return (_leaf[i / 64] >> (i % 64)) & 1u;
+    }
+    void _set(size_t i) noexcept
+    {
+        _leaf[i / 64] |= uint64_t(1) << (i % 64);
+        _mid[i / 4096] |= uint64_t(1) << (i / 64 % 64);
+        _top |= uint64_t(1) << (i / 4096);
+    }
+    void _clear(size_t i) noexcept
+    {
+        if ((_leaf[i / 64] &= ~(uint64_t(1) << (i % 64))) != 0)
+            return;
+        if ((_mid[i / 4096] &= ~(uint64_t(1) << (i / 64 % 64))) != 0)
+            return;
+        _top &= ~(uint64_t(1) << (i / 4096));
+    }
+
+    size_t _best_slot() const noexcept
+    {
+        assert(_top != 0);
+        if (_bid) {
+            const size_t m = 63 - size_t(__builtin_clzll(_top));
+            const size_t l = m * 64 + 63 - size_t(__builtin_clzll(_mid[m]));
+            return l * 64 + 63 - size_t(__builtin_clzll(_leaf[l]));
+        }
+        const size_t m = size_t(__builtin_ctzll(_top));
+        const size_t l = m * 64 + size_t(__builtin_ctzll(_mid[m]));
+        return l * 64 + size_t(__builtin_ctzll(_leaf[l]));
+    }
+
+    Price _best_spilled() const noexcept
+    {
+        auto it = _spill.begin();
+        Price best = it.key();
+        for (; it != _spill.end(); ++it)
+            best = _bid ? std::max(best, it.key()) : std::min(best, it.key());
+        return best;
+    }
+
+    // Move the window so that `price` lands on the anchor slot. Returns
+    // false, with nothing moved, if a level leaving the window cannot be
+    // spilled.
+    bool _recenter(Price price) noexcept
+    {
+        const Price base = price - Price(_anchor()) * _tick;
+        const Price shift = (base - _base) / _tick;
+        auto stays = [&](size_t i) {
+            const Price j = Price(i) - shift;
+            return j >= 0 && size_t(j) < _window;
+        };
+        if (_count != 0) {
+            // Spill first: until the new window is built, a failed insert
+            // is undone by moving the levels already spilled back.
+            size_t failed = SIZE_MAX;
+            for (size_t w = 0; w < _window / 64 && failed == SIZE_MAX; ++w) {
+                for (uint64_t bits = _leaf[w]; bits != 0; bits &= bits - 1) {
+                    const size_t i = w * 64 + size_t(__builtin_ctzll(bits));
+                    if (stays(i))
+                        continue;
+                    auto r = _spill.insert(_price_at(i), std::move(_slots[i]));
+                    if (spill_type::insert_failed(r.second)) {
+                        failed = i;
+                        break;
+                    }
+                }
+            }
+            if (failed != SIZE_MAX) {
+                for (size_t w = 0; w <= failed / 64; ++w) {
+                    for (uint64_t bits = _leaf[w]; bits != 0;
+                         bits &= bits - 1) {
+                        const size_t i =
+                          w * 64 + size_t(__builtin_ctzll(bits));
+                        if (i >= failed)
+                            break;
+                        if (stays(i))
+                            continue;
+                        auto it = _spill.find(_price_at(i));
+                        _slots[i] = std::move(it.value());
+                        _spill.erase(it);
+                    }
+                }
+                return false;
+            }
+            plt::Vector<T> slots(static_cast<int>(_window));
+            plt::Vector<uint64_t> leaf(static_cast<int>(_window / 64));
+            for (size_t w = 0; w < _window / 64; ++w) {
+                for (uint64_t bits = _leaf[w]; bits != 0; bits &= bits - 1) {
+                    const size_t i = w * 64 + size_t(__builtin_ctzll(bits));
+                    if (stays(i)) {
+                        const size_t j = size_t(Price(i) - shift);
+                        slots[j] = std::move(_slots[i]);
+                        leaf[j / 64] |= uint64_t(1) << (j % 64);
+                    }
+                }
+            }
+            _slots = std::move(slots);
+            _leaf = std::move(leaf);
+        }
+        _base = base;
+        _count = 0;
+        for (auto& w : _mid)
+            w = 0;
+        _top = 0;
+        for (size_t w = 0; w < _window / 64; ++w) {
+            if (_leaf[w] != 0) {
+                _mid[w / 64] |= uint64_t(1) << (w % 64);
+                _top |= uint64_t(1) << (w / 64);
+                _count += size_t(__builtin_popcountll(_leaf[w]));
+            }
+        }
+        // Pull back spilled levels that now fit.
+        for (auto it = _spill.begin(); it != _spill.end(); ++it) {
+            const size_t i = _slot_of(it.key());
+            if (i < _window) {
+                _slots[i] = std::move(it.value());
+                _set(i);
+                ++_count;
+                _spill.erase(it);
+            }
+        }
+        return true;
+    }
+
+    plt::Vector<T> _slots;
+    plt::Vector<uint64_t> _leaf; // one bit per slot
+    plt::Vector<uint64_t> _mid;  // one bit per _leaf word
+    uint64_t _top = 0;           // one bit per _mid word
+    spill_type _spill;
+    size_t _window = 0;
+    size_t _count = 0;
+    Price _base = 0;
+    Price _tick;
+    bool _bid;
+};
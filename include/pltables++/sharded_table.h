@@ -0,0 +1,153 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <pltables++/linear_open_address.h>
+#include <pltables++/numa.h>
+#include <utility>
+#include <vector>
+
+// Power-of-2 number of independent `loatable` shards, each owning its own
+// flag / key / value arrays on a chosen NUMA node. Keys are routed to a shard
+// by the high bits of a fibonacci-mixed hash, so the low bits that index into
+// the shard stay uncorrelated with the shard choice.
+//
+// The container itself is not synchronized: each shard is meant to be owned by
+// one thread. Distinct shards may be used concurrently by distinct threads.
+template <class Key, class T, class Hash = std::hash<Key>,
+          class KeyEq = std::equal_to<Key>>
+class sharded_loatable : private Hash
+{
+public:
+    using shard_type = loatable<Key, T, Hash, KeyEq, plt::NumaAllocator>;
+    using key_type = Key;
+    using mapped_type = T;
+    using hasher = Hash;
+    using InsertResult = typename shard_type::InsertResult;
+    using iterator = typename shard_type::iterator;
+
+    explicit sharded_loatable(size_t nshards)
+    {
+        size_t n = 1;
+        while (n < nshards)
+            n *= 2;
+        _shift = 64;
+        for (size_t i = n; i > 1; i /= 2)
+            --_shift;
+        _shards.reserve(n);
+        for (size_t i = 0; i < n; ++i)
+            _shards.emplace_back(new shard_slot{});
+    }
+
+    size_t shard_count() const noexcept { return _shards.size(); }
+
+    size_t shard_for(const key_type& key) const noexcept
+    {
+        if (_shift == 64)
+            return 0;
+        const uint64_t h = static_cast<uint64_t>(hash_function()(key));
+        return (h * 11400714819323198485llu) >> _shift;
+    }
+
+    shard_type& shard(size_t i) noexcept { return _shards[i]->table; }
+    const shard_type& shard(size_t i) const noexcept
+    {
+        return _shards[i]->table;
+    }
+    shard_type& shard_of(const key_type& key) noexcept
+    {
+        return shard(shard_for(key));
+    }
+    const shard_type& shard_of(const key_type& key) const noexcept
+    {
+        return shard(shard_for(key));
+    }
+
+    int shard_node(size_t i) const noexcept
+    {
+        return shard(i).get_allocator().node;
+    }
+
+    // Place shard `i` on the calling thread's node. Call from the thread that
+    // will own the shard, after pinning it.
+    bool attach(size_t i) { return attach(i, plt::numa_current_node()); }
+
+    // Place shard `i` on `node`, migrating any existing entries.
+    bool attach(size_t i, int node)
+    {
+        assert(i < shard_count());
+        std::unique_ptr<shard_slot> fresh{ new shard_slot{
+          shard_type{ plt::NumaAllocator{ node } } } };
+        shard_type& src = _shards[i]->table;
+        if (!src.empty()) {
+            if (!fresh->table.reserve(src.capacity()))
+                return false;
+            for (auto it = src.begin(); it != src.end(); ++it) {
+                auto r = fresh->table.insert(it.key(), std::move(it.value()));
+                if (shard_type::insert_failed(r.second))
+                    return false;
+            }
+        }
+        _shards[i] = std::move(fresh);
+        return true;
+    }
+
+    size_t size() const noexcept
+    {
+        size_t n = 0;
+        for (auto&& s : _shards)
+            n += s->table.size();
+        return n;
+    }
+
+    bool empty() const noexcept { return size() == 0u; }
+
+    // Bytes held by the container: the shard slots and every shard's arrays
+    // (see loatable::memory_usage).
+    size_t memory_usage() const noexcept
+    {
+        size_t n = sizeof(*this) + _shards.capacity() * sizeof(_shards[0]);
+        for (auto&& s : _shards)
+            n += sizeof(shard_slot) - sizeof(shard_type) +
+                 s->table.memory_usage();
+        return n;
+    }
+
+    hasher hash_function() const noexcept { return *this; }
+
+    template <class... Args>
+    std::pair<iterator, InsertResult> insert(key_type key, Args&&... args)
+    {
+        return shard_of(key).insert(key, std::forward<Args>(args)...);
+    }
+
+    bool contains(const key_type& key) const noexcept
+    {
+        const shard_type& s = shard_of(key);
+        return s.find(key) != s.end();
+    }
+
+    size_t erase(const key_type& key) noexcept
+    {
+        return shard_of(key).erase(key);
+    }
+
+    void clear() noexcept
+    {
+        for (auto&& s : _shards)
+            s->table.clear();
+    }
+
+private:
+    // Keep shard headers on separate cache lines: each is written by its own
+    // owner thread on every insert.
+    struct alignas(64) shard_slot
+    {
+        shard_type table;
+    };
+
+    std::vector<std::unique_ptr<shard_slot>> _shards;
+    unsigned _shift = 64;
+};
@@ -0,0 +1,342 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <pltables++/linear_open_address.h>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace plt::detail {
+
+// Bit i set when keys[i] == key, for `n` keys of 1, 2, 4 or 8 bytes stored in
+// an array padded to a multiple of 16 bytes. Lanes past `n` are masked off.
+template <class Key>
+inline uint32_t small_match(const Key* keys, size_t n, Key key) noexcept
+{
+    static_assert(sizeof(Key) <= 8 && (sizeof(Key) & (sizeof(Key) - 1)) == 0);
+    uint32_t found = 0;
+#if defined(__SSE2__)
+    constexpr size_t lanes = 16 / sizeof(Key);
+    using bits_type = std::conditional_t<
+      sizeof(Key) == 1, char,
+      std::conditional_t<sizeof(Key) == 2, short,
+                         std::conditional_t<sizeof(Key) == 4, int, long long>>>;
+    bits_type k;
+    memcpy(&k, &key, sizeof(k));
+    __m128i needle;
+    if constexpr (sizeof(Key) == 1)
+        needle = _mm_set1_epi8(k);
+    else if constexpr (sizeof(Key) == 2)
+        needle = _mm_set1_epi16(k);
+    else if constexpr (sizeof(Key) == 4)
+        needle = _mm_set1_epi32(k);
+    else
+        needle = _mm_set1_epi64x(k);
+    for (size_t i = 0; i < n; i += lanes) {
+        const __m128i block =
+          _mm_load_si128(reinterpret_cast<const __m128i*>(keys + i));
+        uint32_t bits;
+        if constexpr (sizeof(Key) == 1) {
+            bits = _mm_movemask_epi8(_mm_cmpeq_epi8(block, needle));
+        } else if constexpr (sizeof(Key) == 2) {
+            const __m128i eq = _mm_cmpeq_epi16(block, needle);
+            bits = _mm_movemask_epi8(_mm_packs_epi16(eq, _mm_setzero_si128()));
+        } else if constexpr (sizeof(Key) == 4) {
+            bits = _mm_movemask_ps(
+              _mm_castsi128_ps(_mm_cmpeq_epi32(block, needle)));
+        } else {
+            // SSE2 has no 64-bit compare: both 32-bit halves must match.
+            const __m128i eq = _mm_cmpeq_epi32(block, needle);
+            bits = _mm_movemask_pd(_mm_castsi128_pd(_mm_and_si128(
+              eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)))));
+        }
+        found |= bits << i;
+    }
+#else
+    for (size_t i = 0; i < n; ++i)
+        found |= uint32_t(keys[i] == key) << i;
+#endif
+    return n < 32 ? found & ((uint32_t(1) << n) - 1) : found;
+}
+
+} // ~plt::detail
+
+// Map for the common case of a handful of entries. Up to `N` entries are kept
+// inline, in insertion order, as a flat key array and a value array; lookups
+// compare the key against all of them at once with SSE2 (integral, enum and
+// pointer keys of 1-8 bytes under std::equal_to) or scan them with KeyEq.
+// Nothing is hashed or allocated until the (N+1)th insert, which moves the
+// entries into a loatable constructed in the same storage. clear() returns
+// the map to inline mode.
+//
+// Not copyable or movable; std::vector<small_loatable<...>>(n) constructs in
+// place.
+template <class Key, class T, size_t N = 16, class Hash = std::hash<Key>,
+          class KeyEq = std::equal_to<Key>,
+          class Alloc = loa_default_allocator>
+class small_loatable : private KeyEq
+{
+public:
+    using table_type = loatable<Key, T, Hash, KeyEq, Alloc>;
+    using key_type = Key;
+    using mapped_type = T;
+    using hasher = Hash;
+    using key_equal = KeyEq;
+    using InsertResult = typename table_type::InsertResult;
+    class iterator;
+
+    constexpr static size_t InlineCapacity = N;
+
+    static bool insert_failed(InsertResult r) noexcept
+    {
+        return table_type::insert_failed(r);
+    }
+    static bool item_inserted(InsertResult r) noexcept
+    {
+        return table_type::item_inserted(r);
+    }
+
+private:
+    constexpr static bool _simd_keys =
+      (std::is_integral_v<Key> || std::is_enum_v<Key> ||
+       std::is_pointer_v<Key>) &&
+      (sizeof(Key) == 1 || sizeof(Key) == 2 || sizeof(Key) == 4 ||
+       sizeof(Key) == 8) &&
+      (std::is_same_v<KeyEq, std::equal_to<Key>> ||
+       std::is_same_v<KeyEq, std::equal_to<>>);
+    // Key slots, padded so the SIMD scan can load whole 16-byte blocks.
+    constexpr static size_t _key_slots =
+      (N * sizeof(Key) + 15) / 16 * 16 / sizeof(Key);
+    constexpr static uint32_t Hashed = UINT32_MAX;
+
+    static_assert(N > 0 && N <= 32, "inline capacity must be 1 to 32");
+
+public:
+    small_loatable() noexcept {}
+    small_loatable(const small_loatable&) = delete;
+    small_loatable& operator=(const small_loatable&) = delete;
+    ~small_loatable() noexcept { _reset(); }
+
+    void clear() noexcept
+    {
+        _reset();
+        _count = 0;
+    }
+
+    bool is_inline() const noexcept { return _count != Hashed; }
+    size_t size() const noexcept
+    {
+        return is_inline() ? _count : _table.size();
+    }
+    bool empty() const noexcept { return size() == 0u; }
+    size_t capacity() const noexcept
+    {
+        return is_inline() ? N : _table.capacity();
+    }
+    // Bytes held by the map: the inline storage, plus the hash table's arrays
+    // once it has spilled (see loatable::memory_usage).
+    size_t memory_usage() const noexcept
+    {
+        if (is_inline())
+            return sizeof(*this);
+        return sizeof(*this) - sizeof(table_type) + _table.memory_usage();
+    }
+    key_equal key_eq() const noexcept { return *this; }
+
+    iterator begin() noexcept
+    {
+        return is_inline() ? iterator{ this, 0 } : iterator{ _table.begin() };
+    }
+    iterator end() noexcept
+    {
+        return is_inline() ? iterator{ this, _count } : iterator{ _table.end() };
+    }
+
+    iterator find(const key_type& key) noexcept
+    {
+        if (!is_inline())
+            return iterator{ _table.find(key) };
+        return iterator{ this, _index_of(key) };
+    }
+
+    bool contains(const key_type& key) noexcept { return find(key) != end(); }
+
+    template <class... Args>
+    std::pair<iterator, InsertResult> insert(const key_type& key,
+                                             Args&&... args) noexcept
+    {
+        if (!is_inline()) {
+            auto r = _table.insert(key, std::forward<Args>(args)...);
+            return std::make_pair(iterator{ r.first }, r.second);
+        }
+        const size_t i = _index_of(key);
+        if (i != _count)
+            return std::make_pair(iterator{ this, i }, InsertResult::Present);
+        if (_count == N) {
+            if (!_spill())
+                return std::make_pair(end(), InsertResult::Error);
+            return insert(key, std::forward<Args>(args)...);
+        }
+        new (&_keys()[i]) Key(key);
+        new (&_vals()[i]) T(std::forward<Args>(args)...);
+        ++_count;
+        return std::make_pair(iterator{ this, i }, InsertResult::Inserted);
+    }
+
+    // Inline entries are kept dense: the last one moves into the gap.
+    size_t erase(const key_type& key) noexcept
+    {
+        if (!is_inline())
+            return _table.erase(key);
+        const size_t i = _index_of(key);
+        if (i == _count)
+            return 0u;
+        const size_t last = _count - 1;
+        if (i != last) {
+            _keys()[i] = std::move(_keys()[last]);
+            _vals()[i] = std::move(_vals()[last]);
+        }
+        _keys()[last].~Key();
+        _vals()[last].~T();
+        --_count;
+        return 1u;
+    }
+
+private:
+    Key* _keys() noexcept { return reinterpret_cast<Key*>(_inline.keys); }
+    T* _vals() noexcept { return reinterpret_cast<T*>(_inline.vals); }
+
+    size_t _index_of(const key_type& key) noexcept
+    {
+        const Key* keys = _keys();
+        if constexpr (_simd_keys) {
+            const uint32_t m = plt::detail::small_match(keys, _count, key);
+            return m != 0 ? size_t(__builtin_ctz(m)) : _count;
+        } else {
+            auto keyeq = key_eq();
+            for (size_t i = 0; i < _count; ++i)
+                if (keyeq(keys[i], key))
+                    return i;
+            return _count;
+        }
+    }
+
+    // Move the inline entries into a loatable built over the same storage.
+    bool _spill() noexcept
+    {
+        alignas(inline_storage) unsigned char saved[sizeof(inline_storage)];
+        auto* old = reinterpret_cast<inline_storage*>(saved);
+        const size_t n = _count;
+        Key* keys = reinterpret_cast<Key*>(old->keys);
+        T* vals = reinterpret_cast<T*>(old->vals);
+        for (size_t i = 0; i < n; ++i) {
+            new (&keys[i]) Key(std::move(_keys()[i]));
+            new (&vals[i]) T(std::move(_vals()[i]));
+            _keys()[i].~Key();
+            _vals()[i].~T();
+        }
+        new (&_table) table_type{};
+        // Room for N + 1 entries below the load factor: the inserts below
+        // and the one that triggered the spill cannot fail.
+        const bool ok = _table.reserve(2 * N);
+        if (ok) {
+            _count = Hashed;
+            for (size_t i = 0; i < n; ++i)
+                _table.insert(keys[i], std::move(vals[i]));
+        } else {
+            _table.~table_type();
+        }
+        for (size_t i = 0; i < n; ++i) {
+            if (!ok) {
+                new (&_keys()[i]) Key(std::move(keys[i]));
+                new (&_vals()[i]) T(std::move(vals[i]));
+            }
+            keys[i].~Key();
+            vals[i].~T();
+        }
+        return ok;
+    }
+
+    void _reset() noexcept
+    {
+        if (is_inline()) {
+            for (size_t i = 0; i < _count; ++i) {
+                _keys()[i].~Key();
+                _vals()[i].~T();
+            }
+        } else {
+            _table.~table_type();
+        }
+    }
+
+    struct inline_storage
+    {
+        alignas(16) alignas(Key) unsigned char keys[_key_slots * sizeof(Key)];
+        alignas(T) unsigned char vals[N * sizeof(T)];
+    };
+
+    union
+    {
+        inline_storage _inline;
+        table_type _table;
+    };
+    // Number of inline entries, or Hashed.
+    uint32_t _count = 0;
+};
+
+template <class Key, class T, size_t N, class Hash, class KeyEq, class Alloc>
+class small_loatable<Key, T, N, Hash, KeyEq, Alloc>::iterator
+{
+    using table_iterator = typename table_type::iterator;
+    friend class small_loatable;
+
+    constexpr iterator(small_loatable* map, size_t i) noexcept
+      : _map{ map }, _index{ i }
+    {}
+    constexpr explicit iterator(table_iterator it) noexcept : _it{ it } {}
+
+public:
+    constexpr const key_type& key() const noexcept
+    {
+        return _map ? _map->_keys()[_index] : _it.key();
+    }
+    constexpr mapped_type& value() const noexcept
+    {
+        return _map ? _map->_vals()[_index] : _it.value();
+    }
+    constexpr mapped_type& val() const noexcept { return value(); }
+
+    constexpr iterator& operator++() noexcept
+    {
+        if (_map)
+            ++_index;
+        else
+            ++_it;
+        return *this;
+    }
+
+    friend constexpr bool operator==(const iterator& lhs,
+                                     const iterator& rhs) noexcept
+    {
+        return lhs._map == rhs._map &&
+               (lhs._map ? lhs._index == rhs._index : lhs._it == rhs._it);
+    }
+    friend constexpr bool operator!=(const iterator& lhs,
+                                     const iterator& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+
+private:
+    small_loatable* _map = nullptr;
+    size_t _index = 0;
+    table_iterator _it{};
+};
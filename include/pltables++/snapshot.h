@@ -0,0 +1,250 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <type_traits>
+#include <unistd.h>
+
+namespace plt {
+
+// On-disk snapshot of a table's raw arrays, loadable with a single mmap(2).
+//
+// Layout: one header page followed by up to MaxSections sections, each
+// starting on a SnapshotAlignment boundary so the loader can point the table
+// straight into the mapping. Files are written to "<path>.tmp" and renamed
+// into place, so a reader never maps a half-written snapshot.
+//
+// A snapshot is only valid on a machine with the same endianness, word size
+// and key/value layout as the writer; all of that is recorded in the header
+// and checked on load.
+
+constexpr uint32_t SnapshotVersion = 1;
+constexpr size_t SnapshotAlignment = 4096;
+
+enum class SnapshotMode
+{
+    ReadOnly,    // PROT_READ; the table must only be read
+    CopyOnWrite, // private writable mapping; writes never reach the file
+};
+
+// What a snapshot holds; the loader refuses a file of another kind.
+enum class SnapshotKind : uint32_t
+{
+    LoaTable = 1,
+    FrozenTable = 2,
+    Dataset = 3, // a plain array, e.g. benchmark input
+};
+
+struct SnapshotSection
+{
+    uint64_t offset;
+    uint64_t bytes;
+};
+
+struct SnapshotHeader
+{
+    constexpr static size_t MaxSections = 6;
+    constexpr static uint32_t ByteOrderMark = 0x01020304;
+
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t kind;
+    uint32_t word_size;
+    uint32_t key_size;
+    uint32_t key_align;
+    uint32_t val_size;
+    uint32_t val_align;
+    uint64_t hash_id;
+    uint64_t hash_seed;
+    uint64_t file_bytes;
+    // Table-specific counters (e.g. asize, size, used for loatable).
+    uint64_t params[6];
+    uint32_t nsections;
+    uint32_t reserved;
+    SnapshotSection sections[MaxSections];
+};
+static_assert(sizeof(SnapshotHeader) <= SnapshotAlignment);
+static_assert(std::is_trivially_copyable_v<SnapshotHeader>);
+
+// FNV-1a over the compiler's spelling of T. Stable within one toolchain,
+// which is what decides whether two builds hash a key to the same slot.
+template <class T>
+constexpr uint64_t type_fingerprint() noexcept
+{
+    const char* s = __PRETTY_FUNCTION__;
+    uint64_t h = 14695981039346656037ull;
+    for (; *s; ++s) {
+        h ^= static_cast<unsigned char>(*s);
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+namespace detail {
+
+template <class Hash, class = void>
+struct has_seed : std::false_type
+{};
+
+template <class Hash>
+struct has_seed<Hash, std::void_t<decltype(std::declval<const Hash&>().seed())>>
+  : std::true_type
+{};
+
+} // ~detail
+
+// Identifies a hash function across processes. Specialise for hashers whose
+// output is guaranteed stable across builds; the default ties the id to the
+// type and the standard library in use. A hasher exposing `seed()` has its
+// seed recorded too, so a table saved with one seed is rehashed when loaded
+// under another.
+template <class Hash>
+struct hash_identity
+{
+    static uint64_t id() noexcept
+    {
+        uint64_t h = type_fingerprint<Hash>();
+#if defined(_LIBCPP_VERSION)
+        h ^= uint64_t(_LIBCPP_VERSION) << 32;
+#elif defined(__GLIBCXX__)
+        h ^= uint64_t(__GLIBCXX__) << 16;
+#endif
+        return h;
+    }
+
+    static uint64_t seed(const Hash& hash) noexcept
+    {
+        if constexpr (detail::has_seed<Hash>::value)
+            return static_cast<uint64_t>(hash.seed());
+        (void)hash;
+        return 0;
+    }
+};
+
+inline SnapshotHeader snapshot_header(SnapshotKind kind) noexcept
+{
+    SnapshotHeader hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, "PLTSNAP", 8);
+    hdr.version = SnapshotVersion;
+    hdr.byte_order = SnapshotHeader::ByteOrderMark;
+    hdr.kind = static_cast<uint32_t>(kind);
+    hdr.word_size = sizeof(size_t);
+    return hdr;
+}
+
+namespace detail {
+
+inline bool snapshot_pwrite(int fd, const void* buf, size_t bytes,
+                            uint64_t offset) noexcept
+{
+    const char* p = static_cast<const char*>(buf);
+    while (bytes != 0) {
+        ssize_t n = pwrite(fd, p, bytes, static_cast<off_t>(offset));
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        p += n;
+        bytes -= static_cast<size_t>(n);
+        offset += static_cast<uint64_t>(n);
+    }
+    return true;
+}
+
+constexpr uint64_t snapshot_align(uint64_t x) noexcept
+{
+    return (x + SnapshotAlignment - 1) & ~uint64_t(SnapshotAlignment - 1);
+}
+
+} // ~detail
+
+// Write `hdr` and `nsections` buffers to `path`. Section offsets, the section
+// count and the file size are filled in here. Returns false on any I/O error,
+// in which case `path` is left untouched.
+inline bool snapshot_write(const char* path, SnapshotHeader& hdr,
+                           const void* const* data, const size_t* bytes,
+                           size_t nsections) noexcept
+{
+    if (nsections > SnapshotHeader::MaxSections)
+        return false;
+    char tmp[4096];
+    if (snprintf(tmp, sizeof(tmp), "%s.tmp", path) >= int(sizeof(tmp)))
+        return false;
+    int fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+        return false;
+
+    uint64_t offset = SnapshotAlignment;
+    hdr.nsections = static_cast<uint32_t>(nsections);
+    bool ok = true;
+    for (size_t s = 0; s < nsections && ok; ++s) {
+        hdr.sections[s] = SnapshotSection{ offset, bytes[s] };
+        ok = detail::snapshot_pwrite(fd, data[s], bytes[s], offset);
+        offset = detail::snapshot_align(offset + bytes[s]);
+    }
+    hdr.file_bytes = offset;
+    ok = ok && detail::snapshot_pwrite(fd, &hdr, sizeof(hdr), 0) &&
+         ftruncate(fd, static_cast<off_t>(offset)) == 0 && fsync(fd) == 0;
+    ok = close(fd) == 0 && ok;
+    if (ok && rename(tmp, path) == 0)
+        return true;
+    unlink(tmp);
+    return false;
+}
+
+// Map a snapshot. Checks the magic, version, byte order, word size and that
+// every section lies inside the file; the caller checks the rest of the
+// header against its own types. Returns nullptr on failure.
+inline void* snapshot_map(const char* path, SnapshotMode mode,
+                          size_t& bytes) noexcept
+{
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return nullptr;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < off_t(SnapshotAlignment)) {
+        close(fd);
+        return nullptr;
+    }
+    bytes = static_cast<size_t>(st.st_size);
+    const int prot =
+      mode == SnapshotMode::ReadOnly ? PROT_READ : PROT_READ | PROT_WRITE;
+    void* p = mmap(nullptr, bytes, prot, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED)
+        return nullptr;
+
+    const auto* hdr = static_cast<const SnapshotHeader*>(p);
+    bool ok = memcmp(hdr->magic, "PLTSNAP", 8) == 0 &&
+              hdr->version == SnapshotVersion &&
+              hdr->byte_order == SnapshotHeader::ByteOrderMark &&
+              hdr->word_size == sizeof(size_t) && hdr->file_bytes == bytes &&
+              hdr->nsections <= SnapshotHeader::MaxSections;
+    for (uint32_t s = 0; ok && s < hdr->nsections; ++s) {
+        const SnapshotSection& sec = hdr->sections[s];
+        ok = sec.offset % SnapshotAlignment == 0 && sec.offset <= bytes &&
+             sec.bytes <= bytes - sec.offset;
+    }
+    if (!ok) {
+        munmap(p, bytes);
+        return nullptr;
+    }
+    return p;
+}
+
+inline void snapshot_unmap(void* mapping, size_t bytes) noexcept
+{
+    if (mapping)
+        munmap(mapping, bytes);
+}
+
+} // ~plt
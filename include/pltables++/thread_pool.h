@@ -0,0 +1,126 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace plt {
+
+// Fork-join pool for the bulk table operations (parallel build, parallel
+// rehash). `size()` counts the calling thread, which always takes part in
+// parallel_for(), so ThreadPool{1} spawns nothing and runs inline.
+class ThreadPool
+{
+public:
+    explicit ThreadPool(size_t nthreads)
+    {
+        nthreads = nthreads != 0 ? nthreads : 1;
+        _workers.reserve(nthreads - 1);
+        for (size_t i = 1; i < nthreads; ++i)
+            _workers.emplace_back([this]() { _worker_loop(); });
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() noexcept
+    {
+        {
+            std::lock_guard<std::mutex> lock{ _lock };
+            _stop = true;
+        }
+        _wake.notify_all();
+        for (auto& w : _workers)
+            w.join();
+    }
+
+    size_t size() const noexcept { return _workers.size() + 1; }
+
+    // Run fn(i) for every i in [0, n); returns once all calls have finished.
+    // `fn` must not throw. Not reentrant.
+    template <class Fn>
+    void parallel_for(size_t n, Fn&& fn) noexcept
+    {
+        if (_workers.empty() || n <= 1) {
+            for (size_t i = 0; i < n; ++i)
+                fn(i);
+            return;
+        }
+        using FnT = std::remove_reference_t<Fn>;
+        {
+            std::lock_guard<std::mutex> lock{ _lock };
+            _task = const_cast<void*>(static_cast<const void*>(&fn));
+            _invoke = [](void* f, size_t i) { (*static_cast<FnT*>(f))(i); };
+            _count = n;
+            _next.store(0, std::memory_order_relaxed);
+            _busy = _workers.size();
+            ++_generation;
+        }
+        _wake.notify_all();
+        _run_tasks(_task, _invoke, n);
+        std::unique_lock<std::mutex> lock{ _lock };
+        _done.wait(lock, [this]() { return _busy == 0; });
+        _task = nullptr;
+    }
+
+private:
+    using invoke_fn = void (*)(void*, size_t);
+
+    void _run_tasks(void* task, invoke_fn invoke, size_t n) noexcept
+    {
+        for (;;) {
+            const size_t i = _next.fetch_add(1, std::memory_order_relaxed);
+            if (i >= n)
+                break;
+            invoke(task, i);
+        }
+    }
+
+    void _worker_loop() noexcept
+    {
+        uint64_t seen = 0;
+        for (;;) {
+            void* task;
+            invoke_fn invoke;
+            size_t n;
+            {
+                std::unique_lock<std::mutex> lock{ _lock };
+                _wake.wait(lock,
+                           [&]() { return _stop || _generation != seen; });
+                if (_stop)
+                    return;
+                seen = _generation;
+                task = _task;
+                invoke = _invoke;
+                n = _count;
+            }
+            _run_tasks(task, invoke, n);
+            {
+                std::lock_guard<std::mutex> lock{ _lock };
+                assert(_busy > 0);
+                if (--_busy == 0)
+                    _done.notify_one();
+            }
+        }
+    }
+
+    std::vector<std::thread> _workers;
+    std::mutex _lock;
+    std::condition_variable _wake;
+    std::condition_variable _done;
+    void* _task = nullptr;
+    invoke_fn _invoke = nullptr;
+    size_t _count = 0;
+    size_t _busy = 0;
+    uint64_t _generation = 0;
+    std::atomic<size_t> _next{ 0 };
+    bool _stop = false;
+};
+
+} // ~plt
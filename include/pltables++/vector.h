@@ -4,6 +4,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <memory>
+#include <pltables++/memory.h>
 #include <type_traits>
 
 #ifndef restrict
@@ -215,6 +216,12 @@ public:
     constexpr bool is_empty() const noexcept { return _size == 0; }
     constexpr int size() const noexcept { return _size; }
     constexpr int capacity() const noexcept { return _asize; }
+    // Bytes held by the vector, allocator slack included.
+    size_t memory_usage() const noexcept
+    {
+        return sizeof(*this) +
+               plt::malloc_usable_bytes(_data, sizeof(T) * size_t(_asize));
+    }
     constexpr iterator begin() noexcept { return { _data }; }
     constexpr iterator end() noexcept { return { _data + _size }; }
     constexpr const_iterator cbegin() const noexcept { return { _data }; }
@@ -300,7 +307,7 @@ private:
     {
         assert(src != nullptr || size == 0);
         assert(dst != nullptr || size == 0);
-        assert(std::abs(dst - src) > size);
+        assert(dst + size <= src || src + size <= dst);
         // clang-format off
         if constexpr (std::is_trivially_copyable_v<T>) {
             memcpy(dst, src, sizeof(T) * size);
@@ -0,0 +1,313 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <pltables++/linear_open_address.h>
+#include <type_traits>
+#include <utility>
+
+// Map for monotonically increasing integer IDs (exchange order reference
+// numbers) where most entries die young.
+//
+// IDs in [window_base(), window_base() + window()) live in a ring indexed by
+// `id & (window() - 1)` with a presence bitmap: insert, find and erase are a
+// bit test and an array access, no hashing. An insert past the top of the
+// window advances it, first moving the survivors in the slots it is about to
+// reuse into a spill loatable; advancing by k IDs migrates at most k slots,
+// so a steadily increasing ID stream pays O(1) per insert. IDs below the
+// window, whether spilled survivors or late inserts, are kept in the spill
+// table.
+//
+// Not copyable or movable.
+template <class Key, class T, class Hash = std::hash<Key>,
+          class KeyEq = std::equal_to<Key>,
+          class Alloc = loa_default_allocator>
+class window_loatable : private Alloc
+{
+    static_assert(std::is_integral_v<Key>, "window_loatable needs integer IDs");
+    using ukey = std::make_unsigned_t<Key>;
+
+public:
+    using spill_type = loatable<Key, T, Hash, KeyEq, Alloc>;
+    using key_type = Key;
+    using mapped_type = T;
+    using InsertResult = typename spill_type::InsertResult;
+    class iterator;
+
+    constexpr static size_t DefaultWindow = size_t(1) << 16;
+    constexpr static size_t MinWindow = 64;
+
+    static bool insert_failed(InsertResult r) noexcept
+    {
+        return spill_type::insert_failed(r);
+    }
+    static bool item_inserted(InsertResult r) noexcept
+    {
+        return spill_type::item_inserted(r);
+    }
+
+    // `window` is rounded up to a power of 2 no smaller than MinWindow. The
+    // ring is allocated here; valid() is false if that failed.
+    explicit window_loatable(size_t window = DefaultWindow) noexcept
+    {
+        size_t w = MinWindow;
+        while (w < window)
+            w *= 2;
+        Alloc& alloc = *this;
+        _bits = static_cast<uint64_t*>(alloc.allocate(w / 64, sizeof(*_bits)));
+        _vals = static_cast<T*>(alloc.allocate(w, sizeof(T)));
+        if (_bits && _vals) {
+            _mask = w - 1;
+        } else {
+            _free_ring();
+        }
+    }
+    window_loatable(const window_loatable&) = delete;
+    window_loatable& operator=(const window_loatable&) = delete;
+    ~window_loatable() noexcept
+    {
+        _clear_ring();
+        _free_ring();
+    }
+
+    bool valid() const noexcept { return _bits != nullptr; }
+
+    void clear() noexcept
+    {
+        _clear_ring();
+        _spill.clear();
+        _base = 0;
+    }
+
+    size_t size() const noexcept { return _live + _spill.size(); }
+    bool empty() const noexcept { return size() == 0u; }
+    size_t window() const noexcept { return valid() ? _mask + 1 : 0; }
+    key_type window_base() const noexcept { return _base; }
+    // Entries held in the ring and in the spill table.
+    size_t in_window() const noexcept { return _live; }
+    size_t spilled() const noexcept { return _spill.size(); }
+    const spill_type& spill() const noexcept { return _spill; }
+
+    // Bytes held by the map, slack included: the ring, its bitmap and the
+    // spill table (see loatable::memory_usage).
+    size_t memory_usage() const noexcept
+    {
+        const Alloc& alloc = *this;
+        const size_t w = window();
+        return sizeof(*this) - sizeof(_spill) + _spill.memory_usage() +
+               plt::allocated_bytes(alloc, _bits, w / 64, sizeof(*_bits)) +
+               plt::allocated_bytes(alloc, _vals, w, sizeof(T));
+    }
+
+    iterator begin() noexcept
+    {
+        if (_live == 0)
+            return iterator{ this, window(), _spill.begin() };
+        iterator it{ this, 0, _spill.end() };
+        if (!_test(0))
+            ++it;
+        return it;
+    }
+    iterator end() noexcept { return iterator{ this, window(), _spill.end() }; }
+
+    iterator find(const key_type& key) noexcept
+    {
+        if (!valid())
+            return end();
+        const size_t off = _offset(key);
+        if (off <= _mask) {
+            const size_t s = size_t(key) & _mask;
+            return _test(s) ? iterator{ this, s, _spill.end() } : end();
+        }
+        if (key < _base)
+            return iterator{ this, window(), _spill.find(key) };
+        return end();
+    }
+
+    bool contains(const key_type& key) noexcept { return find(key) != end(); }
+
+    template <class... Args>
+    std::pair<iterator, InsertResult> insert(const key_type& key,
+                                             Args&&... args) noexcept
+    {
+        if (!valid())
+            return std::make_pair(end(), InsertResult::Error);
+        if (key < _base) {
+            auto r = _spill.insert(key, std::forward<Args>(args)...);
+            return std::make_pair(iterator{ this, window(), r.first }, r.second);
+        }
+        if (_offset(key) > _mask && !_advance(key_type(ukey(key) - _mask)))
+            return std::make_pair(end(), InsertResult::Error);
+        const size_t s = size_t(key) & _mask;
+        if (_test(s))
+            return std::make_pair(iterator{ this, s, _spill.end() },
+                                  InsertResult::Present);
+        new (&_vals[s]) T(std::forward<Args>(args)...);
+        _bits[s / 64] |= uint64_t(1) << (s % 64);
+        ++_live;
+        return std::make_pair(iterator{ this, s, _spill.end() },
+                              InsertResult::Inserted);
+    }
+
+    size_t erase(const key_type& key) noexcept
+    {
+        if (!valid())
+            return 0u;
+        if (_offset(key) > _mask)
+            return key < _base ? _spill.erase(key) : 0u;
+        const size_t s = size_t(key) & _mask;
+        if (!_test(s))
+            return 0u;
+        _kill(s);
+        return 1u;
+    }
+
+private:
+    // Distance of `key` above the window base; beyond _mask when outside.
+    size_t _offset(const key_type& key) const noexcept
+    {
+        return key < _base ? SIZE_MAX : size_t(ukey(ukey(key) - ukey(_base)));
+    }
+    // The ID held by ring slot `s`.
+    key_type _key_at(size_t s) const noexcept
+    {
+        return key_type(ukey(_base) + ukey((s - size_t(_base)) & _mask));
+    }
+    bool _test(size_t s) const noexcept
+    {
+        return (_bits[s / 64] >> (s % 64)) & 1u;
+    }
+    void _kill(size_t s) noexcept
+    {
+        _vals[s].~T();
+        _bits[s / 64] &= ~(uint64_t(1) << (s % 64));
+        --_live;
+    }
+
+    // Smallest offset in [off, end) above the base whose slot is live, or
+    // `end`. The ring is a multiple of 64 slots, so a bitmap word never
+    // straddles the wrap-around.
+    size_t _next_live_offset(size_t off, size_t end) const noexcept
+    {
+        while (off < end) {
+            const size_t s = (size_t(_base) + off) & _mask;
+            const uint64_t word = _bits[s / 64] >> (s % 64);
+            if (word != 0) {
+                off += size_t(__builtin_ctzll(word));
+                return off < end ? off : end;
+            }
+            off += 64 - s % 64;
+        }
+        return end;
+    }
+
+    // Move the base up to `base`, spilling survivors below it in ID order.
+    // On failure the base stops at the first survivor that could not move.
+    bool _advance(key_type base) noexcept
+    {
+        const size_t dist = size_t(ukey(ukey(base) - ukey(_base)));
+        const size_t end = _live == 0 ? 0 : std::min(dist, _mask + 1);
+        for (size_t off = _next_live_offset(0, end); off != end;
+             off = _next_live_offset(off + 1, end)) {
+            const key_type key = key_type(ukey(_base) + ukey(off));
+            const size_t s = size_t(key) & _mask;
+            if (insert_failed(_spill.insert(key, std::move(_vals[s])).second)) {
+                _base = key;
+                return false;
+            }
+            _kill(s);
+        }
+        _base = base;
+        return true;
+    }
+
+    void _clear_ring() noexcept
+    {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (size_t s = 0; _live != 0 && s <= _mask; ++s)
+                if (_test(s))
+                    _vals[s].~T();
+        }
+        if (_bits)
+            memset(_bits, 0, (_mask + 1) / 64 * sizeof(*_bits));
+        _live = 0;
+    }
+
+    void _free_ring() noexcept
+    {
+        Alloc& alloc = *this;
+        if (_bits)
+            alloc.deallocate(_bits, (_mask + 1) / 64, sizeof(*_bits));
+        if (_vals)
+            alloc.deallocate(_vals, _mask + 1, sizeof(T));
+        _bits = nullptr;
+        _vals = nullptr;
+        _mask = 0;
+    }
+
+    uint64_t* _bits = nullptr;
+    T* _vals = nullptr;
+    size_t _mask = 0;
+    size_t _live = 0;
+    key_type _base = 0;
+    spill_type _spill;
+};
+
+// Visits the ring slots in slot order, then the spill table. Ring positions
+// carry the spill table's end() so they compare unequal to end().
+template <class Key, class T, class Hash, class KeyEq, class Alloc>
+class window_loatable<Key, T, Hash, KeyEq, Alloc>::iterator
+{
+    using spill_iterator = typename spill_type::iterator;
+    friend class window_loatable;
+
+    iterator(window_loatable* map, size_t slot, spill_iterator it) noexcept
+      : _map{ map }, _slot{ slot }, _it{ it }
+    {}
+
+public:
+    // By value: ring slots do not store their ID.
+    key_type key() const noexcept
+    {
+        return _slot < _map->window() ? _map->_key_at(_slot) : _it.key();
+    }
+    mapped_type& value() const noexcept
+    {
+        return _slot < _map->window() ? _map->_vals[_slot] : _it.value();
+    }
+    mapped_type& val() const noexcept { return value(); }
+
+    iterator& operator++() noexcept
+    {
+        const size_t w = _map->window();
+        if (_slot == w) {
+            ++_it;
+            return *this;
+        }
+        while (++_slot != w && !_map->_test(_slot))
+            ;
+        if (_slot == w)
+            _it = _map->_spill.begin();
+        return *this;
+    }
+
+    friend bool operator==(const iterator& lhs, const iterator& rhs) noexcept
+    {
+        return lhs._map == rhs._map && lhs._slot == rhs._slot &&
+               lhs._it == rhs._it;
+    }
+    friend bool operator!=(const iterator& lhs, const iterator& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+
+private:
+    window_loatable* _map = nullptr;
+    size_t _slot = 0;
+    spill_iterator _it{};
+};
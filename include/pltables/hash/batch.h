@@ -0,0 +1,376 @@
+#ifndef PLT_HASH_BATCH__H_
+#define PLT_HASH_BATCH__H_
+
+#include <pltables/hash/fibonacci.h>
+#include <pltables/hash/murmur3.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define PLT_HASH_X86 1
+#include <immintrin.h>
+#endif
+
+/*
+ * Batched hashing: many integer keys at once into masked table indices,
+ *
+ *   plt_hash_fibonacci32_batch   idx[j] = plt_hash_fibonacci32(h[j]) & mask
+ *   plt_hash_fmix32_batch        idx[j] = plt_hash_murmur3_fmix32(k[j]) & mask
+ *   plt_hash_fmix64_batch        idx[j] = plt_hash_murmur3_fmix64(k[j]) & mask
+ *
+ * with 4, 8 or 16 keys per instruction on SSE4.2, AVX2 or AVX-512, picked
+ * at run time from CPUID. The kernels carry target attributes, so no -m
+ * flags are needed, and they give exactly the single-key results: a table
+ * can hash one batch with them and probe it like any other key.
+ * fmix64 multiplies 64-bit lanes with AVX-512DQ and builds the product
+ * from 32-bit multiplies below that, which pays off from AVX2 up.
+ *
+ * PLT_HASH_ISA=scalar|sse4.2|avx2|avx512 in the environment caps the
+ * choice, to compare kernels.
+ */
+
+enum
+{
+    PLT_HASH_ISA_SCALAR = 0,
+    PLT_HASH_ISA_SSE42 = 1,
+    PLT_HASH_ISA_AVX2 = 2,
+    PLT_HASH_ISA_AVX512 = 3,
+};
+
+static inline int plt__hash_isa_cap(void)
+{
+    const char *s = getenv("PLT_HASH_ISA");
+    if (!s || !*s)
+        return PLT_HASH_ISA_AVX512;
+    if (strcmp(s, "scalar") == 0)
+        return PLT_HASH_ISA_SCALAR;
+    if (strcmp(s, "sse4.2") == 0)
+        return PLT_HASH_ISA_SSE42;
+    if (strcmp(s, "avx2") == 0)
+        return PLT_HASH_ISA_AVX2;
+    return PLT_HASH_ISA_AVX512;
+}
+
+/* The widest kernel this CPU runs, detected once per translation unit. */
+static inline int plt_hash_isa(void)
+{
+#if defined(PLT_HASH_X86)
+    static int isa = -1;
+    int v = __atomic_load_n(&isa, __ATOMIC_RELAXED);
+    if (v < 0) {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") &&
+            __builtin_cpu_supports("avx512dq"))
+            v = PLT_HASH_ISA_AVX512;
+        else if (__builtin_cpu_supports("avx2"))
+            v = PLT_HASH_ISA_AVX2;
+        else if (__builtin_cpu_supports("sse4.2"))
+            v = PLT_HASH_ISA_SSE42;
+        else
+            v = PLT_HASH_ISA_SCALAR;
+        const int cap = plt__hash_isa_cap();
+        v = v < cap ? v : cap;
+        __atomic_store_n(&isa, v, __ATOMIC_RELAXED);
+    }
+    return v;
+#else
+    return PLT_HASH_ISA_SCALAR;
+#endif
+}
+
+/* --- Scalar --- */
+
+static inline void plt_hash_fibonacci32_batch_scalar(const uint32_t *h,
+                                                     size_t n, uint32_t mask,
+                                                     uint32_t *idx)
+{
+    for (size_t j = 0; j < n; ++j)
+        idx[j] = plt_hash_fibonacci32(h[j]) & mask;
+}
+
+static inline void plt_hash_fmix32_batch_scalar(const uint32_t *k, size_t n,
+                                                uint32_t mask, uint32_t *idx)
+{
+    for (size_t j = 0; j < n; ++j)
+        idx[j] = plt_hash_murmur3_fmix32(k[j]) & mask;
+}
+
+static inline void plt_hash_fmix64_batch_scalar(const uint64_t *k, size_t n,
+                                                uint64_t mask, uint64_t *idx)
+{
+    for (size_t j = 0; j < n; ++j)
+        idx[j] = plt_hash_murmur3_fmix64(k[j]) & mask;
+}
+
+#if defined(PLT_HASH_X86)
+
+#define PLT__TARGET(isa) __attribute__((target(isa)))
+
+/* --- SSE4.2: 4 x 32 or 2 x 64 bits --- */
+
+PLT__TARGET("sse4.2")
+static inline void plt_hash_fibonacci32_batch_sse42(const uint32_t *h,
+                                                    size_t n, uint32_t mask,
+                                                    uint32_t *idx)
+{
+    const __m128i m = _mm_set1_epi32((int)mask);
+    const __m128i phi = _mm_set1_epi32((int)2654435769u);
+    size_t j = 0;
+    for (; j + 4 <= n; j += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(h + j));
+        v = _mm_and_si128(_mm_mullo_epi32(v, phi), m);
+        _mm_storeu_si128((__m128i *)(idx + j), v);
+    }
+    plt_hash_fibonacci32_batch_scalar(h + j, n - j, mask, idx + j);
+}
+
+PLT__TARGET("sse4.2")
+static inline void plt_hash_fmix32_batch_sse42(const uint32_t *k, size_t n,
+                                               uint32_t mask, uint32_t *idx)
+{
+    const __m128i m = _mm_set1_epi32((int)mask);
+    const __m128i c1 = _mm_set1_epi32((int)0x85ebca6bu);
+    const __m128i c2 = _mm_set1_epi32((int)0xc2b2ae35u);
+    size_t j = 0;
+    for (; j + 4 <= n; j += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(k + j));
+        v = _mm_xor_si128(v, _mm_srli_epi32(v, 16));
+        v = _mm_mullo_epi32(v, c1);
+        v = _mm_xor_si128(v, _mm_srli_epi32(v, 13));
+        v = _mm_mullo_epi32(v, c2);
+        v = _mm_xor_si128(v, _mm_srli_epi32(v, 16));
+        _mm_storeu_si128((__m128i *)(idx + j), _mm_and_si128(v, m));
+    }
+    plt_hash_fmix32_batch_scalar(k + j, n - j, mask, idx + j);
+}
+
+/* Low 64 bits of a * b per lane, from three 32x32->64-bit multiplies. */
+PLT__TARGET("sse4.2")
+static inline __m128i plt__mullo64_sse42(__m128i a, __m128i b)
+{
+    const __m128i lo = _mm_mul_epu32(a, b);
+    const __m128i ahi_blo = _mm_mul_epu32(_mm_srli_epi64(a, 32), b);
+    const __m128i alo_bhi = _mm_mul_epu32(a, _mm_srli_epi64(b, 32));
+    const __m128i cross = _mm_add_epi64(ahi_blo, alo_bhi);
+    return _mm_add_epi64(lo, _mm_slli_epi64(cross, 32));
+}
+
+PLT__TARGET("sse4.2")
+static inline void plt_hash_fmix64_batch_sse42(const uint64_t *k, size_t n,
+                                               uint64_t mask, uint64_t *idx)
+{
+    const __m128i m = _mm_set1_epi64x((long long)mask);
+    const __m128i c1 = _mm_set1_epi64x((long long)0xff51afd7ed558ccdllu);
+    const __m128i c2 = _mm_set1_epi64x((long long)0xc4ceb9fe1a85ec53llu);
+    size_t j = 0;
+    for (; j + 2 <= n; j += 2) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(k + j));
+        v = _mm_xor_si128(v, _mm_srli_epi64(v, 33));
+        v = plt__mullo64_sse42(v, c1);
+        v = _mm_xor_si128(v, _mm_srli_epi64(v, 33));
+        v = plt__mullo64_sse42(v, c2);
+        v = _mm_xor_si128(v, _mm_srli_epi64(v, 33));
+        _mm_storeu_si128((__m128i *)(idx + j), _mm_and_si128(v, m));
+    }
+    plt_hash_fmix64_batch_scalar(k + j, n - j, mask, idx + j);
+}
+
+/* --- AVX2: 8 x 32 or 4 x 64 bits --- */
+
+PLT__TARGET("avx2")
+static inline void plt_hash_fibonacci32_batch_avx2(const uint32_t *h,
+                                                   size_t n, uint32_t mask,
+                                                   uint32_t *idx)
+{
+    const __m256i m = _mm256_set1_epi32((int)mask);
+    const __m256i phi = _mm256_set1_epi32((int)2654435769u);
+    size_t j = 0;
+    for (; j + 8 <= n; j += 8) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(h + j));
+        v = _mm256_and_si256(_mm256_mullo_epi32(v, phi), m);
+        _mm256_storeu_si256((__m256i *)(idx + j), v);
+    }
+    plt_hash_fibonacci32_batch_scalar(h + j, n - j, mask, idx + j);
+}
+
+PLT__TARGET("avx2")
+static inline void plt_hash_fmix32_batch_avx2(const uint32_t *k, size_t n,
+                                              uint32_t mask, uint32_t *idx)
+{
+    const __m256i m = _mm256_set1_epi32((int)mask);
+    const __m256i c1 = _mm256_set1_epi32((int)0x85ebca6bu);
+    const __m256i c2 = _mm256_set1_epi32((int)0xc2b2ae35u);
+    size_t j = 0;
+    for (; j + 8 <= n; j += 8) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(k + j));
+        v = _mm256_xor_si256(v, _mm256_srli_epi32(v, 16));
+        v = _mm256_mullo_epi32(v, c1);
+        v = _mm256_xor_si256(v, _mm256_srli_epi32(v, 13));
+        v = _mm256_mullo_epi32(v, c2);
+        v = _mm256_xor_si256(v, _mm256_srli_epi32(v, 16));
+        _mm256_storeu_si256((__m256i *)(idx + j), _mm256_and_si256(v, m));
+    }
+    plt_hash_fmix32_batch_scalar(k + j, n - j, mask, idx + j);
+}
+
+PLT__TARGET("avx2")
+static inline __m256i plt__mullo64_avx2(__m256i a, __m256i b)
+{
+    const __m256i lo = _mm256_mul_epu32(a, b);
+    const __m256i ahi_blo = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), b);
+    const __m256i alo_bhi = _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32));
+    const __m256i cross = _mm256_add_epi64(ahi_blo, alo_bhi);
+    return _mm256_add_epi64(lo, _mm256_slli_epi64(cross, 32));
+}
+
+PLT__TARGET("avx2")
+static inline void plt_hash_fmix64_batch_avx2(const uint64_t *k, size_t n,
+                                              uint64_t mask, uint64_t *idx)
+{
+    const __m256i m = _mm256_set1_epi64x((long long)mask);
+    const __m256i c1 = _mm256_set1_epi64x((long long)0xff51afd7ed558ccdllu);
+    const __m256i c2 = _mm256_set1_epi64x((long long)0xc4ceb9fe1a85ec53llu);
+    size_t j = 0;
+    for (; j + 4 <= n; j += 4) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(k + j));
+        v = _mm256_xor_si256(v, _mm256_srli_epi64(v, 33));
+        v = plt__mullo64_avx2(v, c1);
+        v = _mm256_xor_si256(v, _mm256_srli_epi64(v, 33));
+        v = plt__mullo64_avx2(v, c2);
+        v = _mm256_xor_si256(v, _mm256_srli_epi64(v, 33));
+        _mm256_storeu_si256((__m256i *)(idx + j), _mm256_and_si256(v, m));
+    }
+    plt_hash_fmix64_batch_scalar(k + j, n - j, mask, idx + j);
+}
+
+/* --- AVX-512: 16 x 32 or 8 x 64 bits --- */
+
+/* GCC 12's AVX-512 shift intrinsics trip -Wmaybe-uninitialized. */
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+PLT__TARGET("avx512f,avx512dq")
+static inline void plt_hash_fibonacci32_batch_avx512(const uint32_t *h,
+                                                     size_t n, uint32_t mask,
+                                                     uint32_t *idx)
+{
+    const __m512i m = _mm512_set1_epi32((int)mask);
+    const __m512i phi = _mm512_set1_epi32((int)2654435769u);
+    size_t j = 0;
+    for (; j + 16 <= n; j += 16) {
+        __m512i v = _mm512_loadu_si512((const void *)(h + j));
+        v = _mm512_and_si512(_mm512_mullo_epi32(v, phi), m);
+        _mm512_storeu_si512((void *)(idx + j), v);
+    }
+    plt_hash_fibonacci32_batch_scalar(h + j, n - j, mask, idx + j);
+}
+
+PLT__TARGET("avx512f,avx512dq")
+static inline void plt_hash_fmix32_batch_avx512(const uint32_t *k, size_t n,
+                                                uint32_t mask, uint32_t *idx)
+{
+    const __m512i m = _mm512_set1_epi32((int)mask);
+    const __m512i c1 = _mm512_set1_epi32((int)0x85ebca6bu);
+    const __m512i c2 = _mm512_set1_epi32((int)0xc2b2ae35u);
+    size_t j = 0;
+    for (; j + 16 <= n; j += 16) {
+        __m512i v = _mm512_loadu_si512((const void *)(k + j));
+        v = _mm512_xor_si512(v, _mm512_srli_epi32(v, 16));
+        v = _mm512_mullo_epi32(v, c1);
+        v = _mm512_xor_si512(v, _mm512_srli_epi32(v, 13));
+        v = _mm512_mullo_epi32(v, c2);
+        v = _mm512_xor_si512(v, _mm512_srli_epi32(v, 16));
+        _mm512_storeu_si512((void *)(idx + j), _mm512_and_si512(v, m));
+    }
+    plt_hash_fmix32_batch_scalar(k + j, n - j, mask, idx + j);
+}
+
+PLT__TARGET("avx512f,avx512dq")
+static inline void plt_hash_fmix64_batch_avx512(const uint64_t *k, size_t n,
+                                                uint64_t mask, uint64_t *idx)
+{
+    const __m512i m = _mm512_set1_epi64((long long)mask);
+    const __m512i c1 = _mm512_set1_epi64((long long)0xff51afd7ed558ccdllu);
+    const __m512i c2 = _mm512_set1_epi64((long long)0xc4ceb9fe1a85ec53llu);
+    size_t j = 0;
+    for (; j + 8 <= n; j += 8) {
+        __m512i v = _mm512_loadu_si512((const void *)(k + j));
+        v = _mm512_xor_si512(v, _mm512_srli_epi64(v, 33));
+        v = _mm512_mullo_epi64(v, c1);
+        v = _mm512_xor_si512(v, _mm512_srli_epi64(v, 33));
+        v = _mm512_mullo_epi64(v, c2);
+        v = _mm512_xor_si512(v, _mm512_srli_epi64(v, 33));
+        _mm512_storeu_si512((void *)(idx + j), _mm512_and_si512(v, m));
+    }
+    plt_hash_fmix64_batch_scalar(k + j, n - j, mask, idx + j);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#undef PLT__TARGET
+
+#endif /* PLT_HASH_X86 */
+
+/* --- Dispatch --- */
+
+static inline void plt_hash_fibonacci32_batch(const uint32_t *h, size_t n,
+                                              uint32_t mask, uint32_t *idx)
+{
+#if defined(PLT_HASH_X86)
+    switch (plt_hash_isa()) {
+        case PLT_HASH_ISA_AVX512:
+            plt_hash_fibonacci32_batch_avx512(h, n, mask, idx);
+            return;
+        case PLT_HASH_ISA_AVX2:
+            plt_hash_fibonacci32_batch_avx2(h, n, mask, idx);
+            return;
+        case PLT_HASH_ISA_SSE42:
+            plt_hash_fibonacci32_batch_sse42(h, n, mask, idx);
+            return;
+    }
+#endif
+    plt_hash_fibonacci32_batch_scalar(h, n, mask, idx);
+}
+
+static inline void plt_hash_fmix32_batch(const uint32_t *k, size_t n,
+                                         uint32_t mask, uint32_t *idx)
+{
+#if defined(PLT_HASH_X86)
+    switch (plt_hash_isa()) {
+        case PLT_HASH_ISA_AVX512:
+            plt_hash_fmix32_batch_avx512(k, n, mask, idx);
+            return;
+        case PLT_HASH_ISA_AVX2:
+            plt_hash_fmix32_batch_avx2(k, n, mask, idx);
+            return;
+        case PLT_HASH_ISA_SSE42:
+            plt_hash_fmix32_batch_sse42(k, n, mask, idx);
+            return;
+    }
+#endif
+    plt_hash_fmix32_batch_scalar(k, n, mask, idx);
+}
+
+static inline void plt_hash_fmix64_batch(const uint64_t *k, size_t n,
+                                         uint64_t mask, uint64_t *idx)
+{
+#if defined(PLT_HASH_X86)
+    switch (plt_hash_isa()) {
+        case PLT_HASH_ISA_AVX512:
+            plt_hash_fmix64_batch_avx512(k, n, mask, idx);
+            return;
+        case PLT_HASH_ISA_AVX2:
+            plt_hash_fmix64_batch_avx2(k, n, mask, idx);
+            return;
+        /* Two lanes of emulated 64-bit multiplies only match scalar. */
+    }
+#endif
+    plt_hash_fmix64_batch_scalar(k, n, mask, idx);
+}
+
+#endif
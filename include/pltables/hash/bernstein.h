@@ -0,0 +1,21 @@
+#ifndef PLT_HASH_BERNSTEIN__H_
+#define PLT_HASH_BERNSTEIN__H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Bernstein's djb2 (h = 33 * h + c); the classic seed is 5381. As weak as
+ * X31 and kept for comparison.
+ */
+
+static inline uint32_t plt_hash_bernstein(const void *key, size_t len,
+                                          uint32_t seed)
+{
+    const uint8_t *p = (const uint8_t *)key;
+    for (size_t i = 0; i < len; ++i)
+        seed = 33 * seed + p[i];
+    return seed;
+}
+
+#endif
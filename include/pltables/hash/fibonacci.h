@@ -0,0 +1,23 @@
+#ifndef PLT_HASH_FIBONACCI__H_
+#define PLT_HASH_FIBONACCI__H_
+
+#include <stdint.h>
+
+/*
+ * Fibonacci hashing: multiplication by 2^w / phi. One multiply, but the
+ * mixing only runs upwards, so the entropy gathers in the high bits: index
+ * with h >> (w - log2(buckets)). Masking off the low bits, as qoatable does,
+ * keeps the low bits of the key.
+ */
+
+static inline uint32_t plt_hash_fibonacci32(uint32_t h)
+{
+    return h * 2654435769u;
+}
+
+static inline uint64_t plt_hash_fibonacci64(uint64_t h)
+{
+    return h * 11400714819323198485llu;
+}
+
+#endif
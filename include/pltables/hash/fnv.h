@@ -0,0 +1,36 @@
+#ifndef PLT_HASH_FNV__H_
+#define PLT_HASH_FNV__H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * FNV-1a: xor in a byte, multiply by the FNV prime. A seed of 0 gives the
+ * reference values; others are xored into the offset basis.
+ */
+
+static inline uint32_t plt_hash_fnv1a32(const void *key, size_t len,
+                                        uint32_t seed)
+{
+    const uint8_t *p = (const uint8_t *)key;
+    uint32_t h = 2166136261u ^ seed;
+    for (size_t i = 0; i < len; ++i) {
+        h ^= p[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static inline uint64_t plt_hash_fnv1a64(const void *key, size_t len,
+                                        uint64_t seed)
+{
+    const uint8_t *p = (const uint8_t *)key;
+    uint64_t h = 14695981039346656037llu ^ seed;
+    for (size_t i = 0; i < len; ++i) {
+        h ^= p[i];
+        h *= 1099511628211llu;
+    }
+    return h;
+}
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef PLT_HASH__H_
+#define PLT_HASH__H_
+
+/*
+ * Hash functions for the tables, in one place. Each header stands alone.
+ *
+ *   integers   plt_hash_wang32/64            shifts and adds only
+ *              plt_hash_fibonacci32/64       one multiply; high bits only
+ *              plt_hash_murmur3_fmix32/64    two multiplies, full avalanche
+ *              plt_hash_wymix64              one 128-bit multiply-fold
+ *              plt_hash_crc32c_u64           CRC instruction + multiply
+ *   bytes      plt_hash_x31, _x31_bytes      khash's string hash
+ *              plt_hash_bernstein            djb2
+ *              plt_hash_fnv1a32/64           byte at a time
+ *              plt_hash_murmur3_32           4 bytes at a time
+ *              plt_hash_wy                   8-16 bytes at a time
+ *              plt_crc32c                    8 bytes at a time (checksum)
+ *   batches    plt_hash_*_batch              many keys to masked indices
+ *                                            with SSE4.2/AVX2/AVX-512
+ *
+ * tests/test_hash.cpp checks their avalanche and bucket distribution under
+ * power-of-two masks, and bench-hash measures their throughput.
+ */
+
+#include <pltables/hash/batch.h>
+#include <pltables/hash/bernstein.h>
+#include <pltables/hash/crc32c.h>
+#include <pltables/hash/fibonacci.h>
+#include <pltables/hash/fnv.h>
+#include <pltables/hash/murmur3.h>
+#include <pltables/hash/wang.h>
+#include <pltables/hash/wyhash.h>
+#include <pltables/hash/x31.h>
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef PLT_HASH_MURMUR3__H_
+#define PLT_HASH_MURMUR3__H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * MurmurHash3 (Austin Appleby, public domain): the x86_32 byte hash and its
+ * finalizers, which on their own make good integer hashes.
+ */
+
+static inline uint32_t plt_hash_murmur3_fmix32(uint32_t h)
+{
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+    return h;
+}
+
+static inline uint64_t plt_hash_murmur3_fmix64(uint64_t k)
+{
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdllu;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53llu;
+    k ^= k >> 33;
+    return k;
+}
+
+static inline uint32_t plt__murmur3_rotl32(uint32_t x, int r)
+{
+    return (x << r) | (x >> (32 - r));
+}
+
+static inline uint32_t plt_hash_murmur3_32(const void *key, size_t len,
+                                           uint32_t seed)
+{
+    const uint8_t *p = (const uint8_t *)key;
+    const uint32_t c1 = 0xcc9e2d51u;
+    const uint32_t c2 = 0x1b873593u;
+    const size_t nblocks = len / 4;
+    uint32_t h = seed;
+    uint32_t k;
+
+    for (size_t i = 0; i < nblocks; ++i) {
+        memcpy(&k, p + i * 4, sizeof(k));
+        k *= c1;
+        k = plt__murmur3_rotl32(k, 15);
+        k *= c2;
+        h ^= k;
+        h = plt__murmur3_rotl32(h, 13);
+        h = h * 5 + 0xe6546b64u;
+    }
+
+    const uint8_t *tail = p + nblocks * 4;
+    k = 0;
+    switch (len & 3) {
+        case 3:
+            k ^= (uint32_t)tail[2] << 16;
+            /* fall through */
+        case 2:
+            k ^= (uint32_t)tail[1] << 8;
+            /* fall through */
+        case 1:
+            k ^= tail[0];
+            k *= c1;
+            k = plt__murmur3_rotl32(k, 15);
+            k *= c2;
+            h ^= k;
+    }
+
+    h ^= (uint32_t)len;
+    return plt_hash_murmur3_fmix32(h);
+}
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef PLT_HASH_WANG__H_
+#define PLT_HASH_WANG__H_
+
+#include <stdint.h>
+
+/*
+ * Thomas Wang's integer hashes: shift-add-xor rounds, no multiplies. The
+ * 32-bit one is khash's __ac_Wang_hash.
+ */
+
+static inline uint32_t plt_hash_wang32(uint32_t key)
+{
+    key += ~(key << 15);
+    key ^= (key >> 10);
+    key += (key << 3);
+    key ^= (key >> 6);
+    key += ~(key << 11);
+    key ^= (key >> 16);
+    return key;
+}
+
+static inline uint64_t plt_hash_wang64(uint64_t key)
+{
+    key = ~key + (key << 21);
+    key ^= key >> 24;
+    key = key + (key << 3) + (key << 8);
+    key ^= key >> 14;
+    key = key + (key << 2) + (key << 4);
+    key ^= key >> 28;
+    key += key << 31;
+    return key;
+}
+
+#endif
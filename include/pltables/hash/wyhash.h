@@ -0,0 +1,124 @@
+#ifndef PLT_HASH_WYHASH__H_
+#define PLT_HASH_WYHASH__H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * A wyhash-style hash (after Wang Yi's wyhash, public domain): whole 8- and
+ * 4-byte reads folded by 64x64->128-bit multiplies, the high half xored
+ * into the low. Short keys cost three multiplies, so it is the fast
+ * general-purpose choice here. Not wyhash's reference output.
+ */
+
+static const uint64_t plt__wyp[4] = {
+    0x2d358dccaa6c78a5llu,
+    0x8bb84b93962eacc9llu,
+    0x4b33a62ed433d4a3llu,
+    0x4d5a2da51de1aa47llu,
+};
+
+/* *a, *b = low, high half of *a * *b */
+static inline void plt__wymum(uint64_t *a, uint64_t *b)
+{
+#if defined(__SIZEOF_INT128__)
+    __uint128_t r = (__uint128_t)*a * *b;
+    *a = (uint64_t)r;
+    *b = (uint64_t)(r >> 64);
+#else
+    uint64_t ha = *a >> 32, hb = *b >> 32;
+    uint64_t la = (uint32_t)*a, lb = (uint32_t)*b;
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    uint64_t t = rl + (rm0 << 32);
+    uint64_t c = t < rl;
+    uint64_t lo = t + (rm1 << 32);
+    c += lo < t;
+    *a = lo;
+    *b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+static inline uint64_t plt__wymix(uint64_t a, uint64_t b)
+{
+    plt__wymum(&a, &b);
+    return a ^ b;
+}
+
+static inline uint64_t plt__wyr8(const uint8_t *p)
+{
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint64_t plt__wyr4(const uint8_t *p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+/* 1 to 3 bytes: first, middle and last */
+static inline uint64_t plt__wyr3(const uint8_t *p, size_t k)
+{
+    return ((uint64_t)p[0] << 16) | ((uint64_t)p[k >> 1] << 8) | p[k - 1];
+}
+
+static inline uint64_t plt_hash_wy(const void *key, size_t len, uint64_t seed)
+{
+    const uint8_t *p = (const uint8_t *)key;
+    uint64_t a, b;
+    seed ^= plt__wymix(seed ^ plt__wyp[0], plt__wyp[1]);
+    if (len <= 16) {
+        if (len >= 4) {
+            const size_t mid = (len >> 3) << 2;
+            a = (plt__wyr4(p) << 32) | plt__wyr4(p + mid);
+            b = (plt__wyr4(p + len - 4) << 32) | plt__wyr4(p + len - 4 - mid);
+        } else if (len > 0) {
+            a = plt__wyr3(p, len);
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = len;
+        if (i > 48) {
+            uint64_t see1 = seed, see2 = seed;
+            do {
+                seed = plt__wymix(plt__wyr8(p) ^ plt__wyp[1],
+                                  plt__wyr8(p + 8) ^ seed);
+                see1 = plt__wymix(plt__wyr8(p + 16) ^ plt__wyp[2],
+                                  plt__wyr8(p + 24) ^ see1);
+                see2 = plt__wymix(plt__wyr8(p + 32) ^ plt__wyp[3],
+                                  plt__wyr8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16) {
+            seed = plt__wymix(plt__wyr8(p) ^ plt__wyp[1],
+                              plt__wyr8(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = plt__wyr8(p + i - 16);
+        b = plt__wyr8(p + i - 8);
+    }
+    a ^= plt__wyp[1];
+    b ^= seed;
+    plt__wymum(&a, &b);
+    return plt__wymix(a ^ plt__wyp[0] ^ len, b ^ plt__wyp[1]);
+}
+
+/* One 64-bit key: a single folded multiply after keying both halves. */
+static inline uint64_t plt_hash_wymix64(uint64_t key)
+{
+    uint64_t a = key ^ plt__wyp[0];
+    uint64_t b = (key >> 32 | key << 32) ^ plt__wyp[1];
+    plt__wymum(&a, &b);
+    return plt__wymix(a ^ plt__wyp[2], b ^ plt__wyp[3]);
+}
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef PLT_HASH_X31__H_
+#define PLT_HASH_X31__H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * X31 (h = 31 * h + c), khash's and qoatable's string hash. Cheap, but
+ * short keys only reach the low bits.
+ */
+
+static inline uint32_t plt_hash_x31(const char *s)
+{
+    uint32_t h = 0;
+    for (; *s; ++s)
+        h = (h << 5) - h + (uint32_t)*s;
+    return h;
+}
+
+static inline uint32_t plt_hash_x31_bytes(const void *key, size_t len)
+{
+    const char *p = (const char *)key;
+    uint32_t h = 0;
+    for (size_t i = 0; i < len; ++i)
+        h = (h << 5) - h + (uint32_t)p[i];
+    return h;
+}
+
+#endif
@@ -1,8 +1,10 @@
 #pragma once
 
+#include <cassert>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
+#include <pltables++/memory.h>
 #include <type_traits>
 
 template <class T>
@@ -63,6 +65,19 @@ public:
     constexpr int32_t size() const noexcept { return h->size; }
     constexpr bool empty() const noexcept { return h->size == 0; }
 
+    // Bytes held by the table, malloc slack included.
+    size_t memory_usage() const noexcept
+    {
+        if (!h)
+            return sizeof(*this);
+        const size_t n = size_t(h->n_buckets);
+        return sizeof(*this) + plt::malloc_usable_bytes(h, sizeof(*h)) +
+               plt::malloc_usable_bytes(
+                 h->flags, n ? __ac_fsize(n) * sizeof(int32_t) : 0) +
+               plt::malloc_usable_bytes(h->keys, n * sizeof(key_type)) +
+               plt::malloc_usable_bytes(h->vals, n * sizeof(value_type));
+    }
+
     void clear() noexcept
     {
         if (h && h->flags) {
@@ -274,8 +289,11 @@ public:
 private:
     constexpr int32_t _advance_index(int32_t i) const noexcept
     {
-        // TODO: implement
-        return i + 1;
+        for (++i; i < h->n_buckets; ++i) {
+            if (!__ac_iseither(h->flags, i))
+                break;
+        }
+        return i;
     }
 
     static constexpr uint32_t _roundup(uint32_t x) noexcept
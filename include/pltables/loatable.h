@@ -2,9 +2,13 @@
 #define LOATABLE__H_
 
 #include <assert.h>
+#include <pltables/hash/fibonacci.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
 
 /* --- User Defines --- */
 
@@ -59,6 +63,12 @@ typedef struct loaresult_s loaresult;
 #define loafree(ptr, size) free(ptr)
 #define loareallocarray(ptr, nmemb, size) reallocarray(ptr, nmemb, size)
 #define loafreearray(ptr, nmemb, size) free(ptr)
+#if defined(__GLIBC__)
+#define loausablesize(ptr, size) \
+    ((ptr) ? malloc_usable_size((void *)(ptr)) : 0)
+#else
+#define loausablesize(ptr, size) ((ptr) ? (size_t)(size) : 0)
+#endif
 #define loaswap(x, y, t)                                                       \
     do {                                                                       \
         t = x;                                                                 \
@@ -70,10 +80,10 @@ typedef struct loaresult_s loaresult;
 const static int LOA_MINSIZE = 4;
 
 uint64_t loa_fibonacci_hash64(uint64_t h) {
-    return h * 11400714819323198485llu;
+    return plt_hash_fibonacci64(h);
 }
 uint32_t loa_fibonacci_hash32(uint32_t h) {
-    return h * 2654435769u;
+    return plt_hash_fibonacci32(h);
 }
 int loa_maxloadfactor(int asize)
 {
@@ -179,6 +189,66 @@ void loadestroy(loatable *t)
     }
 }
 
+/* Bytes held by the table, allocator slack included. The struct itself is
+ * counted as sizeof(loatable): it may be caller-owned (see loainit). */
+size_t loamemoryusage(const loatable *t)
+{
+    return sizeof(loatable) +
+           loausablesize(t->flgs, loa_fsize(t->asize) * sizeof(flg_t)) +
+           loausablesize(t->keys, t->asize * sizeof(key_t)) +
+           loausablesize(t->vals, t->asize * sizeof(val_t));
+}
+
+/* Doubling special case of loaresizefast(). With masked indexing an entry
+ * whose old home is h can only move to h or h + oldasize, so the old table is
+ * walked in slot order -- starting past a never-used slot so clusters that
+ * wrap around the end come after their heads -- and copied out of place.
+ * The new arrays are then written as two forward-moving streams instead of
+ * the scattered swaps of the in-place kick-out rehash. */
+int loaresizedouble(loatable *t)
+{
+    flg_t *flgs, *oldflgs = t->flgs;
+    key_t *keys, *oldkeys = t->keys;
+    val_t *vals, *oldvals = t->vals;
+    int i, j, n, start, oldasize = t->asize;
+    int oldmask = oldasize - 1, mask = 2 * oldasize - 1;
+    assert(oldasize >= LOA_MINSIZE);
+    flgs = (flg_t *)loacalloc(loa_fsize(2 * oldasize), sizeof(flg_t));
+    keys = (key_t *)loacalloc(2 * oldasize, sizeof(key_t));
+    vals = (val_t *)loacalloc(2 * oldasize, sizeof(val_t));
+    if (!flgs || !keys || !vals) {
+        free(flgs);
+        free(keys);
+        free(vals);
+        return -1;
+    }
+    for (start = 0; start < oldasize; ++start) {
+        if (loa_isdead(oldflgs, start))
+            break;
+    }
+    for (n = 1; n <= oldasize; ++n) {
+        j = (start + n) & oldmask;
+        if (!loa_islive(oldflgs, j))
+            continue;
+        i = loahash(oldkeys[j]) & mask;
+        while (!loa_isdead(flgs, i))
+            i = (i + 1) & mask;
+        loa_setlive(flgs, i);
+        keys[i] = oldkeys[j];
+        vals[i] = oldvals[j];
+    }
+    loafreearray(oldflgs, loa_fsize(oldasize), sizeof(flg_t));
+    loafreearray(oldkeys, oldasize, sizeof(key_t));
+    loafreearray(oldvals, oldasize, sizeof(val_t));
+    t->flgs = flgs;
+    t->keys = keys;
+    t->vals = vals;
+    t->asize = 2 * oldasize;
+    t->used = t->size;
+    t->ubnd = loa_maxloadfactor(t->asize);
+    return 0;
+}
+
 int loaresizefast(loatable *t, int newasize)
 {
     flg_t *flgs, *oldflgs = t->flgs;
@@ -186,6 +256,8 @@ int loaresizefast(loatable *t, int newasize)
     val_t val, tmpval, *vals;
     int i, j, mask, oldasize = t->asize;
     newasize = newasize >= LOA_MINSIZE ? newasize : LOA_MINSIZE;
+    if (oldasize != 0 && newasize == 2 * oldasize)
+        return loaresizedouble(t);
     assert((newasize & (newasize - 1)) == 0);
     assert(newasize >= LOA_MINSIZE);
     assert(t->size <= loa_maxloadfactor(newasize));
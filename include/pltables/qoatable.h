@@ -2,9 +2,16 @@
 #define QOATABLE__H_
 
 #include <assert.h>
+#include <pltables/hash/batch.h>
+#include <pltables/hash/fibonacci.h>
+#include <pltables/hash/wang.h>
+#include <pltables/hash/x31.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
 
 /*
  * Quadratic Probing Open Addressing Hash Table
@@ -30,12 +37,17 @@
 #define qoa_key(name, t, iter) qoa_key_##name(t, iter)
 #define qoa_val(name, t, iter) qoa_val_##name(t, iter)
 #define qoa_get(name, t, key) qoa_get_##name(t, key)
+#define qoa_get_batch(name, t, keys, n, iters)                                 \
+    qoa_get_batch_##name(t, keys, n, iters)
+#define qoa_insert_batch(name, t, keys, n, results)                            \
+    qoa_insert_batch_##name(t, keys, n, results)
 #define qoa_find(name, t, key) qoa_find_##name(t, key)
 #define qoa_end(name, t) qoa_end_##name(t)
 #define qoa_del(name, t, iter) qoa_del_##name(t, iter)
 #define qoa_erase(name, t, key) qoa_erase_##name(t, key)
 #define qoa_erase2(name, t, key, dtor) qoa_erase2_##name(t, key, dtor)
 #define qoa_isempty(name, t) qoa_isempty_##name(t)
+#define qoa_memory_usage(name, t) qoa_memory_usage_##name(t)
 
 /* --- Type Creation API --- */
 
@@ -66,19 +78,33 @@
 
 /* --- Common Hash Functions --- */
 
+/*
+ * qoa__hashxform_batch(h, n, mask, idx) sets idx[j] to qoa__hashxform(h[j])
+ * & mask, several per instruction where the CPU allows.
+ */
 #ifdef USE_FIBONACCI_HASHING
 #define qoa__hashxform(x) qoa_fibonacci_hash32(x)
+#define qoa__hashxform_batch(h, n, mask, idx)                                  \
+    plt_hash_fibonacci32_batch(h, n, mask, idx)
 #else
 #define qoa__hashxform(x) x
+static inline void qoa__hashxform_batch(const uint32_t *h, size_t n,
+                                        uint32_t mask, uint32_t *idx)
+{
+    for (size_t j = 0; j < n; ++j)
+        idx[j] = h[j] & mask;
+}
 #endif
 
+/* See pltables/hash for these and more. */
+
 static inline uint64_t qoa_fibonacci_hash64(uint64_t h)
 {
-    return h * 11400714819323198485llu;
+    return plt_hash_fibonacci64(h);
 }
 static inline uint32_t qoa_fibonacci_hash32(uint32_t h)
 {
-    return h * 2654435769u;
+    return plt_hash_fibonacci32(h);
 }
 static inline int qoa_i32_hash_identity(int key)
 {
@@ -87,22 +113,12 @@ static inline int qoa_i32_hash_identity(int key)
 
 static inline int qoa_str_hash_X31(const char *s)
 {
-    int h = (int)*s;
-    if (h)
-        for (++s; *s; ++s)
-            h = (h << 5) - h + (int)*s;
-    return h;
+    return (int)plt_hash_x31(s);
 }
 
 static inline int qoa_i32_hash_Wang(int key)
 {
-    key += ~(key << 15);
-    key ^= (key >> 10);
-    key += (key << 3);
-    key ^= (key >> 6);
-    key += ~(key << 11);
-    key ^= (key >> 16);
-    return key;
+    return (int)plt_hash_wang32((uint32_t)key);
 }
 
 /* --- Common Equality Functions --- */
@@ -142,7 +158,22 @@ static inline int qoa_str_eq(const char *a, const char *b)
 #define qoa_free(ptr, size) free(ptr)
 #define qoa_reallocarray(ptr, nmemb, size) reallocarray(ptr, nmemb, size)
 #define qoa_freearray(ptr, nmemb, size) free(ptr)
+/* bytes reserved for a block of `size` bytes, allocator slack included */
+#if defined(__GLIBC__)
+#define qoa_usable_size(ptr, size)                                             \
+    ((ptr) ? malloc_usable_size((void *)(ptr)) : 0)
+#else
+#define qoa_usable_size(ptr, size) ((ptr) ? (size_t)(size) : 0)
+#endif
 #define QOA_MIN_TABLE_SIZE 4
+/* Keys hashed and prefetched together by qoa_get_batch/qoa_insert_batch. */
+#define QOA_BATCH_BLOCK 32
+
+#if defined(__GNUC__)
+#define qoa__prefetch(addr, rw) __builtin_prefetch(addr, rw)
+#else
+#define qoa__prefetch(addr, rw) ((void)(addr))
+#endif
 // #define qoa__max_load_factor(asize) ((int)(0.77 * (asize) + 0.5))
 static inline int qoa__max_load_factor(int asize)
 {
@@ -272,14 +303,22 @@ typedef struct qoaresult_s qoaresult;
     extern val_t *qoa_val_##name(const table_t *t, qoaiter iter);              \
     extern qoaiter qoa_get_##name(const table_t *t, key_t key);                \
     extern qoaiter qoa_find_##name(const table_t *t, key_t key);               \
+    extern void qoa_get_batch_##name(const table_t *t, const key_t *keys,      \
+                                     int n, qoaiter *iters);                   \
+    extern int qoa_insert_batch_##name(table_t *t, const key_t *keys, int n,   \
+                                       qoaresult *results);                    \
     extern qoaiter qoa_end_##name(const table_t *t);                           \
     extern void qoa_del_##name(table_t *t, qoaiter iter);                      \
     extern int qoa_erase_##name(table_t *t, key_t key);                        \
     extern int qoa_erase2_##name(table_t *t, key_t key, dtor_t dtor);          \
-    extern int qoa_isempty_##name(const table_t *t);
+    extern int qoa_isempty_##name(const table_t *t);                           \
+    extern size_t qoa_memory_usage_##name(const table_t *t);
 
 #define QOA__IMPLS(name, scope, table_t, key_t, val_t, qoa__hash, qoa__eq)     \
                                                                                \
+    scope qoaresult qoa__insert_at_##name(table_t *t, key_t key, int i);       \
+    scope qoaiter qoa__get_at_##name(const table_t *t, key_t key, int i);      \
+                                                                               \
     scope table_t *qoa_create_##name()                                         \
     {                                                                          \
         return (table_t *)qoa_calloc(1, sizeof(table_t));                      \
@@ -397,9 +436,7 @@ typedef struct qoaresult_s qoaresult;
     scope qoaresult qoa_insert_##name(table_t *t, key_t key)                   \
     {                                                                          \
         qoaresult res;                                                         \
-        uint32_t *flags;                                                       \
-        key_t *keys;                                                           \
-        int x, k, i, site, last, step, mask, asize = t->asize;                 \
+        int k, asize = t->asize;                                               \
         if (t->used >= t->upbnd) {                                             \
             int newasize = asize > 2 * t->size ? asize : 2 * asize;            \
             newasize =                                                         \
@@ -411,30 +448,42 @@ typedef struct qoaresult_s qoaresult;
             }                                                                  \
             asize = t->asize;                                                  \
         }                                                                      \
-        mask = asize - 1;                                                      \
-        flags = t->flags;                                                      \
-        keys = t->keys;                                                        \
+        k = qoa__hashxform(qoa__hash(key));                                    \
+        return qoa__insert_at_##name(t, key, k & (asize - 1));                 \
+    }                                                                          \
+                                                                               \
+    /* The probe of qoa_insert from home slot i, once there is room. */        \
+    scope qoaresult qoa__insert_at_##name(table_t *t, key_t key, int i)        \
+    {                                                                          \
+        qoaresult res;                                                         \
+        uint32_t *flags = t->flags;                                            \
+        key_t *keys = t->keys;                                                 \
+        int x, site, last, step, asize = t->asize, mask = asize - 1;           \
         step = 0;                                                              \
         x = site = asize;                                                      \
-        k = qoa__hashxform(qoa__hash(key));                                    \
-        i = k & mask;                                                          \
         if (qoa__isempty(flags, i)) {                                          \
             x = i;                                                             \
         } else {                                                               \
+            /* The key may sit past a deleted slot: the first one is only */   \
+            /* reused once the probe reaches an empty slot.              */    \
             last = i;                                                          \
-            while (qoa__islive(flags, i) &&                                    \
-                   (qoa__isdel(flags, i) || !qoa__eq(keys[i], key))) {         \
-                if (qoa__isdel(flags, i))                                      \
-                    site = i;                                                  \
+            for (;;) {                                                         \
+                if (qoa__isempty(flags, i)) {                                  \
+                    x = site != asize ? site : i;                              \
+                    break;                                                     \
+                } else if (qoa__isdel(flags, i)) {                             \
+                    if (site == asize)                                         \
+                        site = i;                                              \
+                } else if (qoa__eq(keys[i], key)) {                            \
+                    x = i;                                                     \
+                    break;                                                     \
+                }                                                              \
                 i = (i + (++step)) & mask;                                     \
                 if (i == last) {                                               \
                     x = site;                                                  \
                     break;                                                     \
                 }                                                              \
             }                                                                  \
-            if (x == asize) {                                                  \
-                x = qoa__isempty(flags, i) && site != asize ? site : i;        \
-            }                                                                  \
         }                                                                      \
         if (qoa__isempty(flags, x)) {                                          \
             keys[x] = key;                                                     \
@@ -477,15 +526,19 @@ typedef struct qoaresult_s qoaresult;
                                                                                \
     scope qoaiter qoa_get_##name(const table_t *t, key_t key)                  \
     {                                                                          \
-        const uint32_t *flags = t->flags;                                      \
-        const key_t *keys = t->keys;                                           \
-        int k, i, last, step, mask = t->asize - 1;                             \
+        int k;                                                                 \
         if (!t->asize)                                                         \
             return 0;                                                          \
-        step = 0;                                                              \
         k = qoa__hashxform(qoa__hash(key));                                    \
-        i = k & mask;                                                          \
-        last = i;                                                              \
+        return qoa__get_at_##name(t, key, k & (t->asize - 1));                 \
+    }                                                                          \
+                                                                               \
+    /* The probe of qoa_get from home slot i. */                               \
+    scope qoaiter qoa__get_at_##name(const table_t *t, key_t key, int i)       \
+    {                                                                          \
+        const uint32_t *flags = t->flags;                                      \
+        const key_t *keys = t->keys;                                           \
+        int last = i, step = 0, mask = t->asize - 1;                           \
         /* TODO: switch is more readable? */                                   \
         for (;;) {                                                             \
             if (qoa__isempty(flags, i))                                        \
@@ -510,6 +563,82 @@ typedef struct qoaresult_s qoaresult;
         return qoa_get_##name(t, key);                                         \
     }                                                                          \
                                                                                \
+    /*                                                                         \
+     * Home slots of a block of keys: the user's hash one key at a time, then  \
+     * the transform and mask for the whole block at once.                     \
+     */                                                                        \
+    scope void qoa__home_slots_##name(const table_t *t, const key_t *keys,     \
+                                      int m, uint32_t *idx)                    \
+    {                                                                          \
+        uint32_t h[QOA_BATCH_BLOCK];                                           \
+        int j;                                                                 \
+        for (j = 0; j < m; ++j)                                                \
+            h[j] = (uint32_t)qoa__hash(keys[j]);                               \
+        qoa__hashxform_batch(h, (size_t)m, t->asize - 1, idx);                 \
+    }                                                                          \
+                                                                               \
+    /*                                                                         \
+     * iters[j] = qoa_get(keys[j]) for j < n. A block's home slots are all     \
+     * computed and prefetched before any is probed, so its cache misses       \
+     * overlap.                                                                \
+     */                                                                        \
+    scope void qoa_get_batch_##name(const table_t *t, const key_t *keys,       \
+                                    int n, qoaiter *iters)                     \
+    {                                                                          \
+        uint32_t idx[QOA_BATCH_BLOCK];                                         \
+        int j, m;                                                              \
+        if (!t->asize) {                                                       \
+            for (j = 0; j < n; ++j)                                            \
+                iters[j] = 0;                                                  \
+            return;                                                            \
+        }                                                                      \
+        for (; n > 0; n -= m, keys += m, iters += m) {                         \
+            m = n < QOA_BATCH_BLOCK ? n : QOA_BATCH_BLOCK;                     \
+            qoa__home_slots_##name(t, keys, m, idx);                           \
+            for (j = 0; j < m; ++j) {                                          \
+                qoa__prefetch(&t->flags[idx[j] >> 4], 0);                      \
+                qoa__prefetch(&t->keys[idx[j]], 0);                            \
+            }                                                                  \
+            for (j = 0; j < m; ++j)                                            \
+                iters[j] = qoa__get_at_##name(t, keys[j], (int)idx[j]);        \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    /*                                                                         \
+     * qoa_insert of keys[0..n) in order, results[j] (if not NULL) receiving   \
+     * each outcome. Blocks go as in qoa_get_batch, except one that could      \
+     * fill the table, which is inserted key by key so the table can grow.     \
+     * Returns -1 if any insert failed, 0 otherwise.                           \
+     */                                                                        \
+    scope int qoa_insert_batch_##name(table_t *t, const key_t *keys, int n,    \
+                                      qoaresult *results)                      \
+    {                                                                          \
+        uint32_t idx[QOA_BATCH_BLOCK];                                         \
+        qoaresult r;                                                           \
+        int j, m, fits, ret = 0;                                               \
+        for (; n > 0; n -= m, keys += m) {                                     \
+            m = n < QOA_BATCH_BLOCK ? n : QOA_BATCH_BLOCK;                     \
+            fits = t->asize && t->used + m < t->upbnd;                         \
+            if (fits) {                                                        \
+                qoa__home_slots_##name(t, keys, m, idx);                       \
+                for (j = 0; j < m; ++j) {                                      \
+                    qoa__prefetch(&t->flags[idx[j] >> 4], 1);                  \
+                    qoa__prefetch(&t->keys[idx[j]], 1);                        \
+                }                                                              \
+            }                                                                  \
+            for (j = 0; j < m; ++j) {                                          \
+                r = fits ? qoa__insert_at_##name(t, keys[j], (int)idx[j])      \
+                         : qoa_insert_##name(t, keys[j]);                      \
+                if (r.result == QOA_ERROR)                                     \
+                    ret = -1;                                                  \
+                if (results)                                                   \
+                    *results++ = r;                                            \
+            }                                                                  \
+        }                                                                      \
+        return ret;                                                            \
+    }                                                                          \
+                                                                               \
+                                                                               \
     scope qoaiter qoa_end_##name(const table_t *t) { return t->asize; }        \
                                                                                \
     scope void qoa_del_##name(table_t *t, qoaiter iter)                        \
@@ -543,6 +672,16 @@ typedef struct qoaresult_s qoaresult;
                                                                                \
     scope int qoa_isempty_##name(const table_t *t) { return t->size == 0; }    \
                                                                                \
+    /* The struct may be caller-owned (qoa_init), so it counts as its size. */ \
+    scope size_t qoa_memory_usage_##name(const table_t *t)                     \
+    {                                                                          \
+        return sizeof(table_t) +                                               \
+               qoa_usable_size(t->flags, qoa__fsize(t->asize) *                \
+                                           sizeof(uint32_t)) +                 \
+               qoa_usable_size(t->keys, t->asize * sizeof(key_t)) +            \
+               qoa_usable_size(t->vals, t->asize * sizeof(val_t));             \
+    }                                                                          \
+                                                                               \
     struct qoa__empty_struct_to_end_macro_with_semicolon_##name                \
     {                                                                          \
     }
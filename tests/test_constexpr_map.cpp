@@ -0,0 +1,85 @@
+#include <catch2/catch.hpp>
+#include <pltables++/constexpr_map.h>
+#include <string_view>
+
+using namespace std::literals;
+
+namespace {
+
+enum class MsgType : char
+{
+    AddOrder = 'A',
+    AddOrderMpid = 'F',
+    Executed = 'E',
+    ExecutedPrice = 'C',
+    Cancel = 'X',
+    Delete = 'D',
+    Replace = 'U',
+    Trade = 'P',
+};
+
+constexpr constexpr_map msgSizes{ std::array{
+  std::pair{ MsgType::AddOrder, 36 },
+  std::pair{ MsgType::AddOrderMpid, 40 },
+  std::pair{ MsgType::Executed, 31 },
+  std::pair{ MsgType::ExecutedPrice, 36 },
+  std::pair{ MsgType::Cancel, 23 },
+  std::pair{ MsgType::Delete, 19 },
+  std::pair{ MsgType::Replace, 35 },
+  std::pair{ MsgType::Trade, 44 },
+} };
+
+constexpr constexpr_map venues{ std::array{
+  std::pair{ "XNAS"sv, 1 },
+  std::pair{ "XNYS"sv, 2 },
+  std::pair{ "ARCX"sv, 3 },
+  std::pair{ "BATS"sv, 4 },
+  std::pair{ "IEXG"sv, 5 },
+} };
+
+template <size_t... I>
+constexpr auto squares(std::index_sequence<I...>)
+{
+    return std::array{ std::pair{ int(I * 7919), int(I * I) }... };
+}
+
+} // namespace
+
+// Everything below is checked by the compiler.
+static_assert(msgSizes.size() == 8);
+static_assert(msgSizes.max_probe() == 0);
+static_assert(msgSizes.find(MsgType::Trade)->second == 44);
+static_assert(!msgSizes.contains(static_cast<MsgType>('Z')));
+static_assert(venues.find("IEXG"sv)->second == 5);
+static_assert(!venues.contains("XLON"sv));
+static_assert(constexpr_lookup<msgSizes, MsgType::Delete>() == 19);
+
+TEST_CASE("Constexpr map - runtime lookups", "[constexpr_map]")
+{
+    volatile char raw = 'U';
+    const auto type = static_cast<MsgType>(raw);
+    REQUIRE(msgSizes.find(type) != msgSizes.end());
+    REQUIRE(msgSizes.find(type)->second == 35);
+    REQUIRE(msgSizes.find(static_cast<MsgType>('Q')) == msgSizes.end());
+
+    std::string_view name = "ARCX";
+    REQUIRE(venues.find(name)->second == 3);
+    REQUIRE(!venues.contains("ARC"));
+}
+
+TEST_CASE("Constexpr map - larger maps fall back to a probe bound")
+{
+    static constexpr auto big = constexpr_map{ squares(std::make_index_sequence<200>{}) };
+    static_assert(big.size() == 200);
+    REQUIRE(big.max_probe() < 16);
+    for (int i = 0; i < 200; ++i) {
+        REQUIRE(big.find(i * 7919)->second == i * i);
+        REQUIRE(!big.contains(i * 7919 + 1));
+    }
+    size_t n = 0;
+    for (const auto& kv : big) {
+        REQUIRE(big.contains(kv.first));
+        ++n;
+    }
+    REQUIRE(n == 200u);
+}
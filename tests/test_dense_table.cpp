@@ -0,0 +1,160 @@
+#include <catch2/catch.hpp>
+#include <pltables++/dense_table.h>
+#include <random>
+#include <string>
+#include <unordered_map>
+
+TEST_CASE("Dense LOA - sequential keys go direct", "[dense_loa]")
+{
+    dense_loatable<uint64_t, int> map;
+    for (uint64_t k = 1000; k < 1000 + 63; ++k) {
+        map.insert(k, int(k));
+    }
+    REQUIRE(!map.is_direct());
+    map.insert(1063, 1063);
+    REQUIRE(map.is_direct());
+    REQUIRE(map.base() == 1000u);
+    for (uint64_t k = 1064; k < 5000; ++k) {
+        map.insert(k, int(k));
+    }
+    REQUIRE(map.is_direct());
+    REQUIRE(map.size() == 4000u);
+    for (uint64_t k = 1000; k < 5000; ++k) {
+        REQUIRE(map.find(k).value() == int(k));
+    }
+    REQUIRE(map.find(999) == map.end());
+    REQUIRE(map.find(5000) == map.end());
+    REQUIRE(map.insert(1500, 0).second ==
+            decltype(map)::InsertResult::Present);
+}
+
+TEST_CASE("Dense LOA - sliding window of order IDs stays direct",
+          "[dense_loa]")
+{
+    dense_loatable<int64_t, int64_t> map;
+    constexpr int64_t window = 1000;
+    for (int64_t id = 0; id < 100000; ++id) {
+        map.insert(id, -id);
+        if (id >= window) {
+            REQUIRE(map.erase(id - window) == 1u);
+        }
+    }
+    REQUIRE(map.is_direct());
+    REQUIRE(map.size() == size_t(window));
+    REQUIRE(map.span() <= 4 * size_t(window));
+    for (int64_t id = 100000 - window; id < 100000; ++id) {
+        REQUIRE(map.find(id).value() == -id);
+    }
+    REQUIRE(!map.contains(100000 - window - 1));
+}
+
+TEST_CASE("Dense LOA - sparse keys move back to hashing", "[dense_loa]")
+{
+    dense_loatable<int, int> map;
+    for (int k = -100; k < 100; ++k) {
+        map.insert(k, k);
+    }
+    REQUIRE(map.is_direct());
+    REQUIRE(map.find(-100).value() == -100);
+    map.insert(1 << 20, 7);
+    REQUIRE(!map.is_direct());
+    REQUIRE(map.size() == 201u);
+    REQUIRE(map.find(1 << 20).value() == 7);
+    for (int k = -100; k < 100; ++k) {
+        REQUIRE(map.find(k).value() == k);
+    }
+    // Draining a direct window also falls back to hashing.
+    map.clear();
+    for (int k = 0; k < 1024; ++k) {
+        map.insert(k, k);
+    }
+    REQUIRE(map.is_direct());
+    for (int k = 0; k < 1024; k += 2) {
+        map.erase(k);
+    }
+    REQUIRE(map.is_direct());
+    for (int k = 1; k < 1024; k += 2) {
+        if (k % 16 != 1)
+            map.erase(k);
+    }
+    REQUIRE(!map.is_direct());
+    REQUIRE(map.size() == 64u);
+    REQUIRE(map.find(17).value() == 17);
+    REQUIRE(!map.contains(3));
+}
+
+// Fails every allocation once `budget` is used up (negative: unlimited).
+struct BudgetAllocator
+{
+    static inline long budget = -1;
+    static void* allocate(size_t nmemb, size_t size) noexcept
+    {
+        if (budget == 0)
+            return nullptr;
+        if (budget > 0)
+            --budget;
+        return calloc(nmemb, size);
+    }
+    static void deallocate(void* ptr, size_t, size_t) noexcept { free(ptr); }
+};
+
+TEST_CASE("Dense LOA - moving back to hashing never loses entries",
+          "[dense_loa]")
+{
+    using Map = dense_loatable<int, int, std::hash<int>, std::equal_to<int>,
+                               BudgetAllocator>;
+    for (long budget : { 3, 0 }) {
+        BudgetAllocator::budget = -1;
+        Map map;
+        for (int k = 0; k < 1024; ++k) {
+            map.insert(k, k);
+        }
+        REQUIRE(map.is_direct());
+        const size_t span = map.span();
+        int k = 0;
+        while (map.size() > size_t(span * Map::SparseLoad)) {
+            map.erase(k++);
+        }
+        REQUIRE(map.is_direct());
+
+        // One table allocation (flags, keys, values) must be enough to hold
+        // every entry; with none the map stays direct.
+        BudgetAllocator::budget = budget;
+        map.erase(k++);
+        REQUIRE(map.is_direct() == (budget == 0));
+        REQUIRE(map.size() == size_t(1024 - k));
+        for (int j = 0; j < 1024; ++j) {
+            REQUIRE(map.contains(j) == (j >= k));
+        }
+        for (int j = k; j < 1024; ++j) {
+            REQUIRE(map.find(j).value() == j);
+        }
+        BudgetAllocator::budget = -1;
+    }
+}
+
+TEST_CASE("Dense LOA - random mix matches unordered_map", "[dense_loa]")
+{
+    dense_loatable<int32_t, std::string> map;
+    std::unordered_map<int32_t, std::string> reference;
+    std::mt19937 gen(31);
+    for (int step = 0; step < 60000; ++step) {
+        // Phases of dense and sparse keys force conversions both ways.
+        const int32_t spread = (step / 5000) % 2 ? 1 << 24 : 600;
+        std::uniform_int_distribution<int32_t> dist(-spread, spread);
+        const int32_t k = dist(gen);
+        if (step % 3 == 0) {
+            REQUIRE(map.erase(k) == reference.erase(k));
+        } else {
+            map.insert(k, std::to_string(k));
+            reference.emplace(k, std::to_string(k));
+        }
+        REQUIRE(map.size() == reference.size());
+    }
+    size_t n = 0;
+    for (auto it = map.begin(); it != map.end(); ++it) {
+        REQUIRE(reference.at(it.key()) == it.value());
+        ++n;
+    }
+    REQUIRE(n == reference.size());
+}
@@ -0,0 +1,136 @@
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <cstdlib>
+#include <pltables++/epoch.h>
+#include <thread>
+#include <vector>
+
+namespace {
+std::atomic<int> freed{ 0 };
+void countingFree(void* ptr, size_t)
+{
+    ++freed;
+    free(ptr);
+}
+} // namespace
+
+TEST_CASE("Epoch - retired memory outlives active readers", "[epoch]")
+{
+    freed = 0;
+    plt::EpochDomain domain;
+    plt::EpochDomain::Participant reader{ domain };
+    plt::EpochDomain::Participant writer{ domain };
+
+    reader.enter();
+    writer.retire(malloc(16), 16, &countingFree);
+    for (int i = 0; i < 10; ++i) {
+        writer.collect();
+    }
+    REQUIRE(freed == 0);
+    REQUIRE(writer.pending() == 1u);
+
+    reader.exit();
+    writer.synchronize();
+    REQUIRE(freed == 1);
+    REQUIRE(writer.pending() == 0u);
+}
+
+TEST_CASE("Epoch - quiescent readers do not block reclamation")
+{
+    freed = 0;
+    plt::EpochDomain domain;
+    plt::EpochDomain::Participant reader{ domain };
+    plt::EpochDomain::Participant writer{ domain };
+
+    reader.enter();
+    writer.retire(malloc(16), 16, &countingFree);
+    for (int i = 0; i < 4; ++i) {
+        reader.quiescent();
+        writer.collect();
+    }
+    REQUIRE(freed == 1);
+    reader.exit();
+}
+
+TEST_CASE("Epoch - batches are reclaimed without explicit collect")
+{
+    freed = 0;
+    plt::EpochDomain domain;
+    plt::EpochDomain::Participant writer{ domain };
+    for (size_t i = 0; i < 8 * plt::EpochDomain::BatchSize; ++i) {
+        writer.retire(malloc(8), 8, &countingFree);
+    }
+    REQUIRE(freed > 0);
+    REQUIRE(writer.pending() < 4 * plt::EpochDomain::BatchSize);
+}
+
+TEST_CASE("Epoch - departing participant orphans its garbage")
+{
+    freed = 0;
+    plt::EpochDomain domain;
+    plt::EpochDomain::Participant reader{ domain };
+    reader.enter();
+    {
+        plt::EpochDomain::Participant writer{ domain };
+        writer.retire(malloc(8), 8, &countingFree);
+    }
+    REQUIRE(freed == 0);
+    REQUIRE(domain.pending_orphans() == 1u);
+    reader.exit();
+    while (domain.pending_orphans() != 0) {
+        domain.reclaim();
+    }
+    REQUIRE(freed == 1);
+}
+
+TEST_CASE("Epoch - readers never observe freed arrays")
+{
+    constexpr int N = 64;
+    constexpr int Swaps = 2000;
+    plt::EpochDomain domain;
+    std::atomic<int*> current{ static_cast<int*>(calloc(N, sizeof(int))) };
+    std::atomic<bool> done{ false };
+    std::atomic<int> torn{ 0 };
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&]() {
+            plt::EpochDomain::Participant self{ domain };
+            while (!done.load(std::memory_order_relaxed)) {
+                plt::EpochDomain::Guard guard{ self };
+                const int* arr = current.load(std::memory_order_acquire);
+                const int v = arr[0];
+                for (int i = 1; i < N; ++i) {
+                    if (arr[i] != v)
+                        ++torn;
+                }
+            }
+        });
+    }
+
+    {
+        plt::EpochDomain::Participant writer{ domain };
+        for (int s = 1; s <= Swaps; ++s) {
+            int* fresh = static_cast<int*>(malloc(N * sizeof(int)));
+            for (int i = 0; i < N; ++i) {
+                fresh[i] = s;
+            }
+            int* old = current.exchange(fresh, std::memory_order_acq_rel);
+            writer.retire(old, N * sizeof(int),
+                          [](void* p, size_t n) {
+                              // poison so a racing reader would see a tear
+                              int* a = static_cast<int*>(p);
+                              for (size_t i = 0; i < n / sizeof(int); ++i)
+                                  a[i] = -int(i);
+                              free(p);
+                          });
+        }
+        done = true;
+        for (auto& t : readers) {
+            t.join();
+        }
+        writer.synchronize();
+    }
+    free(current.load());
+    REQUIRE(torn == 0);
+}
@@ -0,0 +1,175 @@
+#include <catch2/catch.hpp>
+#include <cstdlib>
+#include <pltables++/frozen_table.h>
+#include <pltables++/linear_open_address.h>
+#include <pltables/klibtable.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using FrozenTable = frozen_table<int, int>;
+
+static std::vector<int> distinctKeys(size_t n)
+{
+    std::vector<int> ks(n);
+    for (size_t i = 0; i < n; ++i) {
+        ks[i] = int(uint32_t(i) * 2654435761u); // bijective on 32 bits
+    }
+    return ks;
+}
+
+TEST_CASE("Frozen - every key maps to a distinct slot", "[frozen]")
+{
+    const size_t N = 100000;
+    auto keys = distinctKeys(N);
+    std::vector<int> vals(N);
+    for (size_t i = 0; i < N; ++i) {
+        vals[i] = int(i);
+    }
+    FrozenTable table;
+    REQUIRE(table.build(keys.data(), vals.data(), N));
+    REQUIRE(table.size() == N);
+
+    std::vector<char> seen(N, 0);
+    for (size_t i = 0; i < N; ++i) {
+        const size_t s = table.index_of(keys[i]);
+        REQUIRE(s < N);
+        REQUIRE(!seen[s]);
+        seen[s] = 1;
+        REQUIRE(table.find(keys[i]).value() == int(i));
+    }
+    REQUIRE(table.bits_per_key() < 4.0);
+}
+
+TEST_CASE("Frozen - keys outside the set are not found")
+{
+    auto keys = distinctKeys(2000);
+    std::vector<int> vals(keys.begin(), keys.end());
+    FrozenTable table;
+    table.build(keys.data(), vals.data(), 1000);
+    for (size_t i = 1000; i < 2000; ++i) {
+        REQUIRE(!table.contains(keys[i]));
+        REQUIRE(table.find(keys[i]) == table.end());
+    }
+    FrozenTable empty;
+    REQUIRE(!empty.contains(0));
+    REQUIRE(empty.begin() == empty.end());
+}
+
+TEST_CASE("Frozen - layout does not depend on the thread count")
+{
+    const size_t N = 200000;
+    auto keys = distinctKeys(N);
+    std::vector<int> vals(keys.begin(), keys.end());
+    FrozenTable serial;
+    serial.build(keys.data(), vals.data(), N, 1);
+    for (size_t nthreads : { 2, 4, 7 }) {
+        FrozenTable parallel;
+        parallel.build(keys.data(), vals.data(), N, nthreads);
+        REQUIRE(parallel.levels() == serial.levels());
+        for (size_t i = 0; i < N; i += 97) {
+            REQUIRE(parallel.index_of(keys[i]) == serial.index_of(keys[i]));
+        }
+    }
+}
+
+TEST_CASE("Frozen - freeze a loatable and a klibtable")
+{
+    loatable<int, int> loa;
+    klibtable<int, int> klib;
+    for (int i = 0; i < 5000; ++i) {
+        loa.insert(i, -i);
+        klib.insert(i, -i);
+    }
+    loa.erase(10);
+    auto a = freeze(loa, 2);
+    auto b = freeze(klib);
+    REQUIRE(a.size() == 4999u);
+    REQUIRE(b.size() == 5000u);
+    REQUIRE(!a.contains(10));
+    for (int i = 0; i < 5000; ++i) {
+        if (i != 10) {
+            REQUIRE(a.find(i).value() == -i);
+        }
+        REQUIRE(b.find(i).value() == -i);
+    }
+    size_t n = 0;
+    for (auto it = a.begin(); it != a.end(); ++it) {
+        REQUIRE(it.value() == -it.key());
+        ++n;
+    }
+    REQUIRE(n == a.size());
+}
+
+struct CountingHash
+{
+    static inline size_t calls = 0;
+    size_t operator()(int k) const noexcept
+    {
+        ++calls;
+        return std::hash<int>{}(k) * 0x9E3779B97F4A7C15ull;
+    }
+};
+
+TEST_CASE("Frozen - freeze uses the source table's hasher")
+{
+    loatable<int, int, CountingHash> loa;
+    for (int i = 0; i < 2000; ++i) {
+        loa.insert(i, i + 7);
+    }
+    auto frozen = freeze(loa);
+    static_assert(
+      std::is_same_v<decltype(frozen)::hasher, CountingHash>,
+      "freeze() must carry the source hasher over");
+    const size_t before = CountingHash::calls;
+    for (int i = 0; i < 2000; ++i) {
+        REQUIRE(frozen.find(i).value() == i + 7);
+    }
+    REQUIRE(CountingHash::calls - before == 2000u);
+}
+
+TEST_CASE("Frozen - bits_per_key counts every metadata word")
+{
+    // one key: a 64-bit level, its rank sample, the trailing rank total and
+    // the (first word, bit count) level descriptor
+    const int key = 5;
+    const int val = 6;
+    FrozenTable table;
+    REQUIRE(table.build(&key, &val, 1));
+    REQUIRE(table.levels() == 1u);
+    REQUIRE(table.bits_per_key() == 64.0 * 5);
+}
+
+TEST_CASE("Frozen - snapshot round trip")
+{
+    const char* dir = getenv("TMPDIR");
+    const std::string path = std::string(dir ? dir : "/tmp") + "/plt_frozen_" +
+                             std::to_string(getpid()) + ".snap";
+    auto keys = distinctKeys(30000);
+    std::vector<int> vals(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        vals[i] = int(i) * 3;
+    }
+    FrozenTable table;
+    table.build(keys.data(), vals.data(), keys.size(), 3);
+    REQUIRE(table.save(path.c_str()));
+
+    FrozenTable loaded;
+    REQUIRE(loaded.load_mmap(path.c_str()));
+    REQUIRE(loaded.size() == table.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        REQUIRE(loaded.index_of(keys[i]) == table.index_of(keys[i]));
+        REQUIRE(loaded.find(keys[i]).value() == int(i) * 3);
+    }
+    REQUIRE(!loaded.contains(keys[0] + 1));
+
+    // a loatable snapshot is not a frozen one, and vice versa
+    loatable<int, int> loa;
+    REQUIRE(!loa.load_mmap(path.c_str()));
+    REQUIRE(!(frozen_table<int, long>{}.load_mmap(path.c_str())));
+
+    FrozenTable moved = std::move(loaded);
+    REQUIRE(moved.find(keys[5]).value() == 15);
+    REQUIRE(loaded.empty());
+    unlink(path.c_str());
+}
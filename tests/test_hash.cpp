@@ -0,0 +1,377 @@
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <pltables++/hash.h>
+#include <pltables++/linear_open_address.h>
+#include <pltables/qoatable.h>
+#include <string>
+#include <vector>
+
+// An SMHasher-lite for pltables/hash: known answers, avalanche (every input
+// bit flips every output bit half the time) and the spread of structured
+// key sets over 2^8, 2^12 and 2^16 buckets taken by mask, which is how the
+// tables index.
+
+namespace {
+
+uint64_t splitmix(uint64_t& s)
+{
+    uint64_t z = (s += 0x9e3779b97f4a7c15u);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9u;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebu;
+    return z ^ (z >> 31);
+}
+
+constexpr int Trials = 4000;
+
+// Largest |P(output bit j flips | input bit i flipped) - 1/2| over the
+// first `out_bits` output bits, for random keys of `in_bits` bits. Around
+// 0.03 for an ideal hash at this many trials; 0.5 when some bit never
+// reaches some other.
+template <class F>
+double avalancheBias(F f, int in_bits, int out_bits)
+{
+    std::vector<int> flips(in_bits * out_bits);
+    uint64_t s = 1;
+    for (int t = 0; t < Trials; ++t) {
+        uint64_t k = splitmix(s);
+        if (in_bits < 64)
+            k &= (uint64_t(1) << in_bits) - 1;
+        const uint64_t h = f(k);
+        for (int i = 0; i < in_bits; ++i) {
+            const uint64_t d = h ^ f(k ^ (uint64_t(1) << i));
+            for (int j = 0; j < out_bits; ++j)
+                flips[i * out_bits + j] += (d >> j) & 1;
+        }
+    }
+    double bias = 0;
+    for (int n : flips)
+        bias = std::max(bias, std::fabs(double(n) / Trials - 0.5));
+    return bias;
+}
+
+// As above for a byte hash over 16-byte keys.
+template <class F>
+double bytesAvalancheBias(F f, int out_bits)
+{
+    constexpr int Len = 16;
+    std::vector<int> flips(Len * 8 * out_bits);
+    uint64_t s = 2;
+    for (int t = 0; t < Trials; ++t) {
+        unsigned char key[Len];
+        for (int w = 0; w < Len; w += 8) {
+            const uint64_t r = splitmix(s);
+            memcpy(key + w, &r, 8);
+        }
+        const uint64_t h = f(key, Len);
+        for (int i = 0; i < Len * 8; ++i) {
+            key[i / 8] ^= 1u << (i % 8);
+            const uint64_t d = h ^ f(key, Len);
+            key[i / 8] ^= 1u << (i % 8);
+            for (int j = 0; j < out_bits; ++j)
+                flips[i * out_bits + j] += (d >> j) & 1;
+        }
+    }
+    double bias = 0;
+    for (int n : flips)
+        bias = std::max(bias, std::fabs(double(n) / Trials - 0.5));
+    return bias;
+}
+
+// Chi-square of the bucket counts when `hashes` are masked to 2^bits
+// buckets, as a z-score: (chi2 - df) / sqrt(2 df) is about N(0, 1) for a
+// uniform hash and large when keys pile up.
+double bucketZ(const std::vector<uint64_t>& hashes, int bits)
+{
+    const size_t buckets = size_t(1) << bits;
+    std::vector<double> count(buckets);
+    for (uint64_t h : hashes)
+        ++count[h & (buckets - 1)];
+    const double expected = double(hashes.size()) / buckets;
+    double chi2 = 0;
+    for (double c : count)
+        chi2 += (c - expected) * (c - expected) / expected;
+    const double df = double(buckets - 1);
+    return (chi2 - df) / std::sqrt(2 * df);
+}
+
+// Worst bucket z-score over sequential keys, keys varying only above bit
+// 16, and random keys, at each mask, with 16 keys per bucket.
+template <class F>
+double worstIntBucketZ(F f)
+{
+    double worst = -1e300;
+    for (int bits : { 8, 12, 16 }) {
+        const size_t n = size_t(16) << bits;
+        std::vector<uint64_t> seq(n), high(n), rnd(n);
+        uint64_t s = 7;
+        for (size_t i = 0; i < n; ++i) {
+            seq[i] = f(i);
+            high[i] = f(uint64_t(i) << 16);
+            rnd[i] = f(splitmix(s));
+        }
+        for (const auto* hs : { &seq, &high, &rnd })
+            worst = std::max(worst, bucketZ(*hs, bits));
+    }
+    return worst;
+}
+
+// The same over strings "key:<i>".
+template <class F>
+double worstStringBucketZ(F f)
+{
+    double worst = -1e300;
+    for (int bits : { 8, 12, 16 }) {
+        const size_t n = size_t(16) << bits;
+        std::vector<uint64_t> hs(n);
+        for (size_t i = 0; i < n; ++i) {
+            const std::string k = "key:" + std::to_string(i);
+            hs[i] = f(k.data(), k.size());
+        }
+        worst = std::max(worst, bucketZ(hs, bits));
+    }
+    return worst;
+}
+
+} // namespace
+
+TEST_CASE("Hash - known answers", "[hash]")
+{
+    REQUIRE(plt_crc32c("123456789", 9, 0) == 0xe3069283u);
+    REQUIRE(plt_crc32c("", 0, 0) == 0);
+    // Continuing a CRC equals hashing the concatenation.
+    REQUIRE(plt_crc32c("6789", 4, plt_crc32c("12345", 5, 0)) == 0xe3069283u);
+
+    REQUIRE(plt_hash_murmur3_32("", 0, 0) == 0);
+    REQUIRE(plt_hash_murmur3_32("", 0, 1) == 0x514e28b7u);
+    REQUIRE(plt_hash_murmur3_32("hello", 5, 0) == 0x248bfa47u);
+    REQUIRE(plt_hash_murmur3_32("Hello, world!", 13, 1234) == 0xfaf6cdb3u);
+
+    REQUIRE(plt_hash_fnv1a32("", 0, 0) == 0x811c9dc5u);
+    REQUIRE(plt_hash_fnv1a32("a", 1, 0) == 0xe40c292cu);
+    REQUIRE(plt_hash_fnv1a64("a", 1, 0) == 0xaf63dc4c8601ec8cull);
+
+    REQUIRE(plt_hash_bernstein("a", 1, 5381) == 177670u);
+    REQUIRE(plt_hash_x31("hello") == 99162322u);
+    REQUIRE(plt_hash_x31_bytes("hello", 5) == plt_hash_x31("hello"));
+
+    // khash's __ac_Wang_hash.
+    REQUIRE(plt_hash_wang32(0) == 0x4636b9c9u);
+}
+
+TEST_CASE("Hash - qoatable's functions are the library's", "[hash]")
+{
+    REQUIRE(uint32_t(qoa_str_hash_X31("hello")) == plt_hash_x31("hello"));
+    REQUIRE(uint32_t(qoa_i32_hash_Wang(-12345)) == plt_hash_wang32(-12345));
+    REQUIRE(qoa_fibonacci_hash64(42) == plt_hash_fibonacci64(42));
+}
+
+TEST_CASE("Hash - wyhash reads every byte of every length", "[hash]")
+{
+    // Lengths straddle the 3/4/8/16/48-byte read boundaries; flipping any
+    // byte must change the hash.
+    unsigned char buf[100];
+    for (size_t i = 0; i < sizeof(buf); ++i)
+        buf[i] = static_cast<unsigned char>(i * 7 + 1);
+    for (size_t len = 1; len <= sizeof(buf); ++len) {
+        const uint64_t h = plt_hash_wy(buf, len, 0);
+        REQUIRE(h != plt_hash_wy(buf, len - 1, 0));
+        for (size_t i = 0; i < len; ++i) {
+            buf[i] ^= 0x10;
+            REQUIRE(plt_hash_wy(buf, len, 0) != h);
+            buf[i] ^= 0x10;
+        }
+    }
+    REQUIRE(plt_hash_wy(buf, 16, 0) != plt_hash_wy(buf, 16, 1));
+}
+
+TEST_CASE("Hash - integer mixers avalanche", "[hash]")
+{
+    const auto fmix = [](uint64_t k) { return plt_hash_murmur3_fmix64(k); };
+    const auto wy = [](uint64_t k) { return plt_hash_wymix64(k); };
+    const auto crc = [](uint64_t k) { return plt_hash_crc32c_u64(k); };
+    const auto wang = [](uint64_t k) { return plt_hash_wang64(k); };
+
+    for (int bits : { 32, 64 }) {
+        INFO("key bits " << bits);
+        CHECK(avalancheBias(fmix, bits, 64) < 0.05);
+        CHECK(avalancheBias(wy, bits, 64) < 0.05);
+        CHECK(avalancheBias(crc, bits, 64) < 0.05);
+        // Shifts and adds only: good, not complete.
+        CHECK(avalancheBias(wang, bits, 64) < 0.15);
+    }
+    // Multiplication only carries upwards: the top input bit reaches the
+    // top output bit alone.
+    const auto fib = [](uint64_t k) { return plt_hash_fibonacci64(k); };
+    CHECK(avalancheBias(fib, 64, 64) == Approx(0.5));
+}
+
+TEST_CASE("Hash - byte hashes avalanche", "[hash]")
+{
+    CHECK(bytesAvalancheBias(
+            [](const void* p, size_t n) { return plt_hash_wy(p, n, 0); },
+            64) < 0.05);
+    CHECK(bytesAvalancheBias(
+            [](const void* p, size_t n) {
+                return uint64_t(plt_hash_murmur3_32(p, n, 0));
+            },
+            32) < 0.05);
+    CHECK(bytesAvalancheBias(
+            [](const void* p, size_t n) { return plt::crc32c_hash{}(
+                                            { (const char*)p, n }); },
+            64) < 0.05);
+    // The multiplicative string hashes leave the last bytes in the low bits.
+    CHECK(bytesAvalancheBias(
+            [](const void* p, size_t n) {
+                return uint64_t(plt_hash_x31_bytes(p, n));
+            },
+            32) > 0.4);
+    CHECK(bytesAvalancheBias(
+            [](const void* p, size_t n) {
+                return plt_hash_fnv1a64(p, n, 0);
+            },
+            64) > 0.4);
+}
+
+TEST_CASE("Hash - masked buckets stay uniform on structured keys", "[hash]")
+{
+    CHECK(worstIntBucketZ(
+            [](uint64_t k) { return plt_hash_murmur3_fmix64(k); }) < 6);
+    CHECK(worstIntBucketZ([](uint64_t k) { return plt_hash_wymix64(k); }) <
+          6);
+    CHECK(worstIntBucketZ(
+            [](uint64_t k) { return plt_hash_crc32c_u64(k); }) < 6);
+    CHECK(worstIntBucketZ([](uint64_t k) { return plt_hash_wang64(k); }) <
+          6);
+
+    CHECK(worstStringBucketZ([](const void* p, size_t n) {
+              return plt_hash_wy(p, n, 0);
+          }) < 6);
+    CHECK(worstStringBucketZ([](const void* p, size_t n) {
+              return uint64_t(plt_hash_murmur3_32(p, n, 0));
+          }) < 6);
+    CHECK(worstStringBucketZ([](const void* p, size_t n) {
+              return plt::crc32c_hash{}({ (const char*)p, n });
+          }) < 6);
+
+    // The identity (std::hash<int> in libstdc++) and a bare multiply put
+    // keys differing only in high bits into one bucket.
+    CHECK(worstIntBucketZ([](uint64_t k) { return k; }) > 1000);
+    CHECK(worstIntBucketZ(
+            [](uint64_t k) { return plt_hash_fibonacci64(k); }) > 1000);
+}
+
+TEST_CASE("Hash - hashers plug into the tables", "[hash]")
+{
+    loatable<uint64_t, int, plt::wy_hash> t;
+    for (uint64_t i = 0; i < 1000; ++i)
+        t.insert(i << 20, int(i));
+    REQUIRE(t.size() == 1000);
+    for (uint64_t i = 0; i < 1000; ++i) {
+        auto it = t.find(i << 20);
+        REQUIRE(it != t.end());
+        REQUIRE(it.value() == int(i));
+    }
+
+    const plt::murmur3_hash h;
+    REQUIRE(h(uint64_t(7)) == plt_hash_murmur3_fmix64(7));
+    REQUIRE(h(std::string("abc")) == plt_hash_murmur3_32("abc", 3, 0));
+    REQUIRE(plt::hash_identity<plt::wy_hash>::id() !=
+            plt::hash_identity<plt::crc32c_hash>::id());
+    REQUIRE(plt::hash_identity<plt::wy_hash>::id() ==
+            plt::hash_algo::_name_id("plt::wy"));
+}
+
+TEST_CASE("Hash - batch kernels match the scalar functions", "[hash]")
+{
+    // Odd lengths leave a tail after the last full vector of every width.
+    constexpr size_t N = 101;
+    uint32_t h32[N], want32[N], got32[N];
+    uint64_t h64[N], want64[N], got64[N];
+    uint64_t s = 3;
+    for (size_t j = 0; j < N; ++j) {
+        h64[j] = splitmix(s);
+        h32[j] = uint32_t(h64[j]);
+    }
+    const uint32_t mask32 = 0xfff;
+    const uint64_t mask64 = 0xffffffffffull;
+
+    using Kernel32 = void (*)(const uint32_t*, size_t, uint32_t, uint32_t*);
+    using Kernel64 = void (*)(const uint64_t*, size_t, uint64_t, uint64_t*);
+    struct Kernels
+    {
+        int isa;
+        Kernel32 fib32, fmix32;
+        Kernel64 fmix64;
+    };
+    std::vector<Kernels> kernels = {
+        { PLT_HASH_ISA_SCALAR, plt_hash_fibonacci32_batch_scalar,
+          plt_hash_fmix32_batch_scalar, plt_hash_fmix64_batch_scalar },
+#if defined(PLT_HASH_X86)
+        { PLT_HASH_ISA_SSE42, plt_hash_fibonacci32_batch_sse42,
+          plt_hash_fmix32_batch_sse42, plt_hash_fmix64_batch_sse42 },
+        { PLT_HASH_ISA_AVX2, plt_hash_fibonacci32_batch_avx2,
+          plt_hash_fmix32_batch_avx2, plt_hash_fmix64_batch_avx2 },
+        { PLT_HASH_ISA_AVX512, plt_hash_fibonacci32_batch_avx512,
+          plt_hash_fmix32_batch_avx512, plt_hash_fmix64_batch_avx512 },
+#endif
+        { -1, plt_hash_fibonacci32_batch, plt_hash_fmix32_batch,
+          plt_hash_fmix64_batch },
+    };
+    for (const auto& k : kernels) {
+        // Only what this CPU runs; -1 is the dispatcher.
+        if (k.isa > plt_hash_isa())
+            continue;
+        INFO("isa " << k.isa);
+        for (size_t n : { size_t(0), size_t(1), size_t(15), N }) {
+            INFO("n " << n);
+            for (size_t j = 0; j < n; ++j)
+                want32[j] = plt_hash_fibonacci32(h32[j]) & mask32;
+            k.fib32(h32, n, mask32, got32);
+            REQUIRE(std::equal(want32, want32 + n, got32));
+
+            for (size_t j = 0; j < n; ++j)
+                want32[j] = plt_hash_murmur3_fmix32(h32[j]) & mask32;
+            k.fmix32(h32, n, mask32, got32);
+            REQUIRE(std::equal(want32, want32 + n, got32));
+
+            for (size_t j = 0; j < n; ++j)
+                want64[j] = plt_hash_murmur3_fmix64(h64[j]) & mask64;
+            k.fmix64(h64, n, mask64, got64);
+            REQUIRE(std::equal(want64, want64 + n, got64));
+        }
+    }
+}
+
+TEST_CASE("Hash - fmix_hash batches agree with single keys", "[hash]")
+{
+    const plt::fmix_hash h;
+    std::vector<int32_t> k32(77);
+    std::vector<uint64_t> k64(77);
+    std::vector<int16_t> k16(77);
+    uint64_t s = 4;
+    for (size_t j = 0; j < k64.size(); ++j) {
+        k64[j] = splitmix(s);
+        k32[j] = int32_t(k64[j]);
+        k16[j] = int16_t(k64[j]);
+    }
+    const size_t mask = (size_t(1) << 20) - 1;
+    std::vector<size_t> idx(k64.size());
+
+    h.hash_batch(k32.data(), k32.size(), mask, idx.data());
+    for (size_t j = 0; j < k32.size(); ++j)
+        REQUIRE(idx[j] == (h(k32[j]) & mask));
+    h.hash_batch(k64.data(), k64.size(), mask, idx.data());
+    for (size_t j = 0; j < k64.size(); ++j)
+        REQUIRE(idx[j] == (h(k64[j]) & mask));
+    h.hash_batch(k16.data(), k16.size(), mask, idx.data());
+    for (size_t j = 0; j < k16.size(); ++j)
+        REQUIRE(idx[j] == (h(k16[j]) & mask));
+
+    REQUIRE(h(int32_t(-1)) == plt_hash_murmur3_fmix32(0xffffffffu));
+    REQUIRE(h(uint64_t(7)) == plt_hash_murmur3_fmix64(7));
+    STATIC_REQUIRE(loa_hash_batch<plt::fmix_hash, int>::value);
+    STATIC_REQUIRE(!loa_hash_batch<plt::wy_hash, int>::value);
+}
@@ -1,8 +1,11 @@
 #include <catch2/catch.hpp>
+#include <pltables++/hash.h>
 #include <pltables++/linear_open_address.h>
 #include <unordered_map>
 #include <vector>
 #include <algorithm>
+#include <memory>
+#include <string>
 
 TEST_CASE("LOA - Default constructed table is empty", "[loa]")
 {
@@ -196,6 +199,55 @@ TEST_CASE("LOA - Insert and erase keys")
     }
 }
 
+TEST_CASE("LOA - re-insert does not duplicate a key past a tombstone")
+{
+    // every key shares one probe path, so 2 sits behind 1's slot
+    struct Collide
+    {
+        size_t operator()(int) const noexcept { return 0; }
+    };
+    using Table = loatable<int, int, Collide>;
+    Table table;
+    REQUIRE(table.insert(1, 10).second == Table::InsertResult::Inserted);
+    REQUIRE(table.insert(2, 20).second == Table::InsertResult::Inserted);
+    REQUIRE(table.erase(1) == 1u);
+
+    auto result = table.insert(2, 21);
+    REQUIRE(result.second == Table::InsertResult::Present);
+    REQUIRE(result.first.value() == 20);
+    REQUIRE(table.size() == 1u);
+
+    result = table.insert(1, 11);
+    REQUIRE(result.second == Table::InsertResult::ReusedSlot);
+    REQUIRE(table.size() == 2u);
+
+    REQUIRE(table.erase(2) == 1u);
+    REQUIRE(table.find(2) == table.end());
+    REQUIRE(table.size() == 1u);
+    auto it = table.find(1);
+    REQUIRE(it != table.end());
+    REQUIRE(it.value() == 11);
+}
+
+TEST_CASE("LOA - erase destroys the key and value")
+{
+    auto val = std::make_shared<int>(7);
+    {
+        loatable<std::string, std::shared_ptr<int>> table;
+        for (int i = 0; i < 64; ++i) {
+            table.insert(std::string(32, char('a' + i % 26)) + std::to_string(i),
+                         val);
+        }
+        REQUIRE(val.use_count() == 65);
+        for (int i = 0; i < 64; i += 2) {
+            REQUIRE(table.erase(std::string(32, char('a' + i % 26)) +
+                                std::to_string(i)) == 1u);
+        }
+        REQUIRE(val.use_count() == 33);
+    }
+    REQUIRE(val.use_count() == 1);
+}
+
 TEST_CASE("LOA - iteration covers all elements")
 {
     constexpr size_t N = 42;
@@ -222,3 +274,190 @@ TEST_CASE("LOA - iteration covers all elements")
         REQUIRE(vs[i] == i + 1);
     }
 }
+
+TEST_CASE("LOA - build_parallel matches sequential insert")
+{
+    using Table = loatable<int, int>;
+    constexpr int N = 200000;
+    std::vector<Table::pair_type> data;
+    std::unordered_map<int, int> t2;
+    uint32_t x = 12345;
+    for (int i = 0; i < N; ++i) {
+        x = x * 1664525u + 1013904223u;
+        // narrow range so there are duplicates, first occurrence wins
+        const int key = static_cast<int>(x % (N / 2));
+        data.emplace_back(key, i);
+        t2.emplace(key, i);
+    }
+
+    for (size_t nthreads : { 1, 2, 3, 8 }) {
+        Table table;
+        table.insert(-1, -1); // replaced by the build
+        REQUIRE(table.build_parallel(data.data(), data.data() + data.size(),
+                                     nthreads));
+        REQUIRE(table.size() == t2.size());
+        REQUIRE(table.find(-1) == table.end());
+        for (auto&& kv : t2) {
+            auto it = table.find(kv.first);
+            REQUIRE(it != table.end());
+            REQUIRE(it.value() == kv.second);
+        }
+        for (int i = N / 2; i < N; ++i) {
+            REQUIRE(table.find(i) == table.end());
+        }
+
+        auto result = table.insert(N, 1);
+        REQUIRE(result.second == Table::InsertResult::Inserted);
+        REQUIRE(table.size() == t2.size() + 1);
+    }
+}
+
+TEST_CASE("LOA - build_parallel with clustered hashes crossing regions")
+{
+    // every key hashes into the last few slots so probe chains spill out of
+    // one region, wrap around the table and run through the others
+    struct Clustered
+    {
+        size_t operator()(int k) const noexcept
+        {
+            return (size_t(1) << 20) - 1 - (k % 64);
+        }
+    };
+    using Table = loatable<int, int, Clustered>;
+    std::vector<Table::pair_type> data;
+    for (int i = 0; i < 50000; ++i) {
+        data.emplace_back(i, -i);
+    }
+    Table table;
+    REQUIRE(table.build_parallel(data.data(), data.data() + data.size(), 4));
+    REQUIRE(table.size() == data.size());
+    for (auto&& kv : data) {
+        auto it = table.find(kv.first);
+        REQUIRE(it != table.end());
+        REQUIRE(it.value() == kv.second);
+    }
+
+    Table empty;
+    REQUIRE(empty.build_parallel(data.data(), data.data(), 4));
+    REQUIRE(empty.size() == 0u);
+}
+
+TEST_CASE("LOA - parallel resize is deterministic across pool sizes")
+{
+    using Table = loatable<int, int>;
+    constexpr int N = 100000;
+    std::vector<std::vector<int>> layouts;
+    for (size_t nthreads : { 1, 2, 4, 7 }) {
+        plt::ThreadPool pool{ nthreads };
+        Table table;
+        table.set_parallel_resize(&pool, 0);
+        // odd multiplier: distinct, scattered keys
+        const auto key = [](int i) {
+            return static_cast<int>(static_cast<uint32_t>(i) * 2654435761u);
+        };
+        for (int i = 0; i < N; ++i) {
+            table.insert(key(i), i);
+            if (i % 7 == 0)
+                table.erase(key(i));
+        }
+        table.resize(4 * table.capacity());
+
+        for (int i = 0; i < N; ++i) {
+            auto it = table.find(key(i));
+            if (i % 7 == 0) {
+                REQUIRE(it == table.end());
+            } else {
+                REQUIRE(it != table.end());
+                REQUIRE(it.value() == i);
+            }
+        }
+
+        std::vector<int> layout;
+        for (auto p : table) {
+            layout.push_back(p.first);
+        }
+        REQUIRE(layout.size() == table.size());
+        layouts.push_back(std::move(layout));
+        table.set_parallel_resize(nullptr);
+    }
+    // a pool of one never takes the parallel path; the others must agree
+    REQUIRE(layouts[1] == layouts[2]);
+    REQUIRE(layouts[1] == layouts[3]);
+}
+
+TEST_CASE("LOA - find_batch and insert_batch match single-key calls", "[loa]")
+{
+    // fmix_hash takes the SIMD path, std::hash the scalar one.
+    auto check = [](auto table, auto reference) {
+        using Table = decltype(table);
+        constexpr int N = 5000;
+        std::vector<typename Table::pair_type> data;
+        uint32_t x = 777;
+        for (int i = 0; i < N; ++i) {
+            x = x * 1664525u + 1013904223u;
+            // duplicates, and blocks that straddle resizes
+            data.emplace_back(static_cast<int>(x % 3000) - 1000, i);
+        }
+        std::vector<typename Table::InsertResult> results(N);
+        REQUIRE(table.insert_batch(data.data(), data.data() + N,
+                                   results.data()));
+        for (int i = 0; i < N; ++i) {
+            auto r = reference.insert(data[i].first, data[i].second);
+            REQUIRE(r.second == results[i]);
+        }
+        REQUIRE(table.size() == reference.size());
+        for (int i = 0; i < N; i += 3) {
+            table.erase(data[i].first);
+            reference.erase(data[i].first);
+        }
+        // reused tombstones within one block
+        REQUIRE(table.insert_batch(data.data(), data.data() + 64));
+
+        std::vector<int> keys;
+        for (int k = -1100; k < 2100; ++k)
+            keys.push_back(k);
+        std::vector<typename Table::iterator> found(keys.size());
+        table.find_batch(keys.data(), keys.data() + keys.size(),
+                         found.data());
+        for (size_t j = 0; j < keys.size(); ++j) {
+            REQUIRE(found[j] == table.find(keys[j]));
+            REQUIRE((found[j] == table.end()) ==
+                    (reference.find(keys[j]) == reference.end() &&
+                     std::none_of(data.begin(), data.begin() + 64,
+                                  [&](auto& kv) {
+                                      return kv.first == keys[j];
+                                  })));
+        }
+
+        const Table empty;
+        std::vector<typename Table::const_iterator> none(keys.size());
+        empty.find_batch(keys.data(), keys.data() + keys.size(),
+                         none.data());
+        REQUIRE(std::all_of(none.begin(), none.end(),
+                            [&](auto it) { return it == empty.end(); }));
+    };
+    check(loatable<int, int, plt::fmix_hash>{},
+          loatable<int, int, plt::fmix_hash>{});
+    check(loatable<int, int>{}, loatable<int, int>{});
+}
+
+TEST_CASE("LOA - memory_usage counts the arrays", "[loa]")
+{
+    loatable<int, int> table;
+    REQUIRE(table.memory_usage() == sizeof(table));
+    for (int i = 0; i < 1000; ++i) {
+        table.insert(i, i);
+    }
+    const size_t asize = table.capacity();
+    // one byte of flags per slot
+    const size_t arrays = asize * (1 + sizeof(int) + sizeof(int));
+    REQUIRE(table.memory_usage() >= sizeof(table) + arrays);
+    // allocator slack is a few words per array
+    REQUIRE(table.memory_usage() <= sizeof(table) + arrays + 256);
+
+    const size_t before = table.memory_usage();
+    table.reserve(4 * asize);
+    REQUIRE(table.memory_usage() > 3 * (before - sizeof(table)));
+    table.clear();
+    REQUIRE(table.memory_usage() == sizeof(table));
+}
@@ -139,10 +139,59 @@ Ensure(LOATable, can_insert_and_lookup_keys)
     loadestroy(t);
 }
 
+Ensure(LOATable, keeps_keys_across_doubling_resizes)
+{
+    loatable* t = loacreate();
+    loaresult res;
+    const int N = 10000;
+    int i;
+
+    for (i = 0; i < N; ++i) {
+        res = loainsert(t, i * 31);
+        assert_that(res.result, is_equal_to(LOA_INSERTED));
+        *loaval(t, res.iter) = i;
+        if (i % 5 == 0)
+            loaerase(t, i * 31);
+    }
+    assert_that(t->asize, is_greater_than(N));
+    for (i = 0; i < N; ++i) {
+        loaiter it = loafind(t, i * 31);
+        if (i % 5 == 0) {
+            assert_that(it, is_equal_to(loaend(t)));
+        } else {
+            assert_that(it, is_not_equal_to(loaend(t)));
+            assert_that(*loaval(t, it), is_equal_to(i));
+        }
+    }
+
+    loadestroy(t);
+}
+
+Ensure(LOATable, reports_memory_usage_of_caller_owned_table)
+{
+    loatable t;
+    int i;
+
+    loainit(&t);
+    assert_that(loamemoryusage(&t), is_equal_to(sizeof(loatable)));
+
+    for (i = 0; i < 100; ++i)
+        assert_that(loainsert(&t, i).result, is_equal_to(LOA_INSERTED));
+    assert_that(loamemoryusage(&t),
+                is_greater_than(sizeof(loatable) +
+                                t.asize * (sizeof(key_t) + sizeof(val_t))));
+
+    loaclear(&t);
+}
+
 TestSuite *loatable_tests()
 {
     TestSuite *suite = create_test_suite();
     add_test_with_context(suite, LOATable, can_set_and_check_flags);
     add_test_with_context(suite, LOATable, can_insert_and_lookup_keys);
+    add_test_with_context(suite, LOATable,
+                          keeps_keys_across_doubling_resizes);
+    add_test_with_context(suite, LOATable,
+                          reports_memory_usage_of_caller_owned_table);
     return suite;
 }
@@ -0,0 +1,135 @@
+#include <catch2/catch.hpp>
+#include <cstdlib>
+#include <cstring>
+#include <pltables++/placement_table.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <vector>
+
+using PlacementTable = placement_table<int, int>;
+
+TEST_CASE("Placement - region is formatted in place", "[placement]")
+{
+    const size_t bytes = PlacementTable::required_bytes(1000);
+    std::vector<uint64_t> region(bytes / sizeof(uint64_t) + 1);
+    PlacementTable table{ region.data(), bytes };
+    REQUIRE(table.valid());
+    REQUIRE(table.empty());
+    REQUIRE(table.capacity() * 0.77 > 1000);
+
+    for (int i = 0; i < 1000; ++i) {
+        auto res = table.insert(i, i * 2);
+        REQUIRE(res.second == PlacementTable::InsertResult::Inserted);
+    }
+    REQUIRE(table.insert(5, 0).second == PlacementTable::InsertResult::Present);
+    REQUIRE(table.size() == 1000u);
+    for (int i = 0; i < 1000; ++i) {
+        REQUIRE(table.find(i).value() == i * 2);
+    }
+    REQUIRE(!table.contains(1000));
+}
+
+TEST_CASE("Placement - too small a region is rejected")
+{
+    char region[64];
+    PlacementTable table{ region, sizeof(region) };
+    REQUIRE(!table.valid());
+    REQUIRE(table.insert_failed(table.insert(1, 1).second));
+}
+
+TEST_CASE("Placement - full table reports an error instead of growing")
+{
+    const size_t bytes = PlacementTable::required_bytes(10);
+    std::vector<uint64_t> region(bytes / sizeof(uint64_t));
+    PlacementTable table{ region.data(), bytes };
+    int i = 0;
+    while (!table.insert_failed(table.insert(i, i).second)) {
+        ++i;
+    }
+    REQUIRE(size_t(i) < table.capacity());
+    REQUIRE(table.size() == size_t(i));
+    // lookups of missing keys still terminate
+    REQUIRE(!table.contains(-1));
+    // a tombstone can be reused even when full
+    REQUIRE(table.erase(0) == 1u);
+    REQUIRE(table.insert(0, 5).second ==
+            PlacementTable::InsertResult::ReusedSlot);
+}
+
+TEST_CASE("Placement - erased keys behind tombstones are not duplicated")
+{
+    const size_t bytes = PlacementTable::required_bytes(64);
+    std::vector<uint64_t> region(bytes / sizeof(uint64_t));
+    PlacementTable table{ region.data(), bytes };
+    const int cap = int(table.capacity());
+    // keys that share a home slot under the identity hash
+    table.insert(1, 1);
+    table.insert(1 + cap, 2);
+    table.insert(1 + 2 * cap, 3);
+    table.erase(1);
+    REQUIRE(table.insert(1 + 2 * cap, 9).second ==
+            PlacementTable::InsertResult::Present);
+    REQUIRE(table.size() == 2u);
+    REQUIRE(table.find(1 + 2 * cap).value() == 3);
+}
+
+TEST_CASE("Placement - table is readable at another address")
+{
+    const size_t bytes = PlacementTable::required_bytes(5000);
+    std::vector<uint64_t> a(bytes / sizeof(uint64_t) + 1);
+    std::vector<uint64_t> b(a.size());
+    PlacementTable writer{ a.data(), bytes };
+    for (int i = 0; i < 5000; ++i) {
+        writer.insert(i * 3, -i);
+    }
+    writer.erase(0);
+
+    REQUIRE(!PlacementTable::attach(a.data(), bytes).valid()); // unpublished
+    writer.publish();
+    memcpy(b.data(), a.data(), bytes);
+
+    auto reader = PlacementTable::attach(b.data(), bytes);
+    REQUIRE(reader.valid());
+    REQUIRE(reader.size() == 4999u);
+    REQUIRE(!reader.contains(0));
+    for (int i = 1; i < 5000; ++i) {
+        REQUIRE(reader.find(i * 3).value() == -i);
+    }
+    size_t n = 0;
+    for (auto it = reader.begin(); it != reader.end(); ++it) {
+        REQUIRE(it.key() % 3 == 0);
+        ++n;
+    }
+    REQUIRE(n == 4999u);
+
+    REQUIRE(!(placement_table<int, long>::attach(b.data(), bytes).valid()));
+    REQUIRE(!PlacementTable::attach(b.data(), bytes / 2).valid());
+}
+
+TEST_CASE("Placement - shared mapping at two addresses")
+{
+    const size_t bytes = PlacementTable::required_bytes(1000);
+    void* w = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    REQUIRE(w != MAP_FAILED);
+    // a second view of the same pages at a different address
+    void* r = mremap(w, 0, bytes, MREMAP_MAYMOVE);
+    REQUIRE(r != MAP_FAILED);
+    REQUIRE(r != w);
+
+    PlacementTable writer{ w, bytes };
+    for (int i = 0; i < 1000; ++i) {
+        writer.insert(i, i + 1);
+    }
+    writer.publish();
+    auto reader = PlacementTable::attach(r, bytes);
+    REQUIRE(reader.valid());
+    for (int i = 0; i < 1000; ++i) {
+        REQUIRE(reader.find(i).value() == i + 1);
+    }
+    writer.find(7).value() = 70;
+    REQUIRE(reader.find(7).value() == 70);
+
+    munmap(r, bytes);
+    munmap(w, bytes);
+}
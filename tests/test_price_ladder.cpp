@@ -0,0 +1,148 @@
+#include <catch2/catch.hpp>
+#include <map>
+#include <pltables++/price_ladder.h>
+#include <random>
+
+using Ladder = price_ladder<int64_t>;
+
+TEST_CASE("Price ladder - best bid and ask", "[price_ladder]")
+{
+    Ladder bids(Ladder::Side::Bid, 100, 256);
+    Ladder asks(Ladder::Side::Ask, 100, 256);
+    REQUIRE(bids.window() == 256u);
+    REQUIRE(bids.empty());
+    for (int64_t p : { 10000, 9900, 9700, 10100 }) {
+        auto r = bids.insert(p);
+        REQUIRE(r.second);
+        *r.first = p / 100;
+        asks.insert(p + 1000).first[0] = p / 100;
+    }
+    REQUIRE(bids.size() == 4u);
+    REQUIRE(bids.best() == 10100);
+    REQUIRE(bids.best_level() == 101);
+    REQUIRE(asks.best() == 10700);
+    REQUIRE(!bids.insert(9900).second);
+    REQUIRE(*bids.find(9700) == 97);
+    REQUIRE(bids.find(9800) == nullptr);
+    REQUIRE(bids.erase(10100) == 1u);
+    REQUIRE(bids.best() == 10000);
+    REQUIRE(bids.erase(10000) == 1u);
+    REQUIRE(bids.best() == 9900);
+    REQUIRE(asks.erase(10700) == 1u);
+    REQUIRE(asks.best() == 10900);
+    REQUIRE(bids.erase(10000) == 0u);
+}
+
+TEST_CASE("Price ladder - far prices spill and come back", "[price_ladder]")
+{
+    Ladder bids(Ladder::Side::Bid, 1, 64);
+    bids.insert(1000);
+    // The window spans 64 ticks with 1000 a quarter in from the top.
+    for (int64_t p = 1000; p > 1000 - 200; p -= 10) {
+        *bids.insert(p).first = p;
+    }
+    REQUIRE(bids.spilled() > 0u);
+    REQUIRE(bids.best() == 1000);
+    // A better bid outside the window recenters on it.
+    *bids.insert(1500).first = 1500;
+    REQUIRE(bids.best() == 1500);
+    REQUIRE(bids.in_window() == 1u);
+    for (int64_t p = 1000; p > 1000 - 200; p -= 10) {
+        REQUIRE(*bids.find(p) == p);
+    }
+    // Emptying the window recenters on the best spilled level.
+    bids.erase(1500);
+    REQUIRE(bids.best() == 1000);
+    REQUIRE(bids.in_window() > 1u);
+    REQUIRE(bids.size() == 20u);
+}
+
+// Fails every allocation once `budget` is used up (negative: unlimited).
+struct BudgetAllocator
+{
+    static inline long budget = -1;
+    static void* allocate(size_t nmemb, size_t size) noexcept
+    {
+        if (budget == 0)
+            return nullptr;
+        if (budget > 0)
+            --budget;
+        return calloc(nmemb, size);
+    }
+    static void deallocate(void* ptr, size_t, size_t) noexcept { free(ptr); }
+};
+
+TEST_CASE("Price ladder - a failed recenter leaves the ladder intact",
+          "[price_ladder]")
+{
+    using Budgeted =
+      price_ladder<int64_t, int64_t, std::hash<int64_t>, BudgetAllocator>;
+    BudgetAllocator::budget = -1;
+    Budgeted bids(Budgeted::Side::Bid, 1, 64);
+    for (int64_t p = 960; p <= 1000; ++p) {
+        *bids.insert(p).first = p;
+    }
+    // Two far levels give the spill table a few free slots, not enough
+    // for the 41 levels a recenter on 1100 pushes out.
+    *bids.insert(100).first = 100;
+    *bids.insert(200).first = 200;
+    REQUIRE(bids.in_window() == 41u);
+    REQUIRE(bids.spilled() == 2u);
+
+    BudgetAllocator::budget = 0;
+    auto r = bids.insert(1100);
+    REQUIRE(r.first == nullptr);
+    REQUIRE(!r.second);
+    REQUIRE(bids.size() == 43u);
+    REQUIRE(bids.in_window() == 41u);
+    REQUIRE(bids.spilled() == 2u);
+    REQUIRE(bids.best() == 1000);
+    REQUIRE(bids.find(1100) == nullptr);
+    for (int64_t p : { int64_t(100), int64_t(200) }) {
+        REQUIRE(*bids.find(p) == p);
+    }
+    for (int64_t p = 960; p <= 1000; ++p) {
+        REQUIRE(*bids.find(p) == p);
+    }
+
+    BudgetAllocator::budget = -1;
+    *bids.insert(1100).first = 1100;
+    REQUIRE(bids.best() == 1100);
+    REQUIRE(bids.size() == 44u);
+    for (int64_t p = 960; p <= 1000; ++p) {
+        REQUIRE(*bids.find(p) == p);
+    }
+}
+
+TEST_CASE("Price ladder - random walk matches std::map", "[price_ladder]")
+{
+    for (auto side : { Ladder::Side::Bid, Ladder::Side::Ask }) {
+        Ladder ladder(side, 5, 128);
+        std::map<int64_t, int64_t> reference;
+        std::mt19937 gen(43);
+        std::geometric_distribution<int> depth(0.1);
+        int64_t mid = 100000;
+        for (int step = 0; step < 50000; ++step) {
+            if (gen() % 10 == 0)
+                mid += gen() % 2 ? 5 * int64_t(gen() % 40) : -5 * int64_t(gen() % 40);
+            const int64_t away = 5 * int64_t(1 + depth(gen));
+            const int64_t p = side == Ladder::Side::Bid ? mid - away : mid + away;
+            if (gen() % 2) {
+                *ladder.insert(p).first = p;
+                reference[p] = p;
+            } else {
+                REQUIRE(ladder.erase(p) == reference.erase(p));
+            }
+            REQUIRE(ladder.size() == reference.size());
+            if (!reference.empty()) {
+                const int64_t best = side == Ladder::Side::Bid
+                                       ? reference.rbegin()->first
+                                       : reference.begin()->first;
+                REQUIRE(ladder.best() == best);
+            }
+        }
+        for (const auto& kv : reference) {
+            REQUIRE(*ladder.find(kv.first) == kv.second);
+        }
+    }
+}
@@ -6,6 +6,14 @@ QOA_INIT_INT(i32, int, qoa_i32_hash_identity);
 
 QOA_INIT_STR(str, double, qoa_str_hash_X31);
 
+/* every key on one probe path */
+static inline int collide_hash(int key)
+{
+    (void)key;
+    return 0;
+}
+QOA_INIT_INT(collide, int, collide_hash);
+
 Describe(QOATable);
 BeforeEach(QOATable)
 {
@@ -230,11 +238,98 @@ Ensure(QOATable, can_insert_strings_and_lookup)
     qoa_destroy2(str, t, free_string_keys);
 }
 
+Ensure(QOATable, batch_calls_match_single_key_calls)
+{
+    enum { N = 1000 };
+    qoatable_t(i32) *t = qoa_create(i32);
+    qoatable_t(i32) *ref = qoa_create(i32);
+    int keys[N];
+    qoaresult res[N];
+    qoaiter iters[N];
+
+    /* lookups in an unallocated table */
+    qoa_get_batch(i32, t, keys, 0, iters);
+    for (int i = 0; i < N; ++i)
+        keys[i] = (i * 7919) % 600 - 100; /* duplicates */
+    qoa_get_batch(i32, t, keys, N, iters);
+    assert_that(iters[0], is_equal_to(qoa_end(i32, t)));
+
+    assert_that(qoa_insert_batch(i32, t, keys, N, res), is_equal_to(0));
+    for (int i = 0; i < N; ++i) {
+        qoaresult r = qoa_insert(i32, ref, keys[i]);
+        assert_that(res[i].result, is_equal_to(r.result));
+        assert_that(res[i].iter, is_equal_to(r.iter));
+    }
+    assert_that(qoa_size(i32, t), is_equal_to(600));
+
+    for (int i = 0; i < N; i += 5)
+        qoa_erase(i32, t, keys[i]);
+    for (int i = 0; i < N; ++i)
+        keys[i] = i - 200;
+    qoa_get_batch(i32, t, keys, N, iters);
+    for (int i = 0; i < N; ++i)
+        assert_that(iters[i], is_equal_to(qoa_get(i32, t, keys[i])));
+
+    qoa_destroy(i32, ref);
+    qoa_destroy(i32, t);
+}
+
+Ensure(QOATable, reinsert_does_not_duplicate_key_past_deleted_slot)
+{
+    qoatable_t(collide) *t = qoa_create(collide);
+    qoaresult res;
+    qoaiter iter;
+
+    assert_that(qoa_insert(collide, t, 1).result, is_equal_to(QOA_NEW));
+    assert_that(qoa_insert(collide, t, 2).result, is_equal_to(QOA_NEW));
+    assert_that(qoa_erase(collide, t, 1), is_equal_to(1));
+
+    res = qoa_insert(collide, t, 2);
+    assert_that(res.result, is_equal_to(QOA_PRESENT));
+    assert_that(qoa_size(collide, t), is_equal_to(1));
+
+    res = qoa_insert(collide, t, 1);
+    assert_that(res.result, is_equal_to(QOA_DELETED));
+    assert_that(qoa_size(collide, t), is_equal_to(2));
+
+    assert_that(qoa_erase(collide, t, 2), is_equal_to(1));
+    assert_that(qoa_get(collide, t, 2), is_equal_to(qoa_end(collide, t)));
+    assert_that(qoa_size(collide, t), is_equal_to(1));
+    iter = qoa_get(collide, t, 1);
+    assert_that(iter, is_not_equal_to(qoa_end(collide, t)));
+    assert_that(*qoa_key(collide, t, iter), is_equal_to(1));
+
+    qoa_destroy(collide, t);
+}
+
+Ensure(QOATable, reports_memory_usage_of_caller_owned_table)
+{
+    qoatable_t(i32) t;
+    int i;
+
+    qoa_init(i32, &t);
+    assert_that(qoa_memory_usage(i32, &t), is_equal_to(sizeof(t)));
+
+    for (i = 0; i < 100; ++i)
+        assert_that(qoa_insert(i32, &t, i).result, is_equal_to(QOA_NEW));
+    assert_that(qoa_memory_usage(i32, &t),
+                is_greater_than(sizeof(t) + t.size * (sizeof(int) * 2)));
+
+    free(t.flags);
+    free(t.keys);
+    free(t.vals);
+}
+
 TestSuite *qoatable_tests()
 {
     TestSuite *suite = create_test_suite();
     add_test_with_context(suite, QOATable, can_create_table_and_insert_values);
     add_test_with_context(suite, QOATable, can_lookup_inserted_values);
     add_test_with_context(suite, QOATable, can_insert_strings_and_lookup);
+    add_test_with_context(suite, QOATable, batch_calls_match_single_key_calls);
+    add_test_with_context(suite, QOATable,
+                          reinsert_does_not_duplicate_key_past_deleted_slot);
+    add_test_with_context(suite, QOATable,
+                          reports_memory_usage_of_caller_owned_table);
     return suite;
 }
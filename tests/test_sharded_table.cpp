@@ -0,0 +1,96 @@
+#include <catch2/catch.hpp>
+#include <pltables++/sharded_table.h>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+TEST_CASE("Sharded - shard count rounds up to power of 2", "[sharded]")
+{
+    sharded_loatable<int, int> table(3);
+    REQUIRE(table.shard_count() == 4u);
+    REQUIRE(table.size() == 0u);
+    REQUIRE(table.empty() == true);
+
+    sharded_loatable<int, int> single(1);
+    REQUIRE(single.shard_count() == 1u);
+    REQUIRE(single.shard_for(42) == 0u);
+}
+
+TEST_CASE("Sharded - insert, find and erase route to owning shard")
+{
+    using Table = sharded_loatable<int, int>;
+    Table table(8);
+    std::unordered_map<int, int> t2;
+
+    constexpr int N = 4096;
+    for (int i = 0; i < N; ++i) {
+        auto result = table.insert(i, i + 1);
+        REQUIRE(result.second == Table::InsertResult::Inserted);
+        t2.emplace(i, i + 1);
+    }
+    REQUIRE(table.size() == t2.size());
+
+    size_t nonempty = 0;
+    for (size_t s = 0; s < table.shard_count(); ++s) {
+        nonempty += !table.shard(s).empty();
+        for (auto it = table.shard(s).begin(); it != table.shard(s).end();
+             ++it) {
+            REQUIRE(table.shard_for(it.key()) == s);
+        }
+    }
+    REQUIRE(nonempty == table.shard_count());
+
+    for (int i = 0; i < N; ++i) {
+        auto& shard = table.shard_of(i);
+        auto it = shard.find(i);
+        REQUIRE(it != shard.end());
+        REQUIRE(it.value() == i + 1);
+    }
+
+    for (int i = 0; i < N; i += 2) {
+        REQUIRE(table.erase(i) == 1u);
+    }
+    for (int i = 0; i < N; ++i) {
+        REQUIRE(table.contains(i) == (i % 2 != 0));
+    }
+    REQUIRE(table.size() == size_t(N / 2));
+}
+
+TEST_CASE("Sharded - attach migrates entries to new placement")
+{
+    using Table = sharded_loatable<int, int>;
+    Table table(4);
+    // large enough that the shard arrays are mapped rather than calloc'd
+    constexpr int N = 1 << 17;
+    for (int i = 0; i < N; ++i) {
+        table.insert(i, 2 * i);
+    }
+    const size_t before = table.size();
+
+    std::vector<std::thread> workers;
+    std::vector<char> attached(table.shard_count(), 0);
+    for (size_t s = 0; s < table.shard_count(); ++s) {
+        workers.emplace_back(
+          [&table, &attached, s]() { attached[s] = table.attach(s); });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    for (char ok : attached) {
+        REQUIRE(ok);
+    }
+
+    REQUIRE(table.size() == before);
+    for (size_t s = 0; s < table.shard_count(); ++s) {
+        REQUIRE(table.shard_node(s) >= 0);
+    }
+    for (int i = 0; i < N; ++i) {
+        auto& shard = table.shard_of(i);
+        auto it = shard.find(i);
+        REQUIRE(it != shard.end());
+        REQUIRE(it.value() == 2 * i);
+    }
+
+    REQUIRE(table.attach(0, 0));
+    REQUIRE(table.shard_node(0) == 0);
+}
@@ -0,0 +1,112 @@
+#include <catch2/catch.hpp>
+#include <pltables++/small_table.h>
+#include <random>
+#include <string>
+#include <unordered_map>
+
+TEMPLATE_TEST_CASE("Small LOA - inline scan finds every key", "[small_loa]",
+                   int8_t, uint16_t, int32_t, uint64_t)
+{
+    small_loatable<TestType, int, 16> map;
+    REQUIRE(map.is_inline());
+    REQUIRE(map.empty());
+    for (int i = 0; i < 16; ++i) {
+        auto r = map.insert(TestType(3 * i + 1), i);
+        REQUIRE(r.second == decltype(map)::InsertResult::Inserted);
+        REQUIRE(map.size() == size_t(i + 1));
+        for (int j = 0; j <= i; ++j) {
+            REQUIRE(map.find(TestType(3 * j + 1)).value() == j);
+        }
+        for (int j = 0; j < 16; ++j) {
+            REQUIRE(!map.contains(TestType(3 * j + 2)));
+        }
+    }
+    REQUIRE(map.is_inline());
+    REQUIRE(map.insert(TestType(4), 99).second ==
+            decltype(map)::InsertResult::Present);
+    REQUIRE(map.find(TestType(4)).value() == 1);
+}
+
+TEST_CASE("Small LOA - spills to a hashed table past N", "[small_loa]")
+{
+    small_loatable<int, int, 8> map;
+    for (int i = 0; i < 8; ++i) {
+        map.insert(i * 100, i);
+    }
+    REQUIRE(map.is_inline());
+    REQUIRE(map.capacity() == 8u);
+    auto r = map.insert(800, 8);
+    REQUIRE(r.second == decltype(map)::InsertResult::Inserted);
+    REQUIRE(r.first.value() == 8);
+    REQUIRE(!map.is_inline());
+    REQUIRE(map.size() == 9u);
+    for (int i = 0; i < 200; ++i) {
+        map.insert(i * 100, i);
+    }
+    REQUIRE(map.size() == 200u);
+    for (int i = 0; i < 200; ++i) {
+        REQUIRE(map.find(i * 100).value() == i);
+    }
+    size_t n = 0;
+    for (auto it = map.begin(); it != map.end(); ++it) {
+        REQUIRE(it.key() == it.value() * 100);
+        ++n;
+    }
+    REQUIRE(n == 200u);
+    map.clear();
+    REQUIRE(map.is_inline());
+    REQUIRE(map.empty());
+    REQUIRE(map.find(100) == map.end());
+}
+
+TEST_CASE("Small LOA - erase keeps inline entries dense", "[small_loa]")
+{
+    small_loatable<uint64_t, int> map;
+    std::unordered_map<uint64_t, int> reference;
+    std::mt19937_64 gen(9);
+    std::uniform_int_distribution<uint64_t> dist(0, 24);
+    for (int step = 0; step < 5000; ++step) {
+        const uint64_t k = dist(gen) << 40;
+        if (step % 2 == 0) {
+            REQUIRE(map.erase(k) == reference.erase(k));
+        } else {
+            map.insert(k, step);
+            reference.emplace(k, step);
+        }
+        REQUIRE(map.size() == reference.size());
+    }
+    for (const auto& kv : reference) {
+        REQUIRE(map.find(kv.first).value() == kv.second);
+    }
+}
+
+TEST_CASE("Small LOA - non-trivial keys use KeyEq", "[small_loa]")
+{
+    small_loatable<std::string, std::string, 4> map;
+    map.insert("bid", "1.00");
+    map.insert("ask", "1.01");
+    REQUIRE(map.find("ask").value() == "1.01");
+    REQUIRE(map.erase("bid") == 1u);
+    REQUIRE(!map.contains("bid"));
+    for (int i = 0; i < 10; ++i) {
+        map.insert(std::to_string(i), std::to_string(i * i));
+    }
+    REQUIRE(!map.is_inline());
+    REQUIRE(map.find("ask").value() == "1.01");
+    REQUIRE(map.find("7").value() == "49");
+}
+
+TEST_CASE("Small LOA - memory_usage is the object until it spills",
+          "[small_loa]")
+{
+    small_loatable<int, int, 4> map;
+    for (int i = 0; i < 4; ++i) {
+        map.insert(i, i);
+    }
+    REQUIRE(map.memory_usage() == sizeof(map));
+    map.insert(4, 4);
+    REQUIRE(!map.is_inline());
+    REQUIRE(map.memory_usage() > sizeof(map) + map.capacity() * 8);
+    map.clear();
+    REQUIRE(map.memory_usage() == sizeof(map));
+}
@@ -0,0 +1,160 @@
+#include <catch2/catch.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <pltables++/linear_open_address.h>
+#include <string>
+#include <unistd.h>
+
+namespace {
+
+std::string tempPath(const char* name)
+{
+    const char* dir = getenv("TMPDIR");
+    return std::string(dir ? dir : "/tmp") + "/plt_" + name + "_" +
+           std::to_string(getpid()) + ".snap";
+}
+
+struct SeededHash
+{
+    size_t s = 0;
+    size_t seed() const noexcept { return s; }
+    size_t operator()(int k) const noexcept
+    {
+        return (size_t(unsigned(k)) ^ s) * 0x9E3779B97F4A7C15ull >> 7;
+    }
+};
+
+} // namespace
+
+TEST_CASE("Snapshot - round trip through a read-only mapping", "[snapshot]")
+{
+    const auto path = tempPath("ro");
+    loatable<int, int> table;
+    for (int i = 0; i < 10000; ++i) {
+        table.insert(i * 7, i);
+    }
+    for (int i = 0; i < 10000; i += 3) {
+        table.erase(i * 7);
+    }
+    REQUIRE(table.save(path.c_str()));
+
+    loatable<int, int> loaded;
+    REQUIRE(loaded.load_mmap(path.c_str()));
+    REQUIRE(loaded.is_mapped());
+    REQUIRE(loaded.size() == table.size());
+    REQUIRE(loaded.capacity() == table.capacity());
+    for (int i = 0; i < 10000; ++i) {
+        auto it = loaded.find(i * 7);
+        if (i % 3 == 0) {
+            REQUIRE(it == loaded.end());
+        } else {
+            REQUIRE(it != loaded.end());
+            REQUIRE(it.value() == i);
+        }
+    }
+    size_t n = 0;
+    for (auto it = loaded.cbegin(); it != loaded.cend(); ++it) {
+        ++n;
+    }
+    REQUIRE(n == table.size());
+    loaded.clear();
+    REQUIRE(!loaded.is_mapped());
+    unlink(path.c_str());
+}
+
+TEST_CASE("Snapshot - copy-on-write mapping accepts updates")
+{
+    const auto path = tempPath("cow");
+    loatable<int, int> table;
+    for (int i = 0; i < 1000; ++i) {
+        table.insert(i, i);
+    }
+    REQUIRE(table.save(path.c_str()));
+
+    loatable<int, int> loaded;
+    REQUIRE(loaded.load_mmap(path.c_str(), plt::SnapshotMode::CopyOnWrite));
+    REQUIRE(loaded.erase(5) == 1u);
+    loaded.find(6).value() = -6;
+    for (int i = 1000; i < 5000; ++i) {
+        loaded.insert(i, i);
+    }
+    REQUIRE(!loaded.is_mapped()); // grown out of the mapping
+    REQUIRE(loaded.find(5) == loaded.end());
+    REQUIRE(loaded.find(6).value() == -6);
+    REQUIRE(loaded.find(4999).value() == 4999);
+
+    // the file itself is untouched
+    loatable<int, int> again;
+    REQUIRE(again.load_mmap(path.c_str()));
+    REQUIRE(again.size() == 1000u);
+    REQUIRE(again.find(5).value() == 5);
+    REQUIRE(again.find(6).value() == 6);
+    unlink(path.c_str());
+}
+
+TEST_CASE("Snapshot - different hash seed forces a rehash")
+{
+    const auto path = tempPath("seed");
+    loatable<int, int, SeededHash> table{};
+    for (int i = 0; i < 5000; ++i) {
+        table.insert(i, -i);
+    }
+    REQUIRE(table.save(path.c_str()));
+
+    loatable<int, int, SeededHash> same;
+    REQUIRE(same.load_mmap(path.c_str()));
+    REQUIRE(same.is_mapped());
+
+    struct Reseeded : SeededHash
+    {
+        Reseeded() noexcept { s = 12345; }
+    };
+    loatable<int, int, Reseeded> other;
+    REQUIRE(other.load_mmap(path.c_str()));
+    REQUIRE(!other.is_mapped());
+    REQUIRE(other.size() == 5000u);
+    for (int i = 0; i < 5000; ++i) {
+        REQUIRE(other.find(i).value() == -i);
+    }
+    unlink(path.c_str());
+}
+
+TEST_CASE("Snapshot - mismatched or damaged files are rejected")
+{
+    const auto path = tempPath("bad");
+    loatable<int, int> table;
+    for (int i = 0; i < 100; ++i) {
+        table.insert(i, i);
+    }
+    REQUIRE(table.save(path.c_str()));
+
+    loatable<int, long> wide;
+    REQUIRE(!wide.load_mmap(path.c_str()));
+    REQUIRE(wide.empty());
+
+    loatable<int, int> missing;
+    REQUIRE(!missing.load_mmap((path + ".missing").c_str()));
+
+    FILE* f = fopen(path.c_str(), "r+b");
+    REQUIRE(f != nullptr);
+    fputc('X', f);
+    fclose(f);
+    loatable<int, int> corrupt;
+    corrupt.insert(1, 1);
+    REQUIRE(!corrupt.load_mmap(path.c_str()));
+    REQUIRE(corrupt.size() == 1u); // left as it was
+    unlink(path.c_str());
+}
+
+TEST_CASE("Snapshot - empty table")
+{
+    const auto path = tempPath("empty");
+    loatable<int, int> table;
+    REQUIRE(table.save(path.c_str()));
+    loatable<int, int> loaded;
+    loaded.insert(1, 1);
+    REQUIRE(loaded.load_mmap(path.c_str()));
+    REQUIRE(loaded.empty());
+    REQUIRE(loaded.capacity() == 0u);
+    unlink(path.c_str());
+}
@@ -0,0 +1,89 @@
+#include <catch2/catch.hpp>
+#include <pltables++/linear_open_address.h>
+#include <unordered_map>
+#include <random>
+
+using SmallTable = static_loatable<int, int, 64>;
+
+TEST_CASE("Static LOA - capacity is fixed and inline", "[static_loa]")
+{
+    SmallTable table;
+    REQUIRE(table.capacity() == 64u);
+    REQUIRE(table.empty());
+    REQUIRE(sizeof(table) > 64 * 2 * sizeof(int));
+    REQUIRE(table.reserve(49));
+    REQUIRE(!table.reserve(50));
+    REQUIRE(!table.resize(128));
+    REQUIRE(table.capacity() == 64u);
+}
+
+TEST_CASE("Static LOA - insert reports Error when full", "[static_loa]")
+{
+    using R = SmallTable::InsertResult;
+    SmallTable table;
+    int n = 0;
+    for (;; ++n) {
+        auto r = table.insert(n, n * 3);
+        if (table.insert_failed(r.second)) {
+            REQUIRE(r.first == table.end());
+            break;
+        }
+        REQUIRE(r.second == R::Inserted);
+    }
+    REQUIRE(n == 49);
+    REQUIRE(table.size() == 49u);
+    REQUIRE(table.capacity() == 64u);
+    // Keys already present are still found when the table is full.
+    auto r = table.insert(7, 0);
+    REQUIRE(r.second == R::Present);
+    REQUIRE(r.first.value() == 21);
+    for (int i = 0; i < n; ++i) {
+        REQUIRE(table.find(i).value() == i * 3);
+    }
+    REQUIRE(table.find(n) == table.end());
+}
+
+TEST_CASE("Static LOA - erase frees room for new keys", "[static_loa]")
+{
+    SmallTable table;
+    std::unordered_map<int, int> reference;
+    std::mt19937 gen(3);
+    std::uniform_int_distribution<int> dist(0, 200);
+    for (int step = 0; step < 20000; ++step) {
+        int k = dist(gen);
+        if (step % 3 == 0 || reference.size() >= 40) {
+            REQUIRE(table.erase(k) == reference.erase(k));
+        } else {
+            auto r = table.insert(k, step);
+            REQUIRE(!table.insert_failed(r.second));
+            reference.emplace(k, step);
+        }
+        REQUIRE(table.size() == reference.size());
+    }
+    for (const auto& kv : reference) {
+        REQUIRE(table.find(kv.first) != table.end());
+        REQUIRE(table.find(kv.first).value() == kv.second);
+    }
+    size_t seen = 0;
+    for (auto it = table.begin(); it != table.end(); ++it) {
+        REQUIRE(reference.count(it.key()) == 1u);
+        ++seen;
+    }
+    REQUIRE(seen == reference.size());
+}
+
+TEST_CASE("Static LOA - clear keeps the inline arrays", "[static_loa]")
+{
+    SmallTable table;
+    for (int i = 0; i < 30; ++i) {
+        table.insert(i, i);
+    }
+    table.clear();
+    REQUIRE(table.empty());
+    REQUIRE(table.capacity() == 64u);
+    REQUIRE(table.find(3) == table.end());
+    for (int i = 0; i < 49; ++i) {
+        REQUIRE(!table.insert_failed(table.insert(i, -i).second));
+    }
+    REQUIRE(table.find(48).value() == -48);
+}
@@ -0,0 +1,29 @@
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <pltables++/thread_pool.h>
+#include <vector>
+
+TEST_CASE("ThreadPool - parallel_for visits every index once", "[pool]")
+{
+    for (size_t nthreads : { 0, 1, 2, 5 }) {
+        plt::ThreadPool pool{ nthreads };
+        REQUIRE(pool.size() == (nthreads != 0 ? nthreads : 1));
+        for (size_t n : { 0, 1, 7, 1000 }) {
+            std::vector<std::atomic<int>> hits(n);
+            pool.parallel_for(n, [&](size_t i) { ++hits[i]; });
+            for (auto& h : hits) {
+                REQUIRE(h == 1);
+            }
+        }
+    }
+}
+
+TEST_CASE("ThreadPool - pool is reusable across many jobs")
+{
+    plt::ThreadPool pool{ 4 };
+    std::atomic<size_t> sum{ 0 };
+    for (int job = 0; job < 200; ++job) {
+        pool.parallel_for(16, [&](size_t i) { sum += i; });
+    }
+    REQUIRE(sum == 200u * (15u * 16u / 2u));
+}
@@ -0,0 +1,116 @@
+#include <catch2/catch.hpp>
+#include <pltables++/window_table.h>
+#include <deque>
+#include <random>
+#include <string>
+#include <unordered_map>
+
+TEST_CASE("Window LOA - window size and empty state", "[window_loa]")
+{
+    window_loatable<uint64_t, int> map(1000);
+    REQUIRE(map.valid());
+    REQUIRE(map.window() == 1024u);
+    REQUIRE(map.empty());
+    REQUIRE(map.begin() == map.end());
+    REQUIRE(map.find(5) == map.end());
+    REQUIRE(map.erase(5) == 0u);
+}
+
+struct FailingAllocator
+{
+    static void* allocate(size_t, size_t) noexcept { return nullptr; }
+    static void deallocate(void*, size_t, size_t) noexcept {}
+};
+
+TEST_CASE("Window LOA - a map without a ring stays empty", "[window_loa]")
+{
+    window_loatable<uint64_t, int, std::hash<uint64_t>,
+                    std::equal_to<uint64_t>, FailingAllocator>
+      map(1000);
+    REQUIRE(!map.valid());
+    REQUIRE(map.window() == 0u);
+    REQUIRE(map.begin() == map.end());
+    REQUIRE(map.find(0) == map.end());
+    REQUIRE(!map.contains(0));
+    REQUIRE(map.erase(0) == 0u);
+    REQUIRE(decltype(map)::insert_failed(map.insert(0, 1).second));
+    REQUIRE(map.empty());
+}
+
+TEST_CASE("Window LOA - short-lived orders never spill", "[window_loa]")
+{
+    window_loatable<uint64_t, uint64_t> map(256);
+    for (uint64_t id = 1; id < 100000; ++id) {
+        auto r = map.insert(id, id * 2);
+        REQUIRE(r.second == decltype(map)::InsertResult::Inserted);
+        REQUIRE(r.first.key() == id);
+        if (id > 100) {
+            REQUIRE(map.erase(id - 100) == 1u);
+        }
+    }
+    REQUIRE(map.size() == 100u);
+    REQUIRE(map.spilled() == 0u);
+    REQUIRE(map.window_base() > 99000u);
+    for (uint64_t id = 99900; id < 100000; ++id) {
+        REQUIRE(map.find(id).value() == id * 2);
+    }
+    REQUIRE(map.insert(99999, 0).second ==
+            decltype(map)::InsertResult::Present);
+}
+
+TEST_CASE("Window LOA - survivors spill and stay reachable", "[window_loa]")
+{
+    window_loatable<int64_t, std::string> map(64);
+    for (int64_t id = -50; id < 1000; ++id) {
+        map.insert(id, std::to_string(id));
+        // Every 10th order lives forever; the rest die after 20 IDs.
+        if (id - 20 >= -50 && (id - 20) % 10 != 0) {
+            REQUIRE(map.erase(id - 20) == 1u);
+        }
+    }
+    REQUIRE(map.spilled() > 0u);
+    REQUIRE(map.in_window() + map.spilled() == map.size());
+    for (int64_t id = -50; id < 980; ++id) {
+        const bool live = id % 10 == 0;
+        REQUIRE(map.contains(id) == live);
+        if (live) {
+            REQUIRE(map.find(id).value() == std::to_string(id));
+        }
+    }
+    // Late inserts below the window go straight to the spill table.
+    REQUIRE(map.insert(-49, "late").second ==
+            decltype(map)::InsertResult::Inserted);
+    REQUIRE(map.find(-49).value() == "late");
+    REQUIRE(map.erase(-40) == 1u);
+    REQUIRE(!map.contains(-40));
+}
+
+TEST_CASE("Window LOA - random lifetimes match unordered_map", "[window_loa]")
+{
+    window_loatable<uint32_t, uint32_t> map(128);
+    std::unordered_map<uint32_t, uint32_t> reference;
+    std::deque<uint32_t> live;
+    std::mt19937 gen(41);
+    std::uniform_int_distribution<int> coin(0, 99);
+    uint32_t next = 7;
+    for (int step = 0; step < 50000; ++step) {
+        // Occasional large gaps in the ID stream.
+        next += coin(gen) == 0 ? 500 : 1;
+        map.insert(next, step);
+        reference.emplace(next, step);
+        live.push_back(next);
+        while (live.size() > 50 || (!live.empty() && coin(gen) < 40)) {
+            // Mostly oldest-first, sometimes a random survivor.
+            size_t i = coin(gen) < 90 ? 0 : size_t(coin(gen)) % live.size();
+            REQUIRE(map.erase(live[i]) == reference.erase(live[i]));
+            live.erase(live.begin() + i);
+        }
+        REQUIRE(map.size() == reference.size());
+    }
+    size_t n = 0;
+    for (auto it = map.begin(); it != map.end(); ++it) {
+        REQUIRE(reference.at(it.key()) == it.value());
+        ++n;
+    }
+    REQUIRE(n == reference.size());
+}